@@ -32,6 +32,7 @@ set( CMAKE_C_COMPILER "${MILI_COMPILER_PREFIX}/nvc" CACHE PATH "" )
 set( CMAKE_Fortran_COMPILER "${MILI_COMPILER_PREFIX}/nvfortran" CACHE PATH "" )
 
 set( ENABLE_MILI TRUE CACHE BOOL "Turn on/off building of Mili Library" )
+set( ENABLE_MILI_READER TRUE CACHE BOOL "Turn on/off building of the read-only Mili Library" )
 set( ENABLE_TAURUS TRUE CACHE BOOL "Turn on/off building of Taurus Library" )
 set( ENABLE_EPRINTF TRUE CACHE BOOL "Turn on/off building of Extended printf Library" )
 set( ENABLE_XMILICS TRUE CACHE BOOL "Turn on/off building of Xmilics" )
@@ -20,6 +20,7 @@ if( DEFINED ENV{FC} OR DEFINED FC  )
 endif()
 
 set( ENABLE_MILI TRUE CACHE BOOL "Turn on/off building of Mili Library" )
+set( ENABLE_MILI_READER TRUE CACHE BOOL "Turn on/off building of the read-only Mili Library" )
 set( ENABLE_TAURUS TRUE CACHE BOOL "Turn on/off building of Taurus Library" )
 set( ENABLE_EPRINTF TRUE CACHE BOOL "Turn on/off building of Extended printf Library" )
 set( ENABLE_XMILICS TRUE CACHE BOOL "Turn on/off building of Xmilics" )
@@ -17,6 +17,7 @@ set( CMAKE_Fortran_COMPILER "<PLACEHOLDER>" CACHE PATH "Path to Fortran compiler
 
 # Below are Flags to specify what libraries and executables are built
 set( ENABLE_MILI TRUE CACHE BOOL "Turn on/off building of Mili Library" )
+set( ENABLE_MILI_READER TRUE CACHE BOOL "Turn on/off building of the read-only Mili Library" )
 set( ENABLE_TAURUS TRUE CACHE BOOL "Turn on/off building of Taurus Library" )
 set( ENABLE_EPRINTF TRUE CACHE BOOL "Turn on/off building of Extended printf Library" )
 set( ENABLE_XMILICS TRUE CACHE BOOL "Turn on/off building of Xmilics" )
@@ -40,7 +40,11 @@
 #include <fcntl.h>
 #include "mili_internal.h"
 
+/* Minimum number of entries or names a directory grows by. */
+#define DIR_ALLOC_UNITS (64)
+
 static Bool_type valid_dir_entry_data(Dir_entry_type, int, char **);
+static FILE *open_dir_file(Mili_family *fam, int index, char *fname);
 
 /*
  ************************************************************************
@@ -82,23 +86,86 @@ static Bool_type valid_dir_entry_data(Dir_entry_type etype, int string_qty, char
 }
 
 /*****************************************************************
- * TAG( add_dir_entry ) PRIVATE
+ * TAG( reserve_dir_space ) PRIVATE
  *
- * Add an entry into the directory.
+ * Ensure a File_dir has room for more entries and names.  Arrays
+ * grow geometrically so that adding entries one at a time remains
+ * linear in the size of the directory.
  */
-Return_value add_dir_entry(Mili_family *fam, Dir_entry_type etype, int modifier1, int modifier2, int string_qty,
-                           char **strings, LONGLONG offset, LONGLONG length)
+Return_value reserve_dir_space(File_dir *p_fd, int entry_qty, int name_qty)
+{
+    int capacity;
+
+    if ( p_fd->qty_entries + entry_qty > p_fd->entry_capacity )
+    {
+        capacity = 2 * p_fd->entry_capacity;
+        if ( capacity < p_fd->qty_entries + entry_qty )
+        {
+            capacity = p_fd->qty_entries + entry_qty;
+        }
+        if ( capacity < DIR_ALLOC_UNITS )
+        {
+            capacity = DIR_ALLOC_UNITS;
+        }
+        p_fd->dir_entries = RENEW_N(Dir_entry, p_fd->dir_entries, p_fd->entry_capacity,
+                                    capacity - p_fd->entry_capacity, "Addl file dir entries");
+        if ( p_fd->dir_entries == NULL )
+        {
+            p_fd->entry_capacity = 0;
+            return ALLOC_FAILED;
+        }
+        p_fd->entry_capacity = capacity;
+    }
+
+    if ( p_fd->qty_names + name_qty > p_fd->name_capacity )
+    {
+        capacity = 2 * p_fd->name_capacity;
+        if ( capacity < p_fd->qty_names + name_qty )
+        {
+            capacity = p_fd->qty_names + name_qty;
+        }
+        if ( capacity < DIR_ALLOC_UNITS )
+        {
+            capacity = DIR_ALLOC_UNITS;
+        }
+        p_fd->names = RENEW_N(char *, p_fd->names, p_fd->name_capacity, capacity - p_fd->name_capacity,
+                              "Addl name ptrs");
+        if ( p_fd->names == NULL )
+        {
+            p_fd->name_capacity = 0;
+            return ALLOC_FAILED;
+        }
+        p_fd->name_capacity = capacity;
+    }
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( add_dir_entries ) PRIVATE
+ *
+ * Add a set of entries into the directory.  The strings of all the
+ * entries are passed in entry order in a single list.
+ */
+Return_value add_dir_entries(Mili_family *fam, int qty, Dir_entry *entries, char **strings)
 {
     LONGLONG *entry;
     File_dir *p_fd;
-    int qty_ent, qty_nam;
-    int i;
+    int qty_nam, string_qty;
+    int i, j;
     int len;
+    Return_value rval;
 
     /* Check the input data before doing anything. */
-    if ( !valid_dir_entry_data(etype, string_qty, strings) )
+    string_qty = 0;
+    for ( i = 0; i < qty; i++ )
     {
-        return INVALID_DIR_ENTRY_DATA;
+        if ( !valid_dir_entry_data((Dir_entry_type)entries[i][TYPE_IDX], (int)entries[i][STRING_QTY_IDX],
+                                   strings + string_qty) )
+        {
+            return INVALID_DIR_ENTRY_DATA;
+        }
+        string_qty += (int)entries[i][STRING_QTY_IDX];
     }
 
     /*
@@ -108,62 +175,68 @@ Return_value add_dir_entry(Mili_family *fam, Dir_entry_type etype, int modifier1
 
     p_fd = fam->directory + fam->file_count - 1;
 
-    /* Grow the array of Dir_entry's for the current non-state file. */
+    /* Grow the arrays of Dir_entry's and names for the current non-state file. */
 
-    qty_ent = p_fd->qty_entries;
-    qty_nam = p_fd->qty_names;
-
-    p_fd->dir_entries = RENEW_N(Dir_entry, p_fd->dir_entries, qty_ent, 1, "Addl file dir entry");
-    if ( p_fd->dir_entries == NULL )
+    rval = reserve_dir_space(p_fd, qty, string_qty);
+    if ( rval != OK )
     {
-        return ALLOC_FAILED;
+        return rval;
     }
 
-    if ( string_qty > 0 )
+    if ( string_qty > 0 && p_fd->name_data == NULL )
     {
-        p_fd->names = RENEW_N(char *, p_fd->names, qty_nam, string_qty, "Addl name ptr");
-        if ( p_fd->names == NULL )
+        p_fd->name_data = ios_create(M_STRING);
+        if ( p_fd->name_data == NULL )
         {
-            return ALLOC_FAILED;
+            return IOS_ALLOC_FAILED;
         }
     }
 
-    entry = p_fd->dir_entries[qty_ent];
-    p_fd->qty_entries++;
-    p_fd->qty_names += string_qty;
-
-    /* Load the new Dir_entry. */
-    entry[TYPE_IDX] = etype;
-    entry[MODIFIER1_IDX] = modifier1;
-    entry[MODIFIER2_IDX] = modifier2;
-    entry[STRING_QTY_IDX] = string_qty;
-    entry[OFFSET_IDX] = offset;
-    entry[LENGTH_IDX] = length;
-
-    if ( string_qty > 0 )
+    /* Load the new Dir_entry's. */
+    for ( i = 0; i < qty; i++ )
     {
-        if ( p_fd->name_data == NULL )
+        entry = p_fd->dir_entries[p_fd->qty_entries];
+        for ( j = 0; j < QTY_ENTRY_FIELDS; j++ )
         {
-            p_fd->name_data = ios_create(M_STRING);
-            if ( p_fd->name_data == NULL )
-            {
-                return IOS_ALLOC_FAILED;
-            }
+            entry[j] = entries[i][j];
         }
+        p_fd->qty_entries++;
+    }
 
-        for ( i = 0; i < string_qty; i++ )
+    qty_nam = p_fd->qty_names;
+    for ( i = 0; i < string_qty; i++ )
+    {
+        len = ios_str_dup(p_fd->names + qty_nam + i, strings[i], p_fd->name_data);
+        if ( len == 0 )
         {
-            len = ios_str_dup(p_fd->names + qty_nam + i, strings[i], p_fd->name_data);
-            if ( len == 0 )
-            {
-                return IOS_STR_DUP_FAILED;
-            }
+            return IOS_STR_DUP_FAILED;
         }
+        p_fd->qty_names++;
     }
 
     return OK;
 }
 
+/*****************************************************************
+ * TAG( add_dir_entry ) PRIVATE
+ *
+ * Add an entry into the directory.
+ */
+Return_value add_dir_entry(Mili_family *fam, Dir_entry_type etype, int modifier1, int modifier2, int string_qty,
+                           char **strings, LONGLONG offset, LONGLONG length)
+{
+    Dir_entry entry;
+
+    entry[TYPE_IDX] = etype;
+    entry[MODIFIER1_IDX] = modifier1;
+    entry[MODIFIER2_IDX] = modifier2;
+    entry[STRING_QTY_IDX] = string_qty;
+    entry[OFFSET_IDX] = offset;
+    entry[LENGTH_IDX] = length;
+
+    return add_dir_entries(fam, 1, &entry, strings);
+}
+
 /*****************************************************************
  * TAG( commit_dir ) PRIVATE
  *
@@ -302,6 +375,59 @@ void delete_dir(Mili_family *fam)
     fam->directory = NULL;
 }
 
+/*****************************************************************
+ * TAG( open_dir_file ) LOCAL
+ *
+ * Open a non-state file to read its directory, or the copy of the
+ * directory in the family's open-time index if there is one.
+ */
+static FILE *open_dir_file(Mili_family *fam, int index, char *fname)
+{
+    if ( fam->open_index != NULL )
+    {
+        return open_index_dir_stream(fam->open_index, index);
+    }
+
+    return fopen(fname, "rb");
+}
+
+/*****************************************************************
+ * TAG( index_ti_param ) LOCAL
+ *
+ * Record a deferred TI parameter directory entry in the family's
+ * name index, so a lookup finds its entries without scanning the
+ * directories.
+ */
+static Return_value index_ti_param(Mili_family *fam, int fidx, int entry_idx, char *p_name)
+{
+    Param_ref *ppr;
+    Return_value rval;
+
+    if ( fam->ti_param_index == NULL )
+    {
+        fam->ti_param_index = htable_create(DEFAULT_HASH_TABLE_SIZE);
+        if ( fam->ti_param_index == NULL || fam->ti_param_index->table == NULL )
+        {
+            return ALLOC_FAILED;
+        }
+    }
+
+    ppr = NEW(Param_ref, "TI param index entry");
+    if ( ppr == NULL )
+    {
+        return ALLOC_FAILED;
+    }
+    ppr->file_index = fidx;
+    ppr->entry_index = entry_idx;
+    rval = htable_add_entry_data(fam->ti_param_index, p_name, ENTER_ALWAYS, ppr);
+    if ( rval != OK )
+    {
+        free(ppr);
+    }
+
+    return rval;
+}
+
 /*****************************************************************
  * TAG( load_directories ) PRIVATE
  *
@@ -401,7 +527,7 @@ Return_value load_directories(Mili_family *fam)
     fcnt = 0;
     make_fnam(NON_STATE_DATA, fam, fcnt, fname);
 
-    while ( (p_f = fopen(fname, "rb")) != NULL && (!active || fcnt <= fnum) )
+    while ( (p_f = open_dir_file(fam, fcnt, fname)) != NULL && (!active || fcnt <= fnum) )
     {
         fam->cur_file = p_f;
         offset = 0;
@@ -549,6 +675,8 @@ Return_value load_directories(Mili_family *fam)
         p_fd->commit_count = header[COMMIT_COUNT_IDX];
         p_fd->qty_entries = qty_ent;
         p_fd->qty_names = qty_nam;
+        p_fd->entry_capacity = qty_ent;
+        p_fd->name_capacity = qty_nam;
         p_fd->names = NEW_N(char *, qty_nam, "File_dir entry names");
         if ( qty_nam > 0 && p_fd->names == NULL )
         {
@@ -659,6 +787,28 @@ Return_value load_directories(Mili_family *fam)
                     {
                         return NOT_OK;
                     }
+
+                    /*
+                     * Readers enter TI parameters on the first lookup that
+                     * may need them; see load_ti_param().
+                     */
+                    if ( etype == TI_PARAM && fam->access_mode == 'r' )
+                    {
+                        rval = index_ti_param(fam, fcnt, i, p_name);
+                        if ( rval != OK )
+                        {
+                            free(pioms);
+                            free(p_fd->names);
+                            free(fam->directory);
+                            fam->directory = NULL;
+                            free(p_de);
+                            fclose(p_f);
+                            return rval;
+                        }
+                        fam->ti_params_deferred = TRUE;
+                        continue;
+                    }
+
                     /* Create an entry in the param table. */
                     ppr = NEW(Param_ref, "Param table entry - string");
                     if ( ppr == NULL )
@@ -703,3 +853,183 @@ Return_value load_directories(Mili_family *fam)
     }
     return OK;
 }
+
+/*****************************************************************
+ * TAG( enter_ti_param ) LOCAL
+ *
+ * Enter one deferred TI parameter directory entry into the param
+ * table unless an earlier lookup of its name already entered it.
+ */
+static Return_value enter_ti_param(Mili_family *fam, int fidx, int entry_idx, char *p_name)
+{
+    Htable_entry *phte;
+    Param_ref *ppr;
+    Return_value rval;
+
+    htable_search(fam->param_table, p_name, FIND_ENTRY, &phte);
+    for ( ; phte != NULL; phte = phte->next )
+    {
+        ppr = (Param_ref *)phte->data;
+        if ( strcmp(phte->key, p_name) == 0 && ppr->file_index == fidx && ppr->entry_index == entry_idx )
+        {
+            return OK;
+        }
+    }
+
+    ppr = NEW(Param_ref, "Param table entry - string");
+    if ( ppr == NULL )
+    {
+        return ALLOC_FAILED;
+    }
+    ppr->file_index = fidx;
+    ppr->entry_index = entry_idx;
+    rval = htable_add_entry_data(fam->param_table, p_name, ENTER_ALWAYS, ppr);
+    if ( rval != OK )
+    {
+        free(ppr);
+    }
+
+    return rval;
+}
+
+/*****************************************************************
+ * TAG( load_ti_param ) PRIVATE
+ *
+ * Enter the deferred TI parameter entries with a given name into
+ * the param table, so a lookup of one TI parameter does not force
+ * loading all of them.  Sets "found" if any entry has the name; a
+ * name with no entry leaves the rest deferred.
+ */
+Return_value load_ti_param(Mili_family *fam, char *name, Bool_type *found)
+{
+    Htable_entry *phte, *first;
+    Param_ref *ppr;
+    int qty, k;
+    Return_value rval;
+
+    *found = FALSE;
+
+    if ( !fam->ti_params_deferred || fam->ti_param_index == NULL )
+    {
+        return OK;
+    }
+
+    htable_search(fam->ti_param_index, name, FIND_ENTRY, &first);
+
+    /* Entries of one name are chained newest first. */
+    qty = 0;
+    for ( phte = first; phte != NULL; phte = phte->next )
+    {
+        if ( strcmp(phte->key, name) == 0 )
+        {
+            qty++;
+        }
+    }
+
+    /* Enter them in directory order, as load_ti_params() would. */
+    for ( ; qty > 0; qty-- )
+    {
+        k = 0;
+        for ( phte = first; phte != NULL; phte = phte->next )
+        {
+            if ( strcmp(phte->key, name) == 0 && ++k == qty )
+            {
+                break;
+            }
+        }
+
+        ppr = (Param_ref *)phte->data;
+        rval = enter_ti_param(fam, ppr->file_index, ppr->entry_index, name);
+        if ( rval != OK )
+        {
+            return rval;
+        }
+        *found = TRUE;
+    }
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( load_ti_params ) PRIVATE
+ *
+ * Enter all TI parameters of a family opened for reading into its
+ * parameter table.  Large TI parameter sets (labels, element sets)
+ * are not needed to open a family, so load_directories() and
+ * open_family() leave them until the first lookup that may need
+ * them.  For old families with separate TI files, this loads the
+ * TI directories.
+ */
+Return_value load_ti_params(Mili_family *fam)
+{
+    int fidx, i;
+    int nnames;
+    File_dir *p_fd;
+    Return_value rval;
+
+    if ( !fam->ti_params_deferred )
+    {
+        return OK;
+    }
+    fam->ti_params_deferred = FALSE;
+
+    /* Lookups are answered by the param table from here on. */
+    if ( fam->ti_param_index != NULL )
+    {
+        htable_delete(fam->ti_param_index, NULL, TRUE);
+        fam->ti_param_index = NULL;
+    }
+
+    if ( fam->char_header[DIR_VERSION_IDX] == 1 )
+    {
+        rval = load_ti_directories(fam);
+        if ( fam->ti_file_count == 0 || rval != OK )
+        {
+            fam->ti_enable = FALSE; /* TI data not found */
+        }
+        return OK;
+    }
+
+    for ( fidx = 0; fidx < fam->file_count; fidx++ )
+    {
+        p_fd = fam->directory + fidx;
+        nnames = 0;
+
+        for ( i = 0; i < p_fd->qty_entries; i++ )
+        {
+            nnames += p_fd->dir_entries[i][STRING_QTY_IDX];
+            if ( p_fd->dir_entries[i][TYPE_IDX] != TI_PARAM || p_fd->dir_entries[i][STRING_QTY_IDX] < 1 )
+            {
+                continue;
+            }
+
+            rval = enter_ti_param(fam, fidx, i, p_fd->names[nnames - 1]);
+            if ( rval != OK )
+            {
+                return rval;
+            }
+        }
+    }
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( ti_param_htable ) PRIVATE
+ *
+ * Return the table holding a family's TI parameters, loading them
+ * first if that was deferred at open.
+ */
+Hash_table *ti_param_htable(Mili_family *fam)
+{
+    load_ti_params(fam);
+
+    if ( fam->char_header[DIR_VERSION_IDX] > 1 )
+    {
+        return fam->param_table;
+    }
+    else
+    {
+        return fam->ti_param_table;
+    }
+}
@@ -134,6 +134,39 @@ main(int argc, char *argv[])
 
 #endif
 
+/*****************************************************************
+ * TAG( grow_buffer_list ) LOCAL
+ *
+ * Ensure a store's buffer list has a slot for buffer "index",
+ * doubling the list so that adding buffers stays linear.
+ */
+static Return_value grow_buffer_list(IO_mem_store *pioms, LONGLONG index)
+{
+    LONGLONG capacity;
+
+    if ( index < pioms->buffer_capacity )
+    {
+        return OK;
+    }
+
+    capacity = 2 * pioms->buffer_capacity;
+    if ( capacity < index + 1 )
+    {
+        capacity = index + 1;
+    }
+
+    pioms->data_buffers = RENEW_N(IO_mem_buffer *, pioms->data_buffers, pioms->buffer_capacity,
+                                  capacity - pioms->buffer_capacity, "Grow IO data buffer list");
+    if ( pioms->data_buffers == NULL )
+    {
+        pioms->buffer_capacity = 0;
+        return ALLOC_FAILED;
+    }
+    pioms->buffer_capacity = capacity;
+
+    return OK;
+}
+
 /*****************************************************************
  * TAG( ios_create ) PRIVATE
  *
@@ -155,6 +188,7 @@ IO_mem_store *ios_create(int datatype)
         free(pioms);
         return NULL;
     }
+    pioms->buffer_capacity = 1;
     piomb = NEW(IO_mem_buffer, "IO mem buffer");
     if ( piomb == NULL )
     {
@@ -226,8 +260,7 @@ Return_value ios_input(Mili_family *fam, int datatype, LONGLONG qty_units, IO_me
 
     index = ++pioms->current_index;
 
-    pioms->data_buffers = RENEW_N(IO_mem_buffer *, pioms->data_buffers, index, 1, "Load IO buffer list");
-    if ( pioms->data_buffers == NULL )
+    if ( grow_buffer_list(pioms, index) != OK )
     {
         return ALLOC_FAILED;
     }
@@ -307,8 +340,7 @@ Return_value ti_ios_input(Mili_family *fam, int datatype, LONGLONG qty_units, IO
 
     index = ++pioms->current_index;
 
-    pioms->data_buffers = RENEW_N(IO_mem_buffer *, pioms->data_buffers, index, 1, "Load IO buffer list");
-    if ( pioms->data_buffers == NULL )
+    if ( grow_buffer_list(pioms, index) != OK )
     {
         return ALLOC_FAILED;
     }
@@ -386,14 +418,7 @@ void ios_destroy(IO_mem_store *pioms)
     for ( i = 0; i < pioms->current_index + 1; i++ )
     {
         piomb = pioms->data_buffers[i];
-        if ( piomb->invalid != NULL )
-        {
-            Int_range *blist;
-
-            blist = piomb->invalid->blocks;
-            DELETE_LIST(blist);
-            free(piomb->invalid);
-        }
+        delete_block_list(piomb->invalid);
         free(piomb->data);
         free(piomb);
     }
@@ -437,9 +462,7 @@ void *ios_alloc(LONGLONG qty, IO_mem_store *pioms)
             new_size += ALLOC_UNITS;
         }
 
-        pioms->data_buffers =
-            RENEW_N(IO_mem_buffer *, pioms->data_buffers, pioms->current_index + 1, 1, "Grow IO data buffer list");
-        if ( pioms->data_buffers == NULL )
+        if ( grow_buffer_list(pioms, pioms->current_index + 1) != OK )
         {
             /* Uh oh; punt. */
             return NULL;
@@ -707,7 +730,7 @@ Return_value ios_output(Mili_family *fam, FILE *ofile, IO_mem_store *pioms, int
         }
         else
         {
-            Int_range *pir;
+            Int_range *pir, *pir_bound;
 
             /*
              * Development note - If we assume an I/O buffer will only
@@ -723,7 +746,8 @@ Return_value ios_output(Mili_family *fam, FILE *ofile, IO_mem_store *pioms, int
 
             /* Write fresh data segments preceding each invalid range. */
             start_unit = piomb->output;
-            for ( pir = piomb->invalid->blocks; pir != NULL; pir = pir->next )
+            pir_bound = piomb->invalid->blocks + piomb->invalid->block_qty;
+            for ( pir = piomb->invalid->blocks; pir < pir_bound; pir++ )
             {
                 if ( (LONGLONG)pir->start > start_unit )
                 {
@@ -0,0 +1,332 @@
+/*
+ Copyright (c) 2016, Lawrence Livermore National Security, LLC.
+ Produced at the Lawrence Livermore National Laboratory. Written
+ by Kevin Durrenberger: durrenberger1@llnl.gov. CODE-OCEC-16-056.
+ All rights reserved.
+
+ This file is part of Mili. For details, see <URL describing code
+ and how to download source>.
+
+ Please also read this link-- Our Notice and GNU Lesser General
+ Public License.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License (as published by
+ the Free Software Foundation) version 2.1 dated February 1999.
+
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the IMPLIED WARRANTY OF
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the terms
+ and conditions of the GNU General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+ * Runtime I/O statistics.  A family keeps counts of its state data
+ * I/O and latency histograms of its main entry points while
+ * statistics are enabled, either with mc_set_io_stats() or for every
+ * family by setting MILI_IO_STATS in the environment (which also
+ * times mc_open()).  Disabled families pay one pointer test per
+ * counted operation.
+ */
+
+#if !defined(_POSIX_C_SOURCE) && defined(__linux__)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "mili_internal.h"
+#include "parson.h"
+
+/*****************************************************************
+ * TAG( fam_list )
+ *
+ * Dynamically allocated array of pointers to all currently open
+ * MILI families.
+ */
+extern Mili_family **fam_list;
+
+#ifndef MILI_READER
+static char *timed_func_names[M_STAT_FUNC_QTY] = {"mc_open", "mc_read_results", "mc_new_state", "mc_end_state",
+                                                  "mc_flush"};
+
+static void latency_to_json(JSON_Object *p_obj, Io_latency *p_lat);
+#endif
+
+/*****************************************************************
+ * TAG( io_stats_now ) PRIVATE
+ *
+ * Monotonic wall clock time in seconds.
+ */
+double io_stats_now(void)
+{
+    struct timespec ts;
+
+#ifdef _MSC_VER
+    timespec_get(&ts, TIME_UTC);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1.0e-9;
+}
+
+/*****************************************************************
+ * TAG( io_stats_enable ) PRIVATE
+ *
+ * Start (or restart) collecting statistics for a family.
+ */
+Return_value io_stats_enable(Mili_family *fam)
+{
+    if ( fam->io_stats == NULL )
+    {
+        fam->io_stats = NEW(Io_stats, "Family I/O statistics");
+        if ( fam->io_stats == NULL )
+        {
+            return ALLOC_FAILED;
+        }
+    }
+    else
+    {
+        memset(fam->io_stats, 0, sizeof(Io_stats));
+    }
+    fam->io_stats_start = io_stats_now();
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( io_stats_free ) PRIVATE
+ *
+ * Stop collecting statistics for a family.
+ */
+void io_stats_free(Mili_family *fam)
+{
+    if ( fam->io_stats != NULL )
+    {
+        free(fam->io_stats);
+        fam->io_stats = NULL;
+    }
+}
+
+/*****************************************************************
+ * TAG( io_stats_clock ) PRIVATE
+ *
+ * Start time for a timed function, or zero if the family isn't
+ * collecting statistics.
+ */
+double io_stats_clock(Famid fam_id)
+{
+    if ( validate_fam_id(fam_id) != OK || fam_list[fam_id]->io_stats == NULL )
+    {
+        return 0.0;
+    }
+
+    return io_stats_now();
+}
+
+/*****************************************************************
+ * TAG( io_stats_time ) PRIVATE
+ *
+ * Record a call of a timed function started at "start".
+ */
+void io_stats_time(Famid fam_id, int func, double start)
+{
+    Io_latency *p_lat;
+    double elapsed, limit;
+    int bucket;
+
+    if ( start == 0.0 || validate_fam_id(fam_id) != OK || fam_list[fam_id]->io_stats == NULL )
+    {
+        return;
+    }
+
+    elapsed = io_stats_now() - start;
+    p_lat = fam_list[fam_id]->io_stats->latency + func;
+
+    p_lat->calls++;
+    p_lat->total_time += elapsed;
+    if ( elapsed > p_lat->max_time )
+    {
+        p_lat->max_time = elapsed;
+    }
+
+    /* Bucket i holds calls under 2^i microseconds. */
+    limit = 1.0e-6;
+    for ( bucket = 0; bucket < M_STAT_BUCKETS - 1 && elapsed >= limit; bucket++ )
+    {
+        limit *= 2.0;
+    }
+    p_lat->buckets[bucket]++;
+}
+
+/*****************************************************************
+ * TAG( mc_set_io_stats ) PUBLIC
+ *
+ * Turn collection of I/O statistics for a family on or off.  Turning
+ * it on clears any statistics already collected.
+ */
+Return_value mc_set_io_stats(Famid fam_id, Bool_type on)
+{
+    Return_value rval;
+
+    rval = validate_fam_id(fam_id);
+    if ( rval != OK )
+    {
+        return rval;
+    }
+
+    if ( on )
+    {
+        return io_stats_enable(fam_list[fam_id]);
+    }
+
+    io_stats_free(fam_list[fam_id]);
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( mc_reset_io_stats ) PUBLIC
+ *
+ * Clear the I/O statistics of a family.
+ */
+Return_value mc_reset_io_stats(Famid fam_id)
+{
+    Return_value rval;
+
+    rval = validate_fam_id(fam_id);
+    if ( rval != OK )
+    {
+        return rval;
+    }
+
+    if ( fam_list[fam_id]->io_stats == NULL )
+    {
+        return NOT_APPLICABLE;
+    }
+
+    return io_stats_enable(fam_list[fam_id]);
+}
+
+/*****************************************************************
+ * TAG( mc_get_io_stats ) PUBLIC
+ *
+ * Copy out the I/O statistics of a family.
+ */
+Return_value mc_get_io_stats(Famid fam_id, Io_stats *p_stats)
+{
+    Mili_family *fam;
+    Return_value rval;
+
+    rval = validate_fam_id(fam_id);
+    if ( rval != OK )
+    {
+        return rval;
+    }
+    fam = fam_list[fam_id];
+
+    if ( fam->io_stats == NULL )
+    {
+        return NOT_APPLICABLE;
+    }
+
+    *p_stats = *fam->io_stats;
+    p_stats->wall_time = io_stats_now() - fam->io_stats_start;
+
+    return OK;
+}
+
+/*
+ * The JSON report needs parson, which the reader library leaves out;
+ * readers use mc_get_io_stats() instead.
+ */
+#ifndef MILI_READER
+/*****************************************************************
+ * TAG( latency_to_json ) LOCAL
+ *
+ * Add one function's latency to a JSON object.
+ */
+static void latency_to_json(JSON_Object *p_obj, Io_latency *p_lat)
+{
+    JSON_Value *p_buckets;
+    JSON_Array *p_arr;
+    int i, last;
+
+    json_object_set_number(p_obj, "calls", (double)p_lat->calls);
+    json_object_set_number(p_obj, "total_time", p_lat->total_time);
+    json_object_set_number(p_obj, "max_time", p_lat->max_time);
+
+    /* Trailing empty buckets are left out. */
+    for ( last = M_STAT_BUCKETS - 1; last >= 0 && p_lat->buckets[last] == 0; last-- )
+        ;
+
+    p_buckets = json_value_init_array();
+    p_arr = json_value_get_array(p_buckets);
+    for ( i = 0; i <= last; i++ )
+    {
+        json_array_append_number(p_arr, (double)p_lat->buckets[i]);
+    }
+    json_object_set_value(p_obj, "log2_usec_buckets", p_buckets);
+}
+
+/*****************************************************************
+ * TAG( mc_io_stats_json ) PUBLIC
+ *
+ * Return the I/O statistics of a family as a JSON string, which the
+ * caller must free().
+ */
+Return_value mc_io_stats_json(Famid fam_id, char **p_json)
+{
+    Io_stats stats;
+    JSON_Value *p_root, *p_value;
+    JSON_Object *p_obj, *p_funcs;
+    Return_value rval;
+    int i;
+
+    *p_json = NULL;
+
+    rval = mc_get_io_stats(fam_id, &stats);
+    if ( rval != OK )
+    {
+        return rval;
+    }
+
+    p_root = json_value_init_object();
+    if ( p_root == NULL )
+    {
+        return ALLOC_FAILED;
+    }
+    p_obj = json_value_get_object(p_root);
+
+    json_object_set_number(p_obj, "read_calls", (double)stats.read_calls);
+    json_object_set_number(p_obj, "read_bytes", (double)stats.read_bytes);
+    json_object_set_number(p_obj, "write_calls", (double)stats.write_calls);
+    json_object_set_number(p_obj, "write_bytes", (double)stats.write_bytes);
+    json_object_set_number(p_obj, "seeks", (double)stats.seeks);
+    json_object_set_number(p_obj, "file_opens", (double)stats.file_opens);
+    json_object_set_number(p_obj, "file_closes", (double)stats.file_closes);
+    json_object_set_number(p_obj, "pool_hits", (double)stats.pool_hits);
+    json_object_set_number(p_obj, "pool_misses", (double)stats.pool_misses);
+    json_object_set_number(p_obj, "fsyncs", (double)stats.fsyncs);
+    json_object_set_number(p_obj, "wall_time", stats.wall_time);
+
+    json_object_set_value(p_obj, "latency", json_value_init_object());
+    p_funcs = json_object_get_object(p_obj, "latency");
+    for ( i = 0; i < M_STAT_FUNC_QTY; i++ )
+    {
+        p_value = json_value_init_object();
+        latency_to_json(json_value_get_object(p_value), stats.latency + i);
+        json_object_set_value(p_funcs, timed_func_names[i], p_value);
+    }
+
+    *p_json = json_serialize_to_string_pretty(p_root);
+    json_value_free(p_root);
+
+    return (*p_json == NULL) ? ALLOC_FAILED : OK;
+}
+#endif
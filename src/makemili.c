@@ -44,6 +44,11 @@ File generator formated files for VisIt use.
 #define AVT_UNKNOWN_TYPE 7
 #define AVT_NODECENT 0
 #define AVT_ZONECENT 1
+// The pretty-printed end of a .mili file whose last member is States,
+// following the times array.
+#define STATES_TAIL "\n        ],\n        \"count\": %d\n    }\n}"
+// Time array entries as parson prints them (FLOAT_FORMAT).
+#define STATES_TIME ",\n            %.8g"
 // These are the families that are open at the moment.
 extern Mili_family **fam_list;
 
@@ -86,7 +91,8 @@ int elementSetCount;
 int numProcessors;
 int xmilicsFile = 0;
 int subrecord_count = 0;
-char *subrec_string = NULL;
+
+static void note_states_end(Mili_family *fam, char *serialized_string);
 
 int mc_activate_visit_file(Famid database_id, int on)
 {
@@ -115,14 +121,11 @@ int mc_activate_visit_file(Famid database_id, int on)
 static void writeVariable_json(char *var_elem, Variable *variable, JSON_Object *root_object)
 {
     char variable_string[2048];
-    char components[1024];
-    char number[10];
-    char *numbers = NULL;
+    JSON_Value *list_value;
+    JSON_Array *list;
     int i;
     State_variable *sv;
     variable_string[0] = '\0';
-    components[0] = '\0';
-    number[0] = '\0';
 
     sv = variable->state_var;
     if ( var_elem == NULL || sv == NULL )
@@ -157,22 +160,16 @@ static void writeVariable_json(char *var_elem, Variable *variable, JSON_Object *
     }
     if ( variable->realNameCount > 0 )
     {
-        components[0] = '\0';
         sprintf(variable_string, "%s.%s", var_elem, "real_names");
-        sprintf(components, "%s", "[");
+        list_value = json_value_init_array();
+        list = json_value_get_array(list_value);
         for ( i = 0; i < variable->realNameCount; i++ )
         {
-            sprintf(components, "%s\"%s\"", components, variable->realNames[i]);
-            if ( i < variable->realNameCount - 1 )
-            {
-                strcat(components, ",");
-            }
+            json_array_append_string(list, variable->realNames[i]);
         }
-        strcat(components, "]");
-        json_object_dotset_value(root_object, variable_string, json_parse_string(components));
+        json_object_dotset_value(root_object, variable_string, list_value);
     }
 
-    components[0] = '\0';
     sprintf(variable_string, "%s.%s", var_elem, "rank");
     json_object_dotset_number(root_object, variable_string, sv->rank);
     sprintf(variable_string, "%s.%s", var_elem, "Center");
@@ -184,77 +181,40 @@ static void writeVariable_json(char *var_elem, Variable *variable, JSON_Object *
         case VECTOR:
         case VEC_ARRAY:
             sprintf(variable_string, "%s.%s", var_elem, "vector_components");
-            sprintf(components, "%s", "[");
+            list_value = json_value_init_array();
+            list = json_value_get_array(list_value);
             for ( i = 0; i < sv->vec_size; i++ )
             {
-                strcat(components, "\"");
-                strcat(components, sv->components[i]);
-                strcat(components, "\"");
-
-                if ( i < sv->vec_size - 1 )
-                {
-                    strcat(components, ",");
-                }
+                json_array_append_string(list, sv->components[i]);
             }
-            strcat(components, "]");
-            json_object_dotset_value(root_object, variable_string, json_parse_string(components));
+            json_object_dotset_value(root_object, variable_string, list_value);
             break;
 
         case ARRAY:
-
-            numbers = NEW_N(char, sv->rank * 10, "Numbers");
-            numbers[0] = '\0';
             sprintf(variable_string, "%s.%s", var_elem, "dimensions");
-
-            strcat(numbers, "[");
+            list_value = json_value_init_array();
+            list = json_value_get_array(list_value);
             for ( i = 0; i < sv->rank; i++ )
             {
-                sprintf(number, "%d", sv->dims[i]);
-                strcat(numbers, number);
-                if ( i < sv->rank - 1 )
-                {
-                    strcat(numbers, ",");
-                }
+                json_array_append_number(list, sv->dims[i]);
             }
-            strcat(numbers, "]");
-            json_object_dotset_value(root_object, variable_string, json_parse_string(numbers));
-            free(numbers);
+            json_object_dotset_value(root_object, variable_string, list_value);
             break;
         default:
             break;
     }
 
-    sprintf(variable_string, "%s.%s", var_elem, "subrecords");
-    // fprintf(stderr, "%d %d\n\n", variable->subrec_count,((int)log10( variable->subrec_count+1))+1);
-    if ( !subrec_string && subrecord_count > 0 )
-    {
-        int sub_size = subrecord_count * (((int)log10(variable->subrec_count + 1)) + 4);
-        subrec_string = NEW_N(char, sub_size, "subrecs in writeVariable_json");
-    }
     if ( variable->subrec_count > 0 )
     {
-        subrec_string[0] = '\0';
+        sprintf(variable_string, "%s.%s", var_elem, "subrecords");
+        list_value = json_value_init_array();
+        list = json_value_get_array(list_value);
         for ( i = 0; i < variable->subrec_count; i++ )
         {
-            if ( i == 0 )
-            {
-                strcat(subrec_string, "[");
-            }
-
-            if ( i < variable->subrec_count - 1 )
-            {
-                sprintf(number, "%d,", variable->subrec_ids[i]);
-            }
-            else
-            {
-                sprintf(number, "%d", variable->subrec_ids[i]);
-            }
-            strcat(subrec_string, number);
+            json_array_append_number(list, variable->subrec_ids[i]);
         }
-        strcat(subrec_string, "]");
+        json_object_dotset_value(root_object, variable_string, list_value);
     }
-
-    json_object_dotset_value(root_object, variable_string, json_parse_string(subrec_string));
 }
 /**
  *  This function goes adds the variables to the hashtable for additional processing later.
@@ -357,11 +317,6 @@ static Hash_table *process_state_variables(Famid database_id, Hash_table *classT
             // various codes.
             if ( rval == OK )
             {
-                if ( !subrec_string )
-                {
-                    int sub_size = subrecord_count * (((int)log10(subrecord_count + 1)) + 4);
-                    subrec_string = NEW_N(char, sub_size, "subrec_string in process_state_variables");
-                }
                 Subrecord sr;
                 for ( j = 0; j < subrecord_count; j++ )
                 {
@@ -954,14 +909,14 @@ static int readClasses(Famid database_id, Hash_table *classes, Mili_Class *class
 static void writeClasses_json(Hash_table *classTable, Mili_Class *miliClasses, JSON_Object *root_object)
 {
     int qty_classes = 0;
-    int qty_written = 0;
     char class_elem[64];
     char class_elem_variable[72];
-    char class_elem_variables[2048];
     char class_elem_count[100];
     int i, j;
     Hash_table *variables;
     Htable_entry *next;
+    JSON_Value *list_value;
+    JSON_Array *list;
     qty_classes = classTable->qty_entries;
     json_object_dotset_number(root_object, "Classes.count", qty_classes);
 
@@ -976,47 +931,23 @@ static void writeClasses_json(Hash_table *classTable, Mili_Class *miliClasses, J
         sprintf(class_elem_count, "%s.%s", class_elem, "SuperClass");
         json_object_dotset_number(root_object, class_elem_count, miliClasses[i].superClass);
         variables = miliClasses[i].variables;
-        qty_written = 0;
 
         if ( variables->qty_entries > 0 )
         {
-            sprintf(class_elem_variables, "[");
+            list_value = json_value_init_array();
+            list = json_value_get_array(list_value);
 
             for ( j = 0; j < variables->size; j++ )
             {
-                if ( variables->table[j] == NULL )
+                for ( next = variables->table[j]; next != NULL; next = next->next )
                 {
-                    continue;
-                }
-                strcat(class_elem_variables, "\"");
-                strcat(class_elem_variables, variables->table[j]->key);
-                strcat(class_elem_variables, "\"");
-                if ( qty_written < variables->qty_entries - 1 )
-                {
-                    strcat(class_elem_variables, ",");
-                }
-
-                qty_written++;
-
-                next = variables->table[j]->next;
-                while ( next != NULL )
-                {
-                    strcat(class_elem_variables, "\"");
-                    strcat(class_elem_variables, next->key);
-                    strcat(class_elem_variables, "\"");
-                    if ( qty_written < variables->qty_entries - 1 )
-                    {
-                        strcat(class_elem_variables, ",");
-                    }
-                    qty_written++;
-                    next = next->next;
+                    json_array_append_string(list, next->key);
                 }
             }
 
-            strcat(class_elem_variables, "]");
             sprintf(class_elem_variable, "%s.%s", class_elem, "variables");
 
-            json_object_dotset_value(root_object, class_elem_variable, json_parse_string(class_elem_variables));
+            json_object_dotset_value(root_object, class_elem_variable, list_value);
         }
     }
 }
@@ -1198,19 +1129,19 @@ static int writeMaterials_json(Famid database_id, JSON_Object *root_object)
 
 /**
  *    TAG(write_steps_json)
- *    Write the time steps to the JSON object
+ *    Write the time steps to the JSON object.  Times are appended
+ *    to the array directly, keeping this linear in the state count.
  *
  *    @param Famid database_id  The indentifier for this database
- *    @param JSON_Object  JSON element which to write timesteps
  */
 static void write_steps_json(Famid database_id)
 {
     Mili_family *fam;  // This is the Mili database plot file
-    char time_string[512];
-    char *timesteps;
+    char time_string[32];
     int i;
     JSON_Object *root_object;
-    float time = 0.0;
+    JSON_Value *times_value;
+    JSON_Array *times;
     if ( database_id >= fam_qty || database_id < 0 )
     {
         return;
@@ -1219,40 +1150,22 @@ static void write_steps_json(Famid database_id)
     fam = fam_list[database_id];
 
     root_object = fam->root_object;
-    timesteps = (char *)malloc(fam->state_qty * 40);
-    
-    for ( i = 0; i < fam->state_qty; i++ )
+
+    if ( fam->state_qty > 0 && fam->state_map != NULL )
     {
-        
-        time_string[0] = '\0';
-        time = fam->state_map[i].time;
-        if(i == 0)
-        {
-            sprintf(timesteps, "[%1.7g", fam->state_map[i].time);
-        }else 
+        times_value = json_value_init_array();
+        times = json_value_get_array(times_value);
+
+        // Times keep the single precision digits they are stored with.
+        for ( i = 0; i < fam->state_qty; i++ )
         {
-            strcat(timesteps, ",");
-            sprintf(time_string, "%1.7g", time);
+            sprintf(time_string, "%1.7g", fam->state_map[i].time);
+            json_array_append_number(times, strtod(time_string, NULL));
         }
-        
-        strcat(timesteps, time_string);
-    }
-    if(i > 0)
-    {
-        strcat(timesteps, "]");
-    }
 
-    json_object_dotset_value(root_object, "States.times", json_parse_string(timesteps));
-    if ( JSONFailure == json_object_dotset_number(root_object, "States.count", fam->state_qty) )
-    {
-        return;
-    }
-    if ( !fam->state_map )
-    {
-        return;
+        json_object_dotset_value(root_object, "States.times", times_value);
     }
-    
-    free(timesteps);
+    json_object_dotset_number(root_object, "States.count", fam->state_qty);
 }
 
 static void getGlobalName(char fileName[256], Mili_family *fam)
@@ -1480,7 +1393,11 @@ Return_value write_mili_metadata(Famid database_id, int global)
     serialized_string = json_serialize_to_string_pretty(root_value);
 
     fprintf(OUTFILE, "%s\n", serialized_string);
-    
+    if ( !global )
+    {
+        note_states_end(fam, serialized_string);
+    }
+
     // Time to clean up
     fclose(OUTFILE);
     free(serialized_string);
@@ -1494,11 +1411,6 @@ Return_value write_mili_metadata(Famid database_id, int global)
         }
     }
     free(miliClasses);
-    if ( subrec_string )
-    {
-        free(subrec_string);
-        subrec_string = NULL;
-    }
     htable_delete(classTable, NULL, 0);
     for ( i = 0; i < elementSetCount; i++ )
     {
@@ -1548,11 +1460,82 @@ Return_value mc_write_mili_metadata(Famid database_id)
 {
     return write_mili_metadata(database_id, 0);
 }
+/*
+ *   TAG (note_states_end)
+ *   Remember where the state times end in a freshly written
+ *   processor .mili file so later states can be appended in place.
+ */
+static void note_states_end(Mili_family *fam, char *serialized_string)
+{
+    char tail[128];
+    size_t len, tail_len;
+
+    fam->visit_times_end = 0;
+    if ( fam->state_qty < 1 || serialized_string == NULL )
+    {
+        return;
+    }
+
+    tail_len = sprintf(tail, STATES_TAIL, fam->state_qty);
+    len = strlen(serialized_string);
+    if ( len > tail_len && strcmp(serialized_string + len - tail_len, tail) == 0 )
+    {
+        fam->visit_times_end = (long)(len - tail_len);
+        fam->visit_times_qty = fam->state_qty;
+    }
+}
+
+/*
+ *   TAG (append_state_time)
+ *   Append the newest state time to a processor .mili file in place,
+ *   rewriting only the tail after the times array.  Returns NOT_OK
+ *   when the file has to be rewritten instead.
+ */
+static int append_state_time(Mili_family *fam, char *database_name)
+{
+    FILE *OUTFILE;
+    char time_string[32];
+    long end;
+    int status;
+
+    if ( fam->visit_times_end == 0 || fam->state_qty != fam->visit_times_qty + 1 )
+    {
+        return NOT_OK;
+    }
+
+    OUTFILE = fopen(database_name, "r+");
+    if ( OUTFILE == NULL )
+    {
+        return NOT_OK;
+    }
+
+    end = fam->visit_times_end;
+    fam->visit_times_end = 0;
+    sprintf(time_string, "%1.7g", fam->state_map[fam->state_qty - 1].time);
+    status = fseek(OUTFILE, end, SEEK_SET);
+    if ( status == 0 && fprintf(OUTFILE, STATES_TIME, strtod(time_string, NULL)) > 0 )
+    {
+        end = ftell(OUTFILE);
+        if ( fprintf(OUTFILE, STATES_TAIL "\n", fam->state_qty) > 0 )
+        {
+            fam->visit_times_end = end;
+            fam->visit_times_qty = fam->state_qty;
+        }
+    }
+
+    if ( fclose(OUTFILE) != 0 )
+    {
+        fam->visit_times_end = 0;
+    }
+
+    return (fam->visit_times_end == 0) ? NOT_OK : OK;
+}
+
 /*
  *   TAG (update_visit_file)
- *
+ *   Rewrite a .mili file with the current state times.
  */
-int update_visit_file(char *database_name, Famid database_id)
+int update_visit_file(char *database_name, Famid database_id, int global)
 {
     Mili_family *fam;  // This is the Mili database plot file
 
@@ -1582,6 +1565,10 @@ int update_visit_file(char *database_name, Famid database_id)
     serialized_string = json_serialize_to_string_pretty(user_data);
 
     fprintf(OUTFILE, "%s\n", serialized_string);
+    if ( !global )
+    {
+        note_states_end(fam, serialized_string);
+    }
 
     fclose(OUTFILE);
     free(serialized_string);
@@ -1590,7 +1577,8 @@ int update_visit_file(char *database_name, Famid database_id)
 }
 /**
  *  TAG (mc_update_visit_file)
- *  Function to update an existing file json file.
+ *  Function to update an existing file json file.  New state times
+ *  are appended in place when the file allows it.
  *  @param Famid database   database id for this processor
  */
 int mc_update_visit_file(Famid database_id)
@@ -1617,7 +1605,13 @@ int mc_update_visit_file(Famid database_id)
 
     strcat(MetaDataFile, ".mili");
 
-    rval = update_visit_file(MetaDataFile, database_id);
+    // Usually only the newest state time needs adding.
+    if ( append_state_time(fam, MetaDataFile) == OK )
+    {
+        return OK;
+    }
+
+    rval = update_visit_file(MetaDataFile, database_id, 0);
 
     return rval;
 }
@@ -1996,6 +1990,10 @@ int mc_write_global_metadata(Famid database_id)
 
     json_object_dotset_string(base_object, domain_path, base_name_without_path);
     json_object_set_string(base_object, "fileType", "global");
+
+    // Merged variables arrive without subrecords, so the base only
+    // needs stripping once.
+    remove_subrecords(base_object);
     for ( i = 0; i < processors; i++ )
     {
         if ( files_processed[i] )
@@ -2013,13 +2011,13 @@ int mc_write_global_metadata(Famid database_id)
         if ( next_data )
         {
             incoming_object = json_object(next_data);
-            remove_subrecords(base_object);
             merge_element_sets(base_object, incoming_object);
             merge_variables(base_object, incoming_object);
-            remove_element_counts(base_object);
             merge_classes(base_object, incoming_object);
+            json_value_free(next_data);
         }
     }
+    remove_element_counts(base_object);
     // Lets clean up the counts for some of the data
 
     fix_count(base_object, "Classes");
@@ -2033,6 +2031,8 @@ int mc_write_global_metadata(Famid database_id)
 
     fclose(OUTFILE);
 
+    free(serialized_string);
+    free(files_processed);
     json_value_free(user_data);
     return OK;
 }
@@ -2065,7 +2065,7 @@ int mc_update_global_times(Famid database_id)
     getGlobalName(GlobalMetaDataFile, fam);
 
     strcat(GlobalMetaDataFile, ".mili");
-    update_visit_file(GlobalMetaDataFile, database_id);
+    update_visit_file(GlobalMetaDataFile, database_id, 1);
 
     return rval;
 }
@@ -45,7 +45,6 @@
 #include "mili_internal.h"
 #include "eprtf.h"
 
-#define QTY_NODE_TAGS (2)
 #if TIMER
 int timed = 0;
 #endif
@@ -54,6 +53,13 @@ enum
     QTY_CONN_SURFACE_HEADER_FIELDS = 1
 };
 
+/* Label maps use a direct table while it is at most this many times
+ * larger than the number of labels. */
+enum
+{
+    LABEL_MAP_DENSITY = 4
+};
+
 /* Keep this in sync with object superclass defines in mili.h*/
 static const char *superclass_names[M_QTY_SUPERCLASS] = {"M_UNIT", "M_NODE", "M_TRUSS",   "M_BEAM",    "M_TRI",
                                                          "M_QUAD", "M_TET",  "M_PYRAMID", "M_WEDGE",   "M_HEX",
@@ -103,6 +109,7 @@ static int all_class_count;
 static Mesh_object_class_data **class_data = NULL;
 
 static int SDTLIBCC mc_compare_labels(const void *label1, const void *label2);
+static void delete_label_map(Label_map *p_lm);
 static Return_value make_umesh(Mili_family *fam, Bool_type initial_create, char *mesh_name, int *p_mesh_id);
 static Return_value update_nodes_def(Mili_family *fam, int mesh_id, char *class_name, int start, int stop,
                                      float *coords);
@@ -1291,6 +1298,7 @@ Return_value mc_get_globals_and_locals(Famid fam_id, int mesh_id, char *class_na
 
     sprintf(new_name, "GLOBAL_IDS[/Mesh-%d/Sname-%s/DEF-", mesh_id, class_name);
     fam = fam_list[fam_id];
+    load_ti_params(fam);
 
     count = htable_search_wildcard(fam->param_table, count, FALSE, new_name, "NULL", "NULL", NULL);
     for ( i = 0; i < count; i++ )
@@ -1883,129 +1891,99 @@ static Return_value add_geom(Mesh_descriptor *mesh, char *short_name, int start_
 }
 
 /*****************************************************************
- * TAG( insert_range ) PRIVATE
+ * TAG( find_range ) PRIVATE
  *
- * Insert sort a range specification in a list of range spec's.
- * Sort by range start value in ascending order.  If new range
- * is numerically contiguous to an extant range, merge.
+ * Binary search a block list for the last range that starts at or
+ * before an object id.  Returns -1 if every range starts after it.
  */
-Return_value insert_range(Block_list *p_bl, int start, int stop)
+int find_range(Block_list *p_bl, int id)
 {
-    Int_range *pir, *pir2;
-    Return_value rval;
+    int lo, hi, mid;
 
-    pir = p_bl->blocks;
-    pir2 = NULL;
-    while ( pir )
+    lo = 0;
+    hi = p_bl->block_qty;
+    while ( lo < hi )
     {
-        /*
-         * No overlaps, so now traverse to insert a new range.
-         */
-        if ( OVERLAP(pir->start, pir->stop, start, stop) )
-        {
-            return OBJECT_RANGE_OVERLAP;
-        }
-
-        if ( pir->start < start )
+        mid = lo + (hi - lo) / 2;
+        if ( p_bl->blocks[mid].start <= id )
         {
-            /* Can't insert yet; continue. */
-            /* Save previous node in case we walk off the end. */
-            pir2 = pir;
-            pir = pir->next;
+            lo = mid + 1;
         }
         else
         {
-            if ( pir->start - 1 == stop )
-            {
-                if ( pir2 && pir2->stop + 1 == start )
-                {
-                    pir2->stop = pir->stop;
-                    pir2->next = pir->next;
-                    if ( pir2->next )
-                    {
-                        pir2->next->prev = pir2;
-                    }
-                    p_bl->block_qty--;
-                    free(pir);
-                    pir = pir2;
-                    rval = OBJECT_RANGE_COLLAPSE;
-                }
-                else
-                {
-                    pir->start = start;
-                    rval = OBJECT_RANGE_MERGE;
-                }
-            }
-            else
-            {
-                if ( pir->prev && pir->prev->stop + 1 == start )
-                {
-                    pir->prev->stop = stop;
-                    rval = OBJECT_RANGE_MERGE;
-                }
-                else
-                {
-                    pir2 = NEW(Int_range, "Object id range");
-                    if ( pir2 == NULL )
-                    {
-                        return ALLOC_FAILED;
-                    }
-                    pir2->start = start;
-                    pir2->stop = stop;
+            hi = mid;
+        }
+    }
 
-                    pir2->next = pir;
-                    pir2->prev = pir->prev;
+    return lo - 1;
+}
 
-                    if ( pir->prev )
-                    {
-                        pir->prev->next = pir2;
-                    }
-                    else
-                    {
-                        p_bl->blocks = pir2;
-                    }
+/*****************************************************************
+ * TAG( insert_range ) PRIVATE
+ *
+ * Insert a range specification in a sorted array of range spec's.
+ * Sort by range start value in ascending order.  If new range
+ * is numerically contiguous to an extant range, merge.
+ */
+Return_value insert_range(Block_list *p_bl, int start, int stop)
+{
+    Int_range *pir;
+    int idx, capacity;
+    Bool_type join_prev, join_next;
+    Return_value rval;
 
-                    pir->prev = pir2;
+    /* Ranges before and after the new one. */
+    idx = find_range(p_bl, start) + 1;
 
-                    p_bl->block_qty++;
-                    rval = OBJECT_RANGE_INSERT;
-                }
-            }
-            break;
-        }
+    if ( idx > 0 && OVERLAP(p_bl->blocks[idx - 1].start, p_bl->blocks[idx - 1].stop, start, stop) )
+    {
+        return OBJECT_RANGE_OVERLAP;
+    }
+    if ( idx < p_bl->block_qty && OVERLAP(p_bl->blocks[idx].start, p_bl->blocks[idx].stop, start, stop) )
+    {
+        return OBJECT_RANGE_OVERLAP;
     }
 
-    if ( pir == NULL )
+    join_prev = (idx > 0 && p_bl->blocks[idx - 1].stop + 1 == start);
+    join_next = (idx < p_bl->block_qty && p_bl->blocks[idx].start - 1 == stop);
+
+    if ( join_prev && join_next )
     {
-        if ( pir2 != NULL && pir2->stop + 1 == start )
-        {
-            pir2->stop = stop;
-            rval = OBJECT_RANGE_MERGE;
-        }
-        else
+        p_bl->blocks[idx - 1].stop = p_bl->blocks[idx].stop;
+        memmove(p_bl->blocks + idx, p_bl->blocks + idx + 1, (p_bl->block_qty - idx - 1) * sizeof(Int_range));
+        p_bl->block_qty--;
+        rval = OBJECT_RANGE_COLLAPSE;
+    }
+    else if ( join_prev )
+    {
+        p_bl->blocks[idx - 1].stop = stop;
+        rval = OBJECT_RANGE_MERGE;
+    }
+    else if ( join_next )
+    {
+        p_bl->blocks[idx].start = start;
+        rval = OBJECT_RANGE_MERGE;
+    }
+    else
+    {
+        if ( p_bl->block_qty == p_bl->block_capacity )
         {
-            /* Reached end of list. Insert new. */
-            pir = NEW(Int_range, "Object id range");
+            capacity = (p_bl->block_capacity > 0) ? 2 * p_bl->block_capacity : 4;
+            pir = RENEW_N(Int_range, p_bl->blocks, p_bl->block_capacity, capacity - p_bl->block_capacity,
+                          "Object id ranges");
             if ( pir == NULL )
             {
                 return ALLOC_FAILED;
             }
-            pir->start = start;
-            pir->stop = stop;
-            pir->next = NULL;
-            if ( pir2 == NULL )
-            {
-                p_bl->blocks = pir;
-                pir->prev = NULL;
-            }
-            else
-            {
-                pir2->next = pir;
-                pir->prev = pir2;
-            }
-            p_bl->block_qty++;
-            rval = OBJECT_RANGE_INSERT;
+            p_bl->blocks = pir;
+            p_bl->block_capacity = capacity;
         }
+
+        memmove(p_bl->blocks + idx + 1, p_bl->blocks + idx, (p_bl->block_qty - idx) * sizeof(Int_range));
+        p_bl->blocks[idx].start = start;
+        p_bl->blocks[idx].stop = stop;
+        p_bl->block_qty++;
+        rval = OBJECT_RANGE_INSERT;
     }
 
     p_bl->object_qty += stop - start + 1;
@@ -2016,40 +1994,44 @@ Return_value insert_range(Block_list *p_bl, int start, int stop)
 /*****************************************************************
  * TAG( check_object_ids ) PRIVATE
  *
- *
+ * Verify that each block of object ids lies within one range of
+ * an object group.
  */
 Return_value check_object_ids(Block_list *mo_group, int qty_id_blks, int *mo_id_blks)
 {
-    Return_value rval;
-    Int_range *pir;
     int *pi, *bound;
+    int idx;
 
-    /* Do until an id block is not fully contained in existing mesh def's. */
     bound = mo_id_blks + qty_id_blks * 2;
-    rval = OK;
-    for ( pi = mo_id_blks; pi < bound && rval == OK; pi += 2 )
+    for ( pi = mo_id_blks; pi < bound; pi += 2 )
     {
-        /*
-         * Assume a block is not contained, then loop through and check
-         * until it is shown to be contained in the mesh.
-         */
-        pir = mo_group->blocks;
-        rval = OBJECT_NOT_IN_MESH;
-        while ( pir != NULL )
+        idx = find_range(mo_group, pi[0]);
+        if ( idx < 0 || pi[1] > mo_group->blocks[idx].stop )
         {
-            if ( pi[0] < pir->start || pi[1] > pir->stop )
-            {
-                pir = pir->next;
-            }
-            else
-            {
-                rval = OK;
-                break;
-            }
+            return OBJECT_NOT_IN_MESH;
         }
     }
 
-    return rval;
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( delete_block_list ) PRIVATE
+ *
+ * Free a block list and its ranges.
+ */
+void delete_block_list(Block_list *p_bl)
+{
+    if ( p_bl == NULL )
+    {
+        return;
+    }
+
+    if ( p_bl->blocks != NULL )
+    {
+        free(p_bl->blocks);
+    }
+    free(p_bl);
 }
 
 /*****************************************************************
@@ -2067,14 +2049,15 @@ void delete_mo_data(void *ptr_mo_data)
     free(p_mocd->long_name);
     free(p_mocd->short_name);
 
-    DELETE_LIST(p_mocd->blocks->blocks);
-    free(p_mocd->blocks);
+    delete_block_list(p_mocd->blocks);
 
     if ( NULL != p_mocd->surface_sizes )
     {
         free(p_mocd->surface_sizes);
     }
 
+    delete_label_map(p_mocd->label_map);
+
     free(p_mocd);
 }
 
@@ -2311,26 +2294,19 @@ Return_value mc_load_conn_labels(Famid fam_id, int mesh_id, char *short_name, in
     int num_items_read, dummy;
     Return_value status;
 
-    char sname[M_MAX_NAME_LEN];
-
     int *block_range_ptr;
 
     int *labels_ptr = NULL, *labels_elem_ptr = NULL;
     int total_qty_read = 0;
     int label_index = 0;
 
-    char **wildcard_list_labels;
+    Ti_label_class *p_lc;
+    char **label_names;
     int num_entries_labels = 0;
 
-    char mili_version[M_MAX_NAME_LEN], host[M_MAX_NAME_LEN], arch[M_MAX_NAME_LEN], timestamp[M_MAX_NAME_LEN],
-        xmilics_version[M_MAX_NAME_LEN];
-    char *major, *minor;
     char id_prefix[32];
     char *wildcard_list_suffix;
     char wildcard_list_id[M_MAX_NAME_LEN];
-    Hash_table *table;
-
-    Bool_type particle_class = FALSE;
 
     *num_blocks = 0;
     *block_range = NULL;
@@ -2341,14 +2317,6 @@ Return_value mc_load_conn_labels(Famid fam_id, int mesh_id, char *short_name, in
         return status;
     }
     fam = fam_list[fam_id];
-    if ( fam->char_header[DIR_VERSION_IDX] > 1 )
-    {
-        table = fam->param_table;
-    }
-    else
-    {
-        table = fam->ti_param_table;
-    }
     if ( !fam->ti_enable )
     {
         return OK;
@@ -2360,35 +2328,16 @@ Return_value mc_load_conn_labels(Famid fam_id, int mesh_id, char *short_name, in
         return status;
     }
 
-    strcpy(sname, "Sname-");
-    strncat(sname, short_name, M_MAX_NAME_LEN - 7);
-    strcat(sname, "/");
-
-    /* Load the list of Label names and id names */
-    num_entries_labels = htable_search_wildcard(table, 0, FALSE, "Element Labels[", sname, "NULL", NULL);
-    if ( num_entries_labels == 0 )
+    /* Look up the Label names in the family's label index */
+    p_lc = find_ti_label_class(fam, short_name);
+    if ( (p_lc == NULL || p_lc->qty_conn_labels == 0) && mc_is_particle_class(fam_id, short_name) )
     {
-        particle_class = mc_is_particle_class(fam_id, short_name);
-        if ( particle_class )
-        {
-            strcpy(sname, "Sname-");
-            strncat(sname, "ml", M_MAX_NAME_LEN - 7);
-            num_entries_labels = htable_search_wildcard(table, 0, FALSE, "Element Labels[", sname, "NULL", NULL);
-            /* Try all older naming convensions */
-            if ( num_entries_labels == 0 )
-                num_entries_labels =
-                    htable_search_wildcard(table, 0, FALSE, "Element Labels[", "Sname-particle", "NULL", NULL);
-            if ( num_entries_labels == 0 )
-                num_entries_labels =
-                    htable_search_wildcard(table, 0, FALSE, "Element Labels[", "Sname-particle-elem", "NULL", NULL);
-            if ( num_entries_labels == 0 )
-            {
-                *num_blocks = 0;
-                *block_range = NULL;
-                return OK;
-            }
-        }
-    } /*( num_entries_labels==0 )*/
+        p_lc = find_ti_particle_labels(fam);
+    }
+    if ( p_lc != NULL )
+    {
+        num_entries_labels = p_lc->qty_conn_labels;
+    }
 
     if ( num_entries_labels == 0 )
     {
@@ -2397,47 +2346,10 @@ Return_value mc_load_conn_labels(Famid fam_id, int mesh_id, char *short_name, in
         return OK;
     }
 
-    wildcard_list_labels = NEW_N(char *, num_entries_labels, "Element Labels");
-    if ( num_entries_labels > 0 && wildcard_list_labels == NULL )
-    {
-        return ALLOC_FAILED;
-    }
-
-    num_entries_labels =
-        htable_search_wildcard(table, 0, FALSE, "Element Labels[", sname, "NULL", wildcard_list_labels);
+    label_names = p_lc->conn_labels;
 
-    /* Determine if this is a pre 8.1 database to figure out the naming of
-     * the ids. */
-    status = mc_get_metadata(fam_id, mili_version, host, arch, timestamp, xmilics_version);
-    if ( status != OK )
-    {
-        return status;
-    }
-
-    /* If there was no version string assume an ancient version of Mili.
-     * Otherwise parse the string. */
-    if ( strlen(mili_version) == 0 )
-    {
-        strcpy(id_prefix, "Element Labels-Mats");
-    }
-    else
-    {
-        major = strtok(mili_version, "_");
-        major[0] = '0';
-        minor = strtok(NULL, "_");
-        if ( atoi(major) < 8 )
-        {
-            strcpy(id_prefix, "Element Labels-Mats");
-        }
-        else if ( atoi(major) == 8 && atoi(minor) == 0 )
-        {
-            strcpy(id_prefix, "Element Labels-Mats");
-        }
-        else
-        {
-            strcpy(id_prefix, "Element Labels-ElemIds");
-        }
-    }
+    /* Pre 8.1 databases name the ids differently. */
+    strcpy(id_prefix, ti_conn_id_prefix(fam));
 
     status = mc_ti_undef_class(fam_id);
     if ( status != OK )
@@ -2447,11 +2359,9 @@ Return_value mc_load_conn_labels(Famid fam_id, int mesh_id, char *short_name, in
 
     for ( i = 0; i < num_entries_labels; i++ )
     {
-        status = mc_ti_read_array(fam_id, wildcard_list_labels[i], (void **)&labels_ptr, &num_items_read);
+        status = mc_ti_read_array(fam_id, label_names[i], (void **)&labels_ptr, &num_items_read);
         if ( status != OK )
         {
-            htable_delete_wildcard_list(num_entries_labels, wildcard_list_labels);
-            free(wildcard_list_labels);
             if ( labels_ptr )
             {
                 free(labels_ptr);
@@ -2459,7 +2369,7 @@ Return_value mc_load_conn_labels(Famid fam_id, int mesh_id, char *short_name, in
             return status;
         }
 
-        wildcard_list_suffix = strstr(wildcard_list_labels[i], "[");
+        wildcard_list_suffix = strstr(label_names[i], "[");
         strcpy(wildcard_list_id, id_prefix);
         strcat(wildcard_list_id, wildcard_list_suffix);
 
@@ -2477,8 +2387,6 @@ Return_value mc_load_conn_labels(Famid fam_id, int mesh_id, char *short_name, in
 
         if ( status != OK || dummy != num_items_read )
         {
-            htable_delete_wildcard_list(num_entries_labels, wildcard_list_labels);
-            free(wildcard_list_labels);
             if ( labels_ptr )
             {
                 free(labels_ptr);
@@ -2522,15 +2430,6 @@ Return_value mc_load_conn_labels(Famid fam_id, int mesh_id, char *short_name, in
         return status;
     }
 
-    htable_delete_wildcard_list(num_entries_labels, wildcard_list_labels);
-    free(wildcard_list_labels);
-
-    if ( num_entries_labels == 0 )
-    {
-        *num_blocks = 0;
-        *block_range = NULL;
-        return OK;
-    }
     /* Convert 1D list to 2D block list. */
     status = list_to_blocks(total_qty_read, labels, &block_range_ptr, num_blocks);
     if ( status != OK )
@@ -2726,8 +2625,7 @@ Return_value mc_load_node_labels(Famid fam_id, int mesh_id, char *short_name, in
 
     int *labels_ptr = NULL, *temp_labels = NULL;
 
-    char *labels_var = NULL;
-    Bool_type labels_found = FALSE;
+    Ti_label_class *p_lc;
 
     *num_blocks = 0;
     *block_range = NULL;
@@ -2778,12 +2676,10 @@ Return_value mc_load_node_labels(Famid fam_id, int mesh_id, char *short_name, in
     status = mc_ti_read_array(fam_id, label_name, (void **)&labels_ptr, &num_items_read);
     if ( status != OK )
     {
-        labels_found = mc_ti_find_var_name(fam_id, "Node Labels", short_name, &labels_var);
-        if ( labels_found )
-            status = mc_ti_read_array(fam_id, labels_var, (void **)&labels_ptr, &num_items_read);
-        if ( labels_var != NULL )
+        p_lc = find_ti_label_class(fam, short_name);
+        if ( p_lc != NULL && p_lc->node_labels != NULL )
         {
-            free(labels_var);
+            status = mc_ti_read_array(fam_id, p_lc->node_labels, (void **)&labels_ptr, &num_items_read);
         }
         if ( status != OK )
         {
@@ -2898,6 +2794,324 @@ Return_value mc_load_node_labels(Famid fam_id, int mesh_id, char *short_name, in
     return status;
 }
 
+/*****************************************************************
+ * TAG( delete_label_map ) LOCAL
+ *
+ * Free a class label map.
+ */
+static void delete_label_map(Label_map *p_lm)
+{
+    if ( p_lm == NULL )
+    {
+        return;
+    }
+
+    if ( p_lm->direct != NULL )
+    {
+        free(p_lm->direct);
+    }
+    if ( p_lm->sorted_labels != NULL )
+    {
+        free(p_lm->sorted_labels);
+    }
+    if ( p_lm->sorted_ids != NULL )
+    {
+        free(p_lm->sorted_ids);
+    }
+    if ( p_lm->labels != NULL )
+    {
+        free(p_lm->labels);
+    }
+    free(p_lm);
+}
+
+/*****************************************************************
+ * TAG( build_label_map ) LOCAL
+ *
+ * Load the labels of a class and build the tables that map them to
+ * local ids and back.  A class without labels is given the identity
+ * map.
+ */
+static Return_value build_label_map(Famid fam_id, int mesh_id, char *short_name, Mesh_object_class_data *p_mocd,
+                                    Label_map **pp_lm)
+{
+    Label_map *p_lm;
+    LONGLONG span;
+    int qty, num_blocks, i;
+    int *labels, *ids, *block_range = NULL;
+    Mili_Int_2tuple *pairs;
+    Return_value rval;
+
+    qty = p_mocd->blocks->object_qty;
+
+    p_lm = NEW(Label_map, "Class label map");
+    labels = NEW_N(int, qty, "Label map labels");
+    ids = NEW_N(int, qty, "Label map ids");
+    if ( p_lm == NULL || (qty > 0 && (labels == NULL || ids == NULL)) )
+    {
+        free(p_lm);
+        free(labels);
+        free(ids);
+        return ALLOC_FAILED;
+    }
+
+    if ( p_mocd->superclass == M_NODE )
+    {
+        rval = mc_load_node_labels(fam_id, mesh_id, short_name, &num_blocks, &block_range, labels);
+        for ( i = 0; i < qty; i++ )
+        {
+            ids[i] = i + 1;
+        }
+    }
+    else
+    {
+        rval = mc_load_conn_labels(fam_id, mesh_id, short_name, qty, &num_blocks, &block_range, ids, labels);
+    }
+    if ( rval != OK )
+    {
+        free(p_lm);
+        free(labels);
+        free(ids);
+        return rval;
+    }
+
+    /* Unlabelled objects are known by their local ids. */
+    if ( block_range == NULL )
+    {
+        for ( i = 0; i < qty; i++ )
+        {
+            ids[i] = i + 1;
+            labels[i] = i + 1;
+        }
+    }
+    else
+    {
+        free(block_range);
+    }
+
+    p_lm->qty = qty;
+    p_lm->min_label = (qty > 0) ? labels[0] : 0;
+    p_lm->max_label = (qty > 0) ? labels[0] : -1;
+    p_lm->id_qty = 0;
+    for ( i = 0; i < qty; i++ )
+    {
+        if ( labels[i] < p_lm->min_label )
+        {
+            p_lm->min_label = labels[i];
+        }
+        if ( labels[i] > p_lm->max_label )
+        {
+            p_lm->max_label = labels[i];
+        }
+        if ( ids[i] > p_lm->id_qty )
+        {
+            p_lm->id_qty = ids[i];
+        }
+    }
+
+    /* Local id to label. */
+    p_lm->labels = NEW_N(int, p_lm->id_qty, "Label map labels by id");
+    if ( p_lm->id_qty > 0 && p_lm->labels == NULL )
+    {
+        rval = ALLOC_FAILED;
+    }
+    for ( i = 0; rval == OK && i < qty; i++ )
+    {
+        if ( ids[i] > 0 )
+        {
+            p_lm->labels[ids[i] - 1] = labels[i];
+        }
+    }
+
+    /*
+     * Label to local id, direct when the labels are compact.  The span
+     * of two int labels can exceed an int; sparse labels are sorted.
+     */
+    span = (LONGLONG)p_lm->max_label - p_lm->min_label + 1;
+    if ( rval == OK && qty > 0 && span <= (LONGLONG)qty * LABEL_MAP_DENSITY )
+    {
+        p_lm->direct = NEW_N(int, span, "Label map direct");
+        if ( p_lm->direct == NULL )
+        {
+            rval = ALLOC_FAILED;
+        }
+        for ( i = 0; rval == OK && i < qty; i++ )
+        {
+            p_lm->direct[(LONGLONG)labels[i] - p_lm->min_label] = ids[i];
+        }
+    }
+    else if ( rval == OK && qty > 0 )
+    {
+        pairs = NEW_N(Mili_Int_2tuple, qty, "Label map pairs");
+        p_lm->sorted_labels = NEW_N(int, qty, "Label map sorted labels");
+        p_lm->sorted_ids = NEW_N(int, qty, "Label map sorted ids");
+        if ( pairs == NULL || p_lm->sorted_labels == NULL || p_lm->sorted_ids == NULL )
+        {
+            rval = ALLOC_FAILED;
+        }
+        else
+        {
+            for ( i = 0; i < qty; i++ )
+            {
+                pairs[i][0] = labels[i];
+                pairs[i][1] = ids[i];
+            }
+            /* mc_compare_labels() orders the pairs by their leading label. */
+            qsort(pairs, qty, sizeof(Mili_Int_2tuple), mc_compare_labels);
+            for ( i = 0; i < qty; i++ )
+            {
+                p_lm->sorted_labels[i] = pairs[i][0];
+                p_lm->sorted_ids[i] = pairs[i][1];
+            }
+        }
+        free(pairs);
+    }
+
+    free(labels);
+    free(ids);
+
+    if ( rval != OK )
+    {
+        delete_label_map(p_lm);
+        return rval;
+    }
+
+    *pp_lm = p_lm;
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( get_label_map ) LOCAL
+ *
+ * Return the label map of a class, building it on first use.
+ */
+static Return_value get_label_map(Famid fam_id, int mesh_id, char *short_name, Label_map **pp_lm)
+{
+    Mili_family *fam;
+    Htable_entry *p_hte;
+    Mesh_object_class_data *p_mocd;
+    Return_value rval;
+
+    rval = validate_fam_id(fam_id);
+    if ( rval != OK )
+    {
+        return rval;
+    }
+    fam = fam_list[fam_id];
+
+    if ( mesh_id < 0 || mesh_id >= fam->qty_meshes )
+    {
+        return NO_MESH;
+    }
+
+    rval = htable_search(fam->meshes[mesh_id]->mesh_data.umesh_data, short_name, FIND_ENTRY, &p_hte);
+    if ( p_hte == NULL )
+    {
+        return NO_CLASS;
+    }
+    p_mocd = (Mesh_object_class_data *)p_hte->data;
+
+    if ( p_mocd->label_map == NULL )
+    {
+        rval = build_label_map(fam_id, mesh_id, short_name, p_mocd, &p_mocd->label_map);
+        if ( rval != OK )
+        {
+            return rval;
+        }
+    }
+
+    *pp_lm = p_mocd->label_map;
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( mc_labels_to_local_ids ) PUBLIC
+ *
+ * Resolve a list of object labels of a class to local (1-based)
+ * object ids.  Labels that do not exist in the class resolve to 0.
+ */
+Return_value mc_labels_to_local_ids(Famid fam_id, int mesh_id, char *short_name, int qty, int *labels, int *local_ids)
+{
+    Label_map *p_lm;
+    int *base;
+    int i, n, half, label;
+    Return_value rval;
+
+    rval = get_label_map(fam_id, mesh_id, short_name, &p_lm);
+    if ( rval != OK )
+    {
+        return rval;
+    }
+
+    for ( i = 0; i < qty; i++ )
+    {
+        label = labels[i];
+        local_ids[i] = 0;
+
+        if ( label < p_lm->min_label || label > p_lm->max_label )
+        {
+            continue;
+        }
+
+        if ( p_lm->direct != NULL )
+        {
+            local_ids[i] = p_lm->direct[(LONGLONG)label - p_lm->min_label];
+            continue;
+        }
+
+        /* Branch-free lower bound search of the sorted labels. */
+        base = p_lm->sorted_labels;
+        n = p_lm->qty;
+        while ( n > 1 )
+        {
+            half = n / 2;
+            base = (base[half - 1] < label) ? base + half : base;
+            n -= half;
+        }
+        if ( *base == label )
+        {
+            local_ids[i] = p_lm->sorted_ids[base - p_lm->sorted_labels];
+        }
+    }
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( mc_local_ids_to_labels ) PUBLIC
+ *
+ * Map a list of local (1-based) object ids of a class to their
+ * labels.  Ids outside the class map to 0.
+ */
+Return_value mc_local_ids_to_labels(Famid fam_id, int mesh_id, char *short_name, int qty, int *local_ids, int *labels)
+{
+    Label_map *p_lm;
+    int i;
+    Return_value rval;
+
+    rval = get_label_map(fam_id, mesh_id, short_name, &p_lm);
+    if ( rval != OK )
+    {
+        return rval;
+    }
+
+    for ( i = 0; i < qty; i++ )
+    {
+        if ( local_ids[i] < 1 || local_ids[i] > p_lm->id_qty )
+        {
+            labels[i] = 0;
+        }
+        else
+        {
+            labels[i] = p_lm->labels[local_ids[i] - 1];
+        }
+    }
+
+    return OK;
+}
+
 /*****************************************************************
  * TAG( mc_load_surface ) PUBLIC
  *
@@ -3528,6 +3742,55 @@ Return_value mc_get_class_idents(Famid fam_id, int mesh_id, char *class_name, in
     return rval;
 }
 
+/*****************************************************************
+ * TAG( mc_get_class_id_block ) PUBLIC
+ *
+ * Return the contiguous block of object ids of a class that holds
+ * an id, or OBJECT_NOT_IN_MESH if the class does not have it.
+ */
+Return_value mc_get_class_id_block(Famid fam_id, int mesh_id, char *class_name, int id, int *start, int *stop)
+{
+    Mili_family *fam;
+    Htable_entry *p_hte;
+    Mesh_object_class_data *p_mocd;
+    int idx;
+    Return_value rval;
+
+    rval = validate_fam_id(fam_id);
+    if ( rval != OK )
+    {
+        return rval;
+    }
+    fam = fam_list[fam_id];
+
+    if ( mesh_id < 0 || mesh_id > fam->qty_meshes - 1 )
+    {
+        return NO_MESH;
+    }
+
+    htable_search(fam->meshes[mesh_id]->mesh_data.umesh_data, class_name, FIND_ENTRY, &p_hte);
+    if ( p_hte == NULL )
+    {
+        return NO_CLASS;
+    }
+    p_mocd = (Mesh_object_class_data *)p_hte->data;
+    if ( p_mocd->blocks == NULL )
+    {
+        return OBJECT_NOT_IN_MESH;
+    }
+
+    idx = find_range(p_mocd->blocks, id);
+    if ( idx < 0 || id > p_mocd->blocks->blocks[idx].stop )
+    {
+        return OBJECT_NOT_IN_MESH;
+    }
+
+    *start = p_mocd->blocks->blocks[idx].start;
+    *stop = p_mocd->blocks->blocks[idx].stop;
+
+    return OK;
+}
+
 /*****************************************************************
  *
  * MERGE WITH get_elem_qty_in_def()!
@@ -106,9 +106,13 @@ static Return_value commit_non_state(Mili_family *fam);
 static Return_value set_defaults(char *root_name, char *path, Mili_family *fam, char *control_string,
                                  Bool_type *create_db, Famid *fam_id);
 static Return_value test_open_next(Mili_family *fam, Bool_type *open_next);
+static Return_value st_file_pool_open(Mili_family *fam, int index, char *fname);
+static Return_value open_db(char *root_name, char *path, char *control_string, Famid *p_fam_id);
+static Return_value flush_family(Famid fam_id, int data_type);
 
 static char *name_states_per_file = "states per file";
 static char *name_file_size_limit = "max size per file";
+static char *name_state_alignment = "state alignment";
 
 /*****************************************************************
  * TAG( fam_list )
@@ -132,6 +136,13 @@ int fam_qty;
  */
 int fam_array_length;
 
+/*****************************************************************
+ * TAG( pooled_st_file_qty )
+ *
+ * Quantity of state files held open in the pools of all families.
+ */
+static int pooled_st_file_qty = 0;
+
 /*****************************************************************
  * TAG( internal_sizes )
  *
@@ -151,8 +162,19 @@ int mili_verbose = FALSE;
  * TAG( header_version )
  *
  * The current version of the header format.
+ * Version 4 marks a family whose state records and subrecords are
+ * aligned (see mc_set_state_alignment()), which an older library
+ * would read at packed offsets.
+ */
+static unsigned char header_version = 4;
+
+/*****************************************************************
+ * TAG( packed_header_version )
+ *
+ * The header version written for families with packed state
+ * records, which older libraries can still read.
  */
-static unsigned char header_version = 3;
+static unsigned char packed_header_version = 3;
 
 /*****************************************************************
  * TAG( directory_version )
@@ -270,6 +292,9 @@ static Return_value set_defaults(char *root_name, char *path, Mili_family *fam,
     fam->st_file_count = 0;
     fam->st_file_index_offset = 0;
     fam->cur_st_offset = 0;
+    fam->st_file_pool = NULL;
+    fam->st_file_pool_size = DEFAULT_ST_FILE_POOL_SIZE;
+    fam->st_file_pool_clock = 0;
     fam->file_st_qty = 0;
     fam->cur_srec_id = 0;
     fam->state_qty = 0;
@@ -300,7 +325,11 @@ static Return_value set_defaults(char *root_name, char *path, Mili_family *fam,
     fam->hide_states = FALSE;
     fam->state_dirty = 0;
     fam->subrec_start_check = FALSE;
+    fam->shared_spans = FALSE;
+    fam->io_stats = NULL;
     fam->visit_file_on = 0;
+    fam->state_codec = M_CODEC_NONE;
+    fam->state_align = 0;
 
     /* Parse the control string and initialize the header. */
     rval = parse_control_string(ctl_str, fam, create_db);
@@ -345,6 +374,12 @@ static Return_value set_defaults(char *root_name, char *path, Mili_family *fam,
     fam->lock_file_descriptor = 0;
     fam->write_tfile = TRUE;
 
+    fam->ti_params_deferred = FALSE;
+    fam->ti_param_index = NULL;
+    fam->open_index = NULL;
+    fam->ti_label_index = NULL;
+    fam->write_open_index = FALSE;
+    fam->th_stream = NULL;
     fam->ti_enable = ti_enable;
     fam->ti_only = ti_only; /* If true,then only TI files are read and written */
     fam->ti_data_found = ti_data_found;
@@ -407,6 +442,7 @@ Return_value mc_quick_open(char *root_name, char *path, char *control_string, Fa
     }
 
     rval = open_family(fam_id);
+    unload_open_index(fam);
 
 #if TIMER
     stop = clock();
@@ -443,6 +479,26 @@ Return_value mc_quick_open(char *root_name, char *path, char *control_string, Fa
  * family identifier to caller.
  */
 Return_value mc_open(char *root_name, char *path, char *control_string, Famid *p_fam_id)
+{
+    double start;
+    Return_value rval;
+
+    start = io_stats_now();
+    rval = open_db(root_name, path, control_string, p_fam_id);
+    if ( rval == OK && *p_fam_id != ID_FAIL )
+    {
+        io_stats_time(*p_fam_id, M_STAT_OPEN, start);
+    }
+
+    return rval;
+}
+
+/*****************************************************************
+ * TAG( open_db ) LOCAL
+ *
+ * Open or create a family for mc_open().
+ */
+static Return_value open_db(char *root_name, char *path, char *control_string, Famid *p_fam_id)
 {
 #if TIMER
     clock_t start, stop;
@@ -483,6 +539,16 @@ Return_value mc_open(char *root_name, char *path, char *control_string, Famid *p
         return OK;
     }
 
+    /* Collect I/O statistics from the start if the environment asks. */
+    if ( getenv("MILI_IO_STATS") != NULL )
+    {
+        rval = io_stats_enable(fam);
+        if ( rval != OK )
+        {
+            return rval;
+        }
+    }
+
 #ifdef MODE_TEST
     /* Record pertinent data for test app. */
     mode_test_data[0] = fam->swap_bytes;
@@ -498,6 +564,7 @@ Return_value mc_open(char *root_name, char *path, char *control_string, Famid *p
     else
     {
         rval = open_family(fam_id);
+        unload_open_index(fam);
     }
 #if TIMER
     stop = clock();
@@ -665,6 +732,14 @@ Return_value parse_control_string(char *ctl_str, Mili_family *fam, Bool_type *p_
                     i = 0;
                     break;
                 }
+#ifdef MILI_READER
+                /* The reader library only opens existing families to read. */
+                if ( *p_c != 'r' )
+                {
+                    rval = BAD_ACCESS_TYPE;
+                    break;
+                }
+#endif
                 switch ( *p_c )
                 {
                     case 'w':
@@ -756,6 +831,34 @@ Return_value parse_control_string(char *ctl_str, Mili_family *fam, Bool_type *p_
 
                 break;
 
+            case 'Z':
+                /* Parse state file compression specification. */
+                p_c++;
+
+                switch ( *p_c )
+                {
+                    case 'n':
+                        fam->state_codec = M_CODEC_NONE;
+                        break;
+                    case 'r':
+                        fam->state_codec = M_CODEC_RLE;
+                        break;
+                    case 'z':
+                        if ( state_codec_available(M_CODEC_ZLIB) )
+                        {
+                            fam->state_codec = M_CODEC_ZLIB;
+                        }
+                        else
+                        {
+                            rval = BAD_CONTROL_STRING;
+                        }
+                        break;
+                    default:
+                        rval = BAD_CONTROL_STRING;
+                        break;
+                }
+                break;
+
             case 'E':
                 /* Parse endianness specification. */
                 p_c++;
@@ -833,6 +936,7 @@ Return_value parse_control_string(char *ctl_str, Mili_family *fam, Bool_type *p_
 
                     rval = OK;
                 }
+#ifndef MILI_READER
                 else if ( rval == FAMILY_NOT_FOUND )
                 {
                     /* No database - default access is "write". */
@@ -840,6 +944,7 @@ Return_value parse_control_string(char *ctl_str, Mili_family *fam, Bool_type *p_
                     create_family = TRUE;
                     rval = OK;
                 }
+#endif
 
                 /* Been here, done this. */
                 func_requested[CTL_ACCESS_MODE] = TRUE;
@@ -1200,6 +1305,13 @@ Return_value open_family(Famid fam_id)
 
     status = determine_map_mode(fam);
 
+    /* Use the open-time index instead of the non-state files if valid. */
+    status = load_open_index(fam);
+    if ( status != OK )
+    {
+        return status;
+    }
+
     /* Traverse non-state data files and load directories. */
     if ( !fam->ti_only )
     {
@@ -1214,8 +1326,12 @@ Return_value open_family(Famid fam_id)
     double cumalative2 = 0.0;
     start2 = clock();
 #endif
-    /* Load TI directories if they exist */
-    if ( fam->char_header[DIR_VERSION_IDX] == 1 && fam->ti_enable )
+    /* Load TI directories if they exist; readers defer to first lookup. */
+    if ( fam->char_header[DIR_VERSION_IDX] == 1 && fam->ti_enable && fam->access_mode == 'r' )
+    {
+        fam->ti_params_deferred = TRUE;
+    }
+    else if ( fam->char_header[DIR_VERSION_IDX] == 1 && fam->ti_enable )
     {
         rval = load_ti_directories(fam);
         if ( fam->ti_file_count == 0 || rval != OK )
@@ -1277,6 +1393,20 @@ Return_value open_family(Famid fam_id)
 #if TIMER
     start2 = clock();
 #endif
+    /*
+     * Subrecord offsets depend on the state alignment, which is only
+     * honored in a family whose header says its states are aligned.
+     */
+    fam->state_align = 0;
+    if ( fam->char_header[HDR_VERSION_IDX] >= header_version )
+    {
+        status = mc_read_scalar(fam_id, name_state_alignment, &fam->state_align);
+        if ( status != OK || fam->state_align < 2 || (fam->state_align & (fam->state_align - 1)) != 0 )
+        {
+            return CORRUPTED_FILE;
+        }
+    }
+
     /* Traverse non-state data files and load descriptors. */
 
     if ( !fam->ti_only )
@@ -1755,6 +1885,7 @@ static Return_value create_family(Mili_family *fam)
     fam->partition_scheme = DEFAULT_PARTITION_SCHEME;
     fam->states_per_file = 0;
     fam->bytes_per_file_limit = 0;
+    fam->state_align = 0;
     fam->post_modified = 0;
 
     fam->st_file_count = 0;
@@ -2005,17 +2136,19 @@ static Return_value delete_family(char *root, char *path)
 
     /*
      * Delete all directory files which consist of the root and an entirely
-     * numeric suffix or the root and an entirely upper-case letter suffix.
-     * These are all files which _could_ be created by Mili, but mixed
-     * alphanumeric or lower case suffixes could not be created by Mili
-     * so leave them alone.
+     * numeric suffix or the root and an entirely upper-case letter suffix,
+     * plus compressed state files (numeric suffix and 'z'), the open-time
+     * index and the time-history stream.  These are all files which
+     * _could_ be created by Mili, but other mixed alphanumeric or lower
+     * case suffixes could not be created by Mili so leave them alone.
      */
     rootlen = strlen(root);
     for ( i = 0; i < qty; i++ )
     {
         p_fname = SASTRING(sarr, i);
 
-        if ( is_numeric(p_fname + rootlen) || is_all_upper(p_fname + rootlen) )
+        if ( is_numeric(p_fname + rootlen) || is_all_upper(p_fname + rootlen) || is_zip_suffix(p_fname + rootlen)
+             || strcmp(p_fname + rootlen, "index") == 0 || strcmp(p_fname + rootlen, "th") == 0 )
         {
             sprintf(fname, "%s/%s", path, p_fname);
             if ( unlink(fname) != 0 )
@@ -2057,7 +2190,7 @@ static Return_value init_header(Mili_family *fam)
 
     /* Fill character header fields. */
     strncpy(&fam->char_header[MILI_MAGIC_NUMBER_IDX], "mili", 4);
-    fam->char_header[HDR_VERSION_IDX] = header_version;
+    fam->char_header[HDR_VERSION_IDX] = packed_header_version;
     fam->char_header[DIR_VERSION_IDX] = directory_version;
     if ( fam->swap_bytes )
     {
@@ -2263,7 +2396,7 @@ Return_value mc_get_metadata(Famid fam_id, char *mili_version, char *host, char
 Return_value mc_close(Famid fam_id)
 {
     Mili_family *fam;
-    Return_value rval;
+    Return_value rval, zip_rval;
     char fname[M_MAX_NAME_LEN];
     int state_qty = 0;
     State_descriptor *p_sd;
@@ -2292,7 +2425,9 @@ Return_value mc_close(Famid fam_id)
         fam->file_count = 1;
     }
 
+#ifndef MILI_READER
     json_value_free(fam->root_value);
+#endif
 
     if ( fam->cur_file != NULL )
     {
@@ -2325,6 +2460,12 @@ Return_value mc_close(Famid fam_id)
         fam->time_state_file = NULL;
     }
 
+    rval = close_th_stream(fam);
+    if ( rval != OK && mili_verbose )
+    {
+        fprintf(stderr, "Mili - unable to complete time-history stream.\n");
+    }
+
     if ( fam->ti_cur_file != NULL )
     {
         rval = mc_flush(fam_id, TI_DATA);
@@ -2352,6 +2493,19 @@ Return_value mc_close(Famid fam_id)
             return rval;
         }
     }
+    /* A failed compression is returned once the close is complete. */
+    zip_rval = compress_state_files(fam);
+    if ( zip_rval != OK && mili_verbose )
+    {
+        fprintf(stderr, "Mili - unable to compress state files.\n");
+    }
+    /* Non-state files are final; refresh or remove the open-time index. */
+    rval = write_open_index(fam);
+    if ( rval != OK && mili_verbose )
+    {
+        fprintf(stderr, "Mili - unable to write open index.\n");
+    }
+
     /* If access allowed writing, remove the write lock indicator. */
     if ( filelock_enable && (fam->access_mode == 'w' || fam->access_mode == 'a') )
     {
@@ -2370,7 +2524,7 @@ Return_value mc_close(Famid fam_id)
 
     /* Added September 30, 2006: IRC */
     fam_qty--;
-    return rval;
+    return (zip_rval != OK) ? zip_rval : rval;
 }
 
 /*****************************************************************
@@ -2489,6 +2643,56 @@ Return_value mc_limit_filesize(Famid fam_id, LONGLONG filesize)
     return rval;
 }
 
+/*****************************************************************
+ * TAG( mc_set_state_alignment ) PUBLIC
+ *
+ * Start each state record and each subrecord on a multiple of
+ * alignment bytes (a power of two), so subrecords can be written
+ * concurrently and read with direct I/O.  Must precede the first
+ * state record format definition.  Data written with mc_wrt_stream()
+ * is not padded.  An aligned family is given the current header
+ * version so libraries predating alignment won't append to it.
+ */
+Return_value mc_set_state_alignment(Famid fam_id, int alignment)
+{
+    Mili_family *fam;
+    Return_value rval;
+
+    rval = validate_fam_id(fam_id);
+    if ( rval != OK )
+    {
+        return rval;
+    }
+    fam = fam_list[fam_id];
+
+    CHECK_WRITE_ACCESS(fam)
+
+    if ( alignment < 1 || (alignment & (alignment - 1)) != 0 )
+    {
+        return NOT_APPLICABLE;
+    }
+    if ( fam->qty_srecs > 0 || fam->state_qty > 0 )
+    {
+        return TOO_LATE;
+    }
+    if ( alignment == 1 )
+    {
+        alignment = 0;
+    }
+
+    rval = mc_wrt_scalar(fam_id, M_INT, name_state_alignment, (void *)&alignment);
+    if ( rval == OK )
+    {
+        fam->state_align = alignment;
+
+        /* Re-write the character header to disk. */
+        fam->char_header[HDR_VERSION_IDX] = (alignment > 1) ? header_version : packed_header_version;
+        rval = write_header(fam);
+    }
+
+    return rval;
+}
+
 /*****************************************************************
  * TAG( mc_flush ) PUBLIC
  *
@@ -2496,6 +2700,23 @@ Return_value mc_limit_filesize(Famid fam_id, LONGLONG filesize)
  * the file,  or flush the current state file.
  */
 Return_value mc_flush(Famid fam_id, int data_type)
+{
+    double start;
+    Return_value rval;
+
+    start = io_stats_clock(fam_id);
+    rval = flush_family(fam_id, data_type);
+    io_stats_time(fam_id, M_STAT_FLUSH, start);
+
+    return rval;
+}
+
+/*****************************************************************
+ * TAG( flush_family ) LOCAL
+ *
+ * Flush family data for mc_flush().
+ */
+static Return_value flush_family(Famid fam_id, int data_type)
 {
     Mili_family *fam;
     Return_value rval;
@@ -3040,13 +3261,14 @@ Return_value prep_for_new_data(Mili_family *fam, int ftype)
                  * by Mili.
                  */
                 fam->cur_st_offset = fam->state_map[fam->file_st_qty - 1].offset;
-                fam->cur_st_offset += sizeof(int) + sizeof(float);
+                fam->cur_st_offset += ST_HEADER_SIZE(fam);
                 if( fam->qty_srecs > 0 )
                 {
                     fam->cur_st_offset += fam->srecs[fam->cur_srec_id]->size;
                 }
 
                 /* Position file pointer (for mc_wrt_st_stream()). */
+                IO_STAT(fam, seeks, 1)
                 rval = seek_state_file(fam->cur_st_file, fam->cur_st_offset);
                 if ( rval != OK )
                 {
@@ -3180,6 +3402,17 @@ void cleanse(Mili_family *fam)
         free(fam->state_map);
     }
 
+    if ( fam->st_file_pool != NULL )
+    {
+        state_file_pool_close(fam);
+        free(fam->st_file_pool);
+        fam->st_file_pool = NULL;
+    }
+
+    io_stats_free(fam);
+
+    unload_open_index(fam);
+
     if ( fam->directory != NULL )
     {
         delete_dir(fam);
@@ -3210,6 +3443,15 @@ void cleanse(Mili_family *fam)
         htable_delete(fam->ti_param_table, NULL, TRUE);
     }
 
+    if ( fam->ti_param_index != NULL )
+    {
+        htable_delete(fam->ti_param_index, NULL, TRUE);
+    }
+
+    delete_ti_label_index(fam);
+
+    close_th_stream(fam);
+
     if ( fam->svar_table != NULL )
     {
         htable_delete(fam->svar_table, delete_svar, TRUE);
@@ -3231,8 +3473,25 @@ void cleanse(Mili_family *fam)
 static Return_value write_header(Mili_family *fam)
 {
     Return_value rval;
+    LONGLONG pos;
     int write_ct;
 
+    /* Re-write in place if the A-file is already open, keeping its position. */
+    if ( fam->cur_index == 0 && fam->cur_file != NULL )
+    {
+        pos = ftell(fam->cur_file);
+        if ( fseek(fam->cur_file, 0, SEEK_SET) != 0 )
+        {
+            return SEEK_FAILED;
+        }
+        write_ct = fwrite((void *)fam->char_header, 1, CHAR_HEADER_SIZE, fam->cur_file);
+        if ( fseek(fam->cur_file, pos, SEEK_SET) != 0 )
+        {
+            return SEEK_FAILED;
+        }
+        return (write_ct != CHAR_HEADER_SIZE) ? SHORT_WRITE : OK;
+    }
+
     /* Open file with read/write access to avoid truncating the A-file. */
     rval = non_state_file_open(fam, 0, 'a');
     if ( rval == OK )
@@ -3277,10 +3536,21 @@ Return_value state_file_open(Mili_family *fam, int index, char mode)
             }
         }
 
-        set_file_access(mode, fam->st_file_count > index, access);
-        /*fam->st_file_count > index, (void *) access );*/
+        if ( fam->access_mode == 'r' && mode == 'r' && fam->st_file_pool_size > 1 )
+        {
+            rval = st_file_pool_open(fam, index, fname);
+        }
+        else
+        {
+            set_file_access(mode, fam->st_file_count > index, access);
+            /*fam->st_file_count > index, (void *) access );*/
 
-        rval = open_buffered(fname, access, &fam->cur_st_file, &fam->cur_st_file_size);
+            rval = open_state_stream(fname, access, &fam->cur_st_file, &fam->cur_st_file_size);
+            if ( rval == OK )
+            {
+                IO_STAT(fam, file_opens, 1)
+            }
+        }
 
         /* Set current file index. */
         if ( rval == OK )
@@ -3297,6 +3567,235 @@ Return_value state_file_open(Mili_family *fam, int index, char mode)
     return rval;
 }
 
+/*****************************************************************
+ * TAG( st_file_size_cached ) LOCAL
+ *
+ * TRUE if the size of a complete state file is cached in the file
+ * map.  The last state file of a family may still be growing, so its
+ * size is never taken from the cache.
+ */
+static Bool_type st_file_size_cached(Mili_family *fam, int index)
+{
+    return (fam->file_map != NULL && index < fam->st_file_count - 1 && fam->file_map[index].file_size > 0);
+}
+
+/*****************************************************************
+ * TAG( st_file_pool_refresh_size ) LOCAL
+ *
+ * Update the size of a pooled state file from its descriptor and,
+ * once the file is no longer the last in the family, cache it in the
+ * file map.  Compressed files are read through a stream with no
+ * descriptor and can't grow, so they keep the size found at open.
+ */
+static void st_file_pool_refresh_size(Mili_family *fam, State_file_handle *p_sfh)
+{
+    struct stat file_stat;
+    int fd;
+
+    fd = fileno(p_sfh->file);
+    if ( fd >= 0 && fstat(fd, &file_stat) == 0 )
+    {
+        p_sfh->size = file_stat.st_size;
+    }
+
+    if ( fam->file_map != NULL && p_sfh->index < fam->st_file_count - 1 )
+    {
+        fam->file_map[p_sfh->index].file_size = p_sfh->size;
+    }
+}
+
+/*****************************************************************
+ * TAG( st_file_pool_open ) LOCAL
+ *
+ * Make a state file of a read-only family current, reusing its
+ * descriptor from the family's state file pool if it is already
+ * open.  Otherwise the file is opened into a free pool slot or in
+ * place of the least recently used descriptor.  Sizes of all but the
+ * last (possibly still growing) state file are cached in the file map
+ * so re-opening them doesn't require a stat().
+ */
+static Return_value st_file_pool_open(Mili_family *fam, int index, char *fname)
+{
+    State_file_handle *p_sfh, *p_slot;
+    Bool_type size_known;
+    Return_value rval;
+    int i;
+
+    if ( fam->st_file_pool == NULL )
+    {
+        fam->st_file_pool = NEW_N(State_file_handle, fam->st_file_pool_size, "State file pool");
+        if ( fam->st_file_pool == NULL )
+        {
+            return ALLOC_FAILED;
+        }
+    }
+
+    fam->st_file_pool_clock++;
+
+    /* Look for the file among the open descriptors, noting the best slot to (re)use. */
+    p_slot = NULL;
+    for ( i = 0; i < fam->st_file_pool_size; i++ )
+    {
+        p_sfh = fam->st_file_pool + i;
+
+        if ( p_sfh->file == NULL )
+        {
+            if ( p_slot == NULL || p_slot->file != NULL )
+            {
+                p_slot = p_sfh;
+            }
+        }
+        else if ( p_sfh->index == index )
+        {
+            IO_STAT(fam, pool_hits, 1)
+            p_sfh->last_use = fam->st_file_pool_clock;
+            if ( !st_file_size_cached(fam, index) )
+            {
+                /* The file may have grown since it was pooled. */
+                st_file_pool_refresh_size(fam, p_sfh);
+            }
+            fam->cur_st_file = p_sfh->file;
+            fam->cur_st_file_size = p_sfh->size;
+            return OK;
+        }
+        else if ( p_slot == NULL || (p_slot->file != NULL && p_sfh->last_use < p_slot->last_use) )
+        {
+            p_slot = p_sfh;
+        }
+    }
+
+    /*
+     * Recycle a descriptor if the pool is full or the process-wide
+     * quantity of pooled files has reached its limit.
+     */
+    if ( p_slot->file == NULL && pooled_st_file_qty >= MAX_POOLED_ST_FILES )
+    {
+        for ( i = 0; i < fam->st_file_pool_size; i++ )
+        {
+            p_sfh = fam->st_file_pool + i;
+            if ( p_sfh->file != NULL && (p_slot->file == NULL || p_sfh->last_use < p_slot->last_use) )
+            {
+                p_slot = p_sfh;
+            }
+        }
+    }
+    IO_STAT(fam, pool_misses, 1)
+    if ( p_slot->file != NULL )
+    {
+        fclose(p_slot->file);
+        IO_STAT(fam, file_closes, 1)
+        p_slot->file = NULL;
+        pooled_st_file_qty--;
+    }
+
+    size_known = st_file_size_cached(fam, index);
+
+    if ( size_known )
+    {
+        p_slot->file = fopen(fname, "rb");
+        if ( p_slot->file == NULL )
+        {
+            /* May only be present in compressed form. */
+            rval = open_state_stream(fname, "rb", &p_slot->file, &p_slot->size);
+        }
+        else
+        {
+            rval = OK;
+        }
+        p_slot->size = fam->file_map[index].file_size;
+    }
+    else
+    {
+        rval = open_state_stream(fname, "rb", &p_slot->file, &p_slot->size);
+        if ( rval == OK && fam->file_map != NULL && index < fam->st_file_count - 1 )
+        {
+            fam->file_map[index].file_size = p_slot->size;
+        }
+    }
+
+    if ( p_slot->file != NULL )
+    {
+        IO_STAT(fam, file_opens, 1)
+        pooled_st_file_qty++;
+        p_slot->index = index;
+        p_slot->last_use = fam->st_file_pool_clock;
+    }
+
+    fam->cur_st_file = p_slot->file;
+    fam->cur_st_file_size = p_slot->size;
+
+    return rval;
+}
+
+/*****************************************************************
+ * TAG( state_file_pool_close ) PRIVATE
+ *
+ * Close all state files held open in the family's state file pool.
+ */
+void state_file_pool_close(Mili_family *fam)
+{
+    State_file_handle *p_sfh;
+    int i;
+
+    if ( fam->st_file_pool == NULL )
+    {
+        return;
+    }
+
+    for ( i = 0; i < fam->st_file_pool_size; i++ )
+    {
+        p_sfh = fam->st_file_pool + i;
+        if ( p_sfh->file != NULL )
+        {
+            if ( p_sfh->file == fam->cur_st_file )
+            {
+                fam->cur_st_file = NULL;
+                fam->cur_st_index = -1;
+                fam->cur_st_file_mode = '\0';
+            }
+            fclose(p_sfh->file);
+            IO_STAT(fam, file_closes, 1)
+            p_sfh->file = NULL;
+            pooled_st_file_qty--;
+        }
+    }
+}
+
+/*****************************************************************
+ * TAG( mc_set_state_file_pool ) PUBLIC
+ *
+ * Set the quantity of state files a read-only family may keep open
+ * at once.  A quantity of one disables pooling.
+ */
+Return_value mc_set_state_file_pool(Famid fam_id, int file_qty)
+{
+    Mili_family *fam;
+    Return_value rval;
+
+    rval = validate_fam_id(fam_id);
+    if ( rval != OK )
+    {
+        return rval;
+    }
+
+    if ( file_qty < 1 )
+    {
+        return INVALID_INDEX;
+    }
+
+    fam = fam_list[fam_id];
+
+    if ( fam->st_file_pool != NULL )
+    {
+        state_file_pool_close(fam);
+        free(fam->st_file_pool);
+        fam->st_file_pool = NULL;
+    }
+    fam->st_file_pool_size = file_qty;
+
+    return OK;
+}
+
 Return_value state_map_file_open(Mili_family *fam, char mode)
 {
     Return_value rval = OK;
@@ -3323,6 +3822,11 @@ Return_value non_state_file_open(Mili_family *fam, int index, char mode)
 
     rval = OK;
 
+    if ( fam->open_index != NULL )
+    {
+        return open_index_file_open(fam, index);
+    }
+
     if ( fam->cur_index != index )
     {
         fcnt = fam->file_count;
@@ -3443,6 +3947,11 @@ Return_value non_state_file_seek(Mili_family *fam, LONGLONG offset)
 {
     int stat;
 
+    if ( fam->open_index != NULL )
+    {
+        return open_index_seek(fam, offset);
+    }
+
     /*    if ( offset >= fam->cur_file_size ) */
     if ( offset >= fam->next_free_byte )
     {
@@ -3519,10 +4028,20 @@ Return_value state_file_close(Mili_family *fam)
         return OK;
     }
 
+    /* Pooled files stay open for reuse; just release the current one. */
+    if ( fam->st_file_pool != NULL && fam->access_mode == 'r' )
+    {
+        fam->cur_st_file = NULL;
+        fam->cur_st_index = -1;
+        fam->cur_st_file_mode = '\0';
+        return OK;
+    }
+
     if ( fclose(fam->cur_st_file) != 0 )
     {
         rval = UNABLE_TO_CLOSE_FILE;
     }
+    IO_STAT(fam, file_closes, 1)
     fam->cur_st_file = 0;
     if ( rval != OK )
     {
@@ -4075,6 +4594,15 @@ int mc_htable_search_wildcard(int fid, int list_len, Bool_type allow_duplicates,
     int old_ti_file = 0;
     pos = 0;
     fam = fam_list[fid];
+
+    /*
+     * TI parameters are filtered from the list below, so deferred ones
+     * only need loading when they live in a separate table.
+     */
+    if ( fam->char_header[DIR_VERSION_IDX] == 1 )
+    {
+        load_ti_params(fam);
+    }
     if ( (fam->db_type != TAURUS_DB_TYPE) && fam->char_header[DIR_VERSION_IDX] == 1 && fam->ti_enable )
     {
         table = fam->ti_param_table;
@@ -4142,6 +4670,7 @@ int mc_ti_htable_search_wildcard(int fid, int list_len, Bool_type allow_duplicat
     int old_ti_file = 0;
 
     fam = fam_list[fid];
+    load_ti_params(fam);
     if ( (!fam->db_type == TAURUS_DB_TYPE) && fam->char_header[DIR_VERSION_IDX] == 1 && fam->ti_enable )
     {
         table = fam->ti_param_table;
@@ -4165,7 +4694,8 @@ int mc_ti_htable_search_wildcard(int fid, int list_len, Bool_type allow_duplicat
         */
         for ( i = 0; i < count; i++ )
         {
-            if ( !old_ti_file && is_correct_param_type(fid, temp_list[i], TI_PARAM) )
+            /* A separate TI table holds only TI parameters. */
+            if ( old_ti_file || is_correct_param_type(fid, temp_list[i], TI_PARAM) )
             {
                 if ( return_list != NULL )
                 {
@@ -4174,14 +4704,6 @@ int mc_ti_htable_search_wildcard(int fid, int list_len, Bool_type allow_duplicat
                 }
                 pos++;
             }
-            else
-            {
-                if ( return_list != NULL )
-                {
-                    str_dup(&return_list[pos], temp_list[i]);
-                    // strcpy(return_list[pos] ,temp_list[i]);
-                }
-            }
         }
         free(temp_list);
         count = pos;
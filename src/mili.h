@@ -141,6 +141,24 @@ typedef enum
 #define M_LIST_OBJ_FMT (1)
 #define M_BLOCK_OBJ_FMT (2)
 
+/*
+ * State file compression codecs.
+ */
+#define M_CODEC_NONE (0)
+#define M_CODEC_RLE (1)  /* Byte shuffle + run-length, always available */
+#define M_CODEC_ZLIB (2) /* Byte shuffle + zlib, if built with zlib */
+
+/*
+ * Functions timed by family I/O statistics.
+ */
+#define M_STAT_OPEN (0)
+#define M_STAT_READ_RESULTS (1)
+#define M_STAT_NEW_STATE (2)
+#define M_STAT_END_STATE (3)
+#define M_STAT_FLUSH (4)
+#define M_STAT_FUNC_QTY (5)
+#define M_STAT_BUCKETS (24) /* Latency histogram buckets */
+
 /*
  * Miscellaneous limits
  */
@@ -195,6 +213,63 @@ typedef struct _subrecord
     int *surface_variable_flag;
 } Subrecord;
 
+/* Named parameter for batched parameter writes. */
+typedef struct _named_param
+{
+    char *name;
+    int type;        /* Data type, M_STRING for a string */
+    int order;       /* Number of array dimensions, 0 for a scalar or string */
+    int *dimensions; /* Size of each dimension */
+    void *data;      /* Scalar, array or string data */
+} Named_param;
+
+/* Subrecord data for batched state writes. */
+typedef struct _subrec_write
+{
+    char *subrec_name; /* NULL to use handle */
+    int handle;        /* Subrecord handle from mc_get_subrec_handle() */
+    int start;         /* First lump (state vector or result array) index */
+    int stop;          /* Last lump index */
+    void *data;        /* Data (a sequence of lumps) to be written */
+} Subrec_write;
+
+/* One rank's lumps of a subrecord in a shared (N-to-1) state record. */
+typedef struct _shared_span
+{
+    char *subrec_name; /* Subrecord identifier */
+    int start;         /* First lump (state vector or result array) index */
+    int stop;          /* Last lump index */
+    LONGLONG offset;   /* (output) Byte offset from the state record start */
+    LONGLONG size;     /* (output) Byte length of the lumps */
+    int type;          /* (output) Data type of the lumps */
+} Shared_span;
+
+/* Latency of one timed function. */
+typedef struct _io_latency
+{
+    LONGLONG calls;
+    double total_time;                /* Seconds */
+    double max_time;                  /* Seconds */
+    LONGLONG buckets[M_STAT_BUCKETS]; /* Calls under 2^i microseconds, the last bucket the rest */
+} Io_latency;
+
+/* I/O statistics of a family. */
+typedef struct _io_stats
+{
+    LONGLONG read_calls;  /* State data reads */
+    LONGLONG read_bytes;
+    LONGLONG write_calls; /* State data writes */
+    LONGLONG write_bytes;
+    LONGLONG seeks;       /* State file seeks */
+    LONGLONG file_opens;  /* State file opens */
+    LONGLONG file_closes;
+    LONGLONG pool_hits;   /* Read opens served by the state file pool */
+    LONGLONG pool_misses;
+    LONGLONG fsyncs;
+    double wall_time;     /* Seconds since statistics were enabled or reset */
+    Io_latency latency[M_STAT_FUNC_QTY];
+} Io_stats;
+
 /*
  * *                                      * *
  * *   File family management routines.   * *
@@ -280,6 +355,11 @@ Return_value mc_read_string(              /* Read a named string from the file f
                             char *name,   /* Label of string */
                             char *value); /* String data */
 
+Return_value mc_wrt_params(                  /* Write a set of named params to the file family */
+                           Famid fam_id,     /* Mili family identifier */
+                           int qty,          /* Number of params */
+                           Named_param *params); /* The params */
+
 int mc_get_next_famid(/* Returns the next available file id number */
                       void);
 
@@ -325,6 +405,11 @@ Return_value mc_ti_wrt_array(                 /* Write a named array to the file
                              int *dimensions, /* Size of each dimension */
                              void *data);     /* Array data */
 
+Return_value mc_ti_wrt_params(                  /* Write a set of named params to the file family */
+                              Famid fam_id,     /* Mili family identifier */
+                              int qty,          /* Number of params */
+                              Named_param *params); /* The params */
+
 Return_value mc_ti_read_array(                 /* Read a named param array from the file family */
                               Famid fam_id,    /* Mili family identifier */
                               char *name,      /* Label of param */
@@ -445,6 +530,14 @@ Return_value mc_get_class_idents(Famid fam_id,     /* Mili family identifier */
                                  int *num_blocks,  /* Number of block created */
                                  int **idents);    /* Array to be filled.*/
 
+Return_value mc_get_class_id_block(                  /* Find the block of object ids holding an id */
+                                   Famid fam_id,     /* Mili family identifier */
+                                   int mesh_id,      /* Ident of mesh that objects belong to */
+                                   char *class_name, /* Name of class to which objects belong */
+                                   int id,           /* Object id to look up */
+                                   int *start,       /* (output) First id of the block */
+                                   int *stop);       /* (output) Last id of the block */
+
 Return_value mc_def_class_idents(                  /* Define object identifiers for a class */
                                  Famid fam_id,     /* Mili family identifier */
                                  int mesh_id,      /* Ident of mesh that objects belong to */
@@ -572,6 +665,22 @@ Return_value mc_load_conn_labels(                   /* Read element labels into
                                  int *element_ids,  /* List of local element numbers for each label */
                                  int *labels);      /* (output) Destination buffer for element labels */
 
+Return_value mc_labels_to_local_ids(                  /* Resolve object labels to local ids. */
+                                    Famid fam_id,     /* Mili family identifier */
+                                    int mesh_id,      /* Ident of mesh that objects belong to */
+                                    char *short_name, /* Name of class the objects belong to */
+                                    int qty,          /* Number of labels to resolve */
+                                    int *labels,      /* Object labels */
+                                    int *local_ids);  /* (output) Local ids, 0 if no such label */
+
+Return_value mc_local_ids_to_labels(                  /* Map local object ids to labels. */
+                                    Famid fam_id,     /* Mili family identifier */
+                                    int mesh_id,      /* Ident of mesh that objects belong to */
+                                    char *short_name, /* Name of class the objects belong to */
+                                    int qty,          /* Number of ids to map */
+                                    int *local_ids,   /* Local object ids */
+                                    int *labels);     /* (output) Labels, 0 if no such id */
+
 Return_value mc_reload_states(Famid famid);
 
 Return_value
@@ -760,6 +869,55 @@ Return_value mc_wrt_subrec(                       /* Write an indexed subset of
                            int start,             /* First lump (state vector or result array) index */
                            int stop,              /* Last lump (state vector or result array) index */
                            void *data);           /* Data (a sequence of lumps) to be written */
+Return_value mc_get_subrec_handle(                  /* Resolve a subrecord once for repeated writes */
+                                  Famid fam_id,      /* Mili family identifier */
+                                  char *subrec_name, /* Subrecord identifier */
+                                  int *p_handle);    /* Handle for mc_wrt_subrec_h() */
+Return_value mc_wrt_subrec_h(                     /* Write an indexed subset of a subrecord's data */
+                             Famid fam_id,        /* Mili family identifier */
+                             int handle,          /* Subrecord handle */
+                             int start,           /* First lump (state vector or result array) index */
+                             int stop,            /* Last lump (state vector or result array) index */
+                             void *data);         /* Data (a sequence of lumps) to be written */
+Return_value mc_get_subrec_extent(                  /* Locate a subrecord in the current state */
+                                  Famid fam_id,      /* Mili family identifier */
+                                  char *subrec_name, /* Subrecord identifier */
+                                  LONGLONG *p_offset, /* State file offset of the subrecord */
+                                  LONGLONG *p_size);  /* Bytes reserved, including padding */
+Return_value mc_map_shared_spans(                 /* Place ranks' lumps in a shared state record */
+                                 Famid fam_id,    /* Mili family identifier */
+                                 int srec_id,     /* State record format */
+                                 int qty,         /* Number of spans */
+                                 Shared_span *spans); /* Spans of all ranks */
+Return_value mc_get_shared_state(                       /* Locate the current state record */
+                                 Famid fam_id,          /* Mili family identifier */
+                                 char *state_file_name, /* (output) State file, M_MAX_NAME_LEN chars */
+                                 LONGLONG *p_offset);   /* (output) Offset of the state record */
+Return_value mc_wrt_shared_span(                    /* Write one span into the current state */
+                                Famid fam_id,       /* Mili family identifier */
+                                Shared_span *span,  /* Span from mc_map_shared_spans() */
+                                void *data);        /* Data (a sequence of lumps) to be written */
+Return_value mc_wrt_subrecs(                      /* Write data for a set of subrecords */
+                            Famid fam_id,         /* Mili family identifier */
+                            int qty,              /* Number of subrecord writes */
+                            Subrec_write *writes); /* The subrecord writes */
+
+Return_value mc_open_th(                          /* Begin a transposed time-history stream */
+                        Famid fam_id,             /* Mili family identifier */
+                        int chunk_states,         /* States per chunk, 0 for the default */
+                        int qty,                  /* Number of subrecords */
+                        char **subrec_names);     /* Object-ordered subrecords to hold */
+Return_value mc_get_th_states(                    /* Range of states in the time-history stream */
+                              Famid fam_id,       /* Mili family identifier */
+                              int *p_first_state, /* First state held */
+                              int *p_last_state); /* Last state held */
+Return_value mc_read_th(                          /* Read one object's history from the stream */
+                        Famid fam_id,             /* Mili family identifier */
+                        char *subrec_name,        /* Subrecord identifier */
+                        int object,               /* Object order number in the subrecord */
+                        int first_state,          /* First state to read */
+                        int last_state,           /* Last state to read */
+                        void *data);              /* One lump per state */
 
 Return_value mc_read_results(                /* Read state variables into result-ordered arrays */
                              Famid fam_id,   /* Mili family identifier */
@@ -810,6 +968,29 @@ Return_value mc_limit_filesize(                    /* Set quantity of states per
 Return_value mc_suffix_width(                   /* Set suffix width for state-data filenames */
                              Famid fam_id,      /* Mili family identifier */
                              int suffix_width); /* Min numeric suffix width for state-file names */
+Return_value mc_set_state_file_pool(               /* Set qty of state files kept open for reading */
+                                    Famid fam_id,  /* Mili family identifier */
+                                    int file_qty); /* Max qty of concurrently open state files */
+Return_value mc_set_open_index(                          /* Write an open-time index at close */
+                               Famid fam_id,            /* Mili family identifier */
+                               Bool_type write_index); /* TRUE to write the index */
+Return_value mc_set_state_alignment(           /* Align state records and subrecords */
+                                    Famid fam_id, /* Mili family identifier */
+                                    int alignment); /* Alignment in bytes, a power of two */
+Return_value mc_set_state_compression(         /* Compress state files at close */
+                                      Famid fam_id, /* Mili family identifier */
+                                      int codec);   /* M_CODEC_NONE, M_CODEC_RLE or M_CODEC_ZLIB */
+Return_value mc_set_io_stats(                /* Collect I/O statistics for a family */
+                             Famid fam_id,  /* Mili family identifier */
+                             Bool_type on); /* TRUE to collect, clearing prior statistics */
+Return_value mc_reset_io_stats(               /* Clear collected I/O statistics */
+                               Famid fam_id); /* Mili family identifier */
+Return_value mc_get_io_stats(                    /* Copy out collected I/O statistics */
+                             Famid fam_id,      /* Mili family identifier */
+                             Io_stats *p_stats); /* (output) Destination for statistics */
+Return_value mc_io_stats_json(                  /* Collected I/O statistics as JSON */
+                              Famid fam_id,    /* Mili family identifier */
+                              char **p_json);  /* (output) JSON string, caller must free() */
 Return_value mc_set_subrec_check(Famid fam_id, Bool_type check);
 Return_value mc_check_subrec_start(Famid fam_id, int srec_id);
 void mc_print_error(                   /* Print diagnostic message for error return */
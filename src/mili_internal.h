@@ -59,6 +59,9 @@
  */
 #define QTY_PD_ENTRY_TYPES (7)
 #define WRITE_LOCK (3) /* must be unique wrt STATE_DATA, NON_STATE_DATA */
+#define OPEN_INDEX (4) /* must be unique wrt STATE_DATA, NON_STATE_DATA */
+#define TIME_HISTORY (5) /* must be unique wrt STATE_DATA, NON_STATE_DATA */
+#define QTY_NODE_TAGS (2)
 /* conn_words[] in file mesh_u.c */
 
 #define INVALID_FAM_ID(fid) (fid < 0 || fid >= fam_array_length || fam_list[fid] == NULL)
@@ -67,10 +70,30 @@
         if ( (fam)->access_mode == 'r' ) \
             return BAD_ACCESS_TYPE;      \
     }
+/* Count state file I/O of a family collecting statistics. */
+#define IO_STAT(f, field, n)               \
+    {                                      \
+        if ( (f)->io_stats != NULL )       \
+            (f)->io_stats->field += (n);   \
+    }
+#define IO_STAT_XFER(f, dir, type, qty)                                       \
+    {                                                                      \
+        if ( (f)->io_stats != NULL )                                       \
+        {                                                                  \
+            (f)->io_stats->dir##_calls++;                                  \
+            (f)->io_stats->dir##_bytes += (LONGLONG)(qty) * EXT_SIZE(f, type); \
+        }                                                                  \
+    }
 #define ST_FILE_SUFFIX(f, i) ((i) + (f)->st_file_index_offset)
 #define LOCK_FILE_SIZE (128)
 #define MAX_LOCK_TRIES (100)
 #define EXT_SIZE(f, t) (f->external_size[t])
+/* Round a state file offset up to the family's state alignment. */
+#define ST_ALIGN(f, n)                                                                                        \
+    ((f)->state_align > 1 ? ((LONGLONG)(n) + (f)->state_align - 1) / (f)->state_align * (f)->state_align \
+                          : (LONGLONG)(n))
+/* Bytes from a state record's start to its first subrecord (time, srec id, padding). */
+#define ST_HEADER_SIZE(f) ST_ALIGN(f, EXT_SIZE(f, M_INT) + EXT_SIZE(f, M_FLOAT))
 #define DEFAULT_SUFFIX_WIDTH (2)
 #define DONT_CARE (0)
 #define DEFAULT_PARTITION_SCHEME STATE_COUNT
@@ -85,6 +108,8 @@
         for ( ; *(s)++ && (s) < (l); ) \
             ;                          \
     }
+#define DEFAULT_ST_FILE_POOL_SIZE (16)
+#define MAX_POOLED_ST_FILES (256)
 #define DEFAULT_HASH_TABLE_SIZE (5009)
 #define SMALL_HASH_TABLE_SIZE (551)
 
@@ -117,12 +142,52 @@ typedef struct _state_descriptor
 typedef struct _state_file_descriptor
 {
     int state_qty;
+    LONGLONG file_size; /* Cached byte size of a complete file, 0 if unknown */
 } State_file_descriptor;
 
+typedef struct _state_file_handle
+{
+    FILE *file;
+    int index;
+    LONGLONG size;
+    LONGLONG last_use;
+} State_file_handle;
+
+typedef struct _open_index_extent
+{
+    LONGLONG file;
+    LONGLONG offset;
+    LONGLONG length;
+    char *data;
+} Open_index_extent;
+
+typedef struct _open_index
+{
+    char *buffer;
+    int file_count;
+    LONGLONG commit_count;
+    LONGLONG *file_sizes;
+    int extent_qty;
+    Open_index_extent *extents; /* Sorted by file, then offset */
+    int cur_extent;             /* Extent read through cur_file, -1 if none */
+} Open_index;
+
+typedef struct _ti_label_class
+{
+    int qty_conn_labels;
+    char **conn_labels; /* "Element Labels[...]" parameter names */
+    char *node_labels;  /* First "Node Labels[...]" parameter name */
+} Ti_label_class;
+
+typedef struct _ti_label_index
+{
+    Hash_table *classes;     /* Ti_label_class entries keyed by short name */
+    Ti_label_class particle; /* Element labels of all "ml..." classes */
+    char conn_id_prefix[32]; /* Name prefix of the element id arrays */
+} Ti_label_index;
+
 typedef struct _int_range
 {
-    struct _int_range *next;
-    struct _int_range *prev;
     int start;
     int stop;
 } Int_range;
@@ -131,7 +196,8 @@ typedef struct _block_list
 {
     int object_qty;
     int block_qty;
-    Int_range *blocks;
+    int block_capacity;
+    Int_range *blocks; /* Disjoint, non-adjacent ranges in ascending order */
 } Block_list;
 
 typedef struct _io_mem_buffer
@@ -146,6 +212,7 @@ typedef struct _io_mem_buffer
 typedef struct _io_mem_store
 {
     IO_mem_buffer **data_buffers;
+    LONGLONG buffer_capacity; /* Allocated length of data_buffers */
     int type;
     LONGLONG current_index;
     LONGLONG current_output_index;
@@ -165,6 +232,8 @@ typedef struct _file_dir
     int qty_names;
     char **names;
     IO_mem_store *name_data;
+    int entry_capacity; /* Allocated length of dir_entries */
+    int name_capacity;  /* Allocated length of names */
 } File_dir;
 
 typedef struct _param_ref
@@ -242,6 +311,12 @@ typedef struct _sub_srec
     int *qty_per_proc;
 } Sub_srec;
 
+typedef struct _subrec_ref
+{
+    Sub_srec *psubrec; /* Resolved subrecord */
+    int superclass;    /* Superclass of the subrecord's class */
+} Subrec_ref;
+
 typedef struct _srec
 {
     int qty_subrecs;
@@ -250,6 +325,44 @@ typedef struct _srec
     Db_object_status status;
 } Srec;
 
+typedef struct _th_subrec
+{
+    char *name;
+    Sub_srec *psubrec;  /* NULL when reading */
+    int obj_qty;
+    LONGLONG lump_size; /* Bytes per object per state */
+    LONGLONG offset;    /* Offset within one state's data */
+} Th_subrec;
+
+typedef struct _th_stream
+{
+    FILE *file;
+    Bool_type writing;
+    int chunk_states; /* States per chunk */
+    int first_state;  /* Family state number of the first state held */
+    int state_qty;    /* States held, including those in chunk_buf */
+    int qty_subrecs;
+    Th_subrec *subrecs;
+    LONGLONG header_size;
+    LONGLONG state_size; /* Bytes of one state across all subrecords */
+    LONGLONG st_offset;  /* State offset of the state being captured */
+    Bool_type state_open;
+    unsigned char *state_buf; /* Data captured for the open state */
+    unsigned char *chunk_buf; /* Transposed data of the last, unwritten chunk */
+} Th_stream;
+
+typedef struct _label_map
+{
+    int qty;            /* Number of labelled objects */
+    int min_label;
+    int max_label;
+    int *direct;        /* Local id by label - min_label (0 if unused), NULL if sparse */
+    int *sorted_labels; /* Ascending labels if sparse, NULL if direct */
+    int *sorted_ids;    /* Local ids of sorted_labels */
+    int id_qty;
+    int *labels; /* Label by local id - 1 (0 if unused) */
+} Label_map;
+
 typedef struct _mesh_object_class_data
 {
     char *long_name;
@@ -257,6 +370,7 @@ typedef struct _mesh_object_class_data
     int superclass;
     int *surface_sizes;
     Block_list *blocks;
+    Label_map *label_map; /* Built on first label lookup */
 } Mesh_object_class_data;
 
 typedef struct _mesh_descriptor
@@ -391,6 +505,8 @@ typedef struct _mili_family
     int visit_file_on;
     JSON_Value *root_value;
     JSON_Object *root_object;
+    long visit_times_end; /* .mili offset after the last state time, 0 if unknown */
+    int visit_times_qty;  /* State times in the .mili file */
     Database_type db_type;
     int lock_file_descriptor;
     int st_suffix_width;
@@ -404,6 +520,7 @@ typedef struct _mili_family
     File_partition_scheme partition_scheme;
     int states_per_file;
     LONGLONG bytes_per_file_limit;
+    int state_align; /* State record and subrecord alignment, 0 if packed */
     Bool_type active_family;
     /* Total states written (initialized!) this open */
     int written_st_qty;
@@ -422,7 +539,16 @@ typedef struct _mili_family
     int st_file_count; /* Count includes partial file in active db. */
     int st_file_index_offset;
     LONGLONG cur_st_offset;
+    /* Open read-only state files, reused least recently used first */
+    State_file_handle *st_file_pool;
+    int st_file_pool_size;
+    LONGLONG st_file_pool_clock;
     int file_st_qty;
+    /* Taurus plot file sizes and the last whole state record read */
+    LONGLONG *taurus_file_sizes;
+    char *taurus_st_buf;
+    LONGLONG taurus_st_buf_size;
+    int taurus_st_buf_state;
     int cur_srec_id;
     int state_qty;
     short state_closed;
@@ -436,8 +562,17 @@ typedef struct _mili_family
     State_descriptor *state_map;
     /* Directory data */
     File_dir *directory;
+    /* Open-time index, held only while the family is being opened */
+    Open_index *open_index;
+    Bool_type write_open_index;
+    /* Transposed time-history output */
+    Th_stream *th_stream;
+    /* Codec applied to the state files at close */
+    int state_codec;
     /* Parameter data */
     Hash_table *param_table;
+    Bool_type ti_params_deferred; /* TI parameters not yet in a param table */
+    Hash_table *ti_param_index;   /* Deferred TI parameter entries by name */
     /* Mesh data */
     Mesh_type mesh_type;
     int dimensions;
@@ -455,7 +590,13 @@ typedef struct _mili_family
     int *svar_hdr;
     /* Subrecord table */
     Hash_table *subrec_table;
+    Subrec_ref *subrec_refs; /* Subrecords resolved for handle-based writes */
+    int qty_subrec_refs;
     Bool_type subrec_start_check;
+    Bool_type shared_spans; /* State records are filled by mc_wrt_shared_span() */
+    /* I/O statistics, NULL unless collecting */
+    Io_stats *io_stats;
+    double io_stats_start;
     /* I/O routines for this family */
     /* For access by datatype. */
     LONGLONG (*read_funcs[QTY_PD_ENTRY_TYPES + 1])(FILE *file, void *data, LONGLONG qty);
@@ -474,6 +615,7 @@ typedef struct _mili_family
 
     /* Parameter data */
     Hash_table *ti_param_table;
+    Ti_label_index *ti_label_index; /* Built on first label load */
 
     /* Various TI state flags */
     Bool_type ti_enable;
@@ -534,6 +676,7 @@ Return_value non_state_file_seek(Mili_family *fam, LONGLONG offset);
 Return_value non_state_file_close(Mili_family *fam);
 Return_value state_file_open(Mili_family *fam, int index, char mode);
 Return_value state_file_close(Mili_family *fam);
+void state_file_pool_close(Mili_family *fam);
 void set_file_access(char, Bool_type, char *);
 Return_value seek_state_file(FILE *cur_st_file, LONGLONG offset);
 Return_value open_buffered(char *fname, char *mode, FILE **p_file_descr, LONGLONG *p_size);
@@ -575,20 +718,59 @@ void delete_ti_dir(Mili_family *fam);
 Return_value add_ti_dir_entry(Mili_family *fam, Dir_entry_type etype, int modifier1, int modifier2, int string_qty,
                               char **strings, LONGLONG offset, LONGLONG length);
 Return_value load_ti_directories(Mili_family *fam);
+Ti_label_class *find_ti_label_class(Mili_family *fam, char *short_name);
+Ti_label_class *find_ti_particle_labels(Mili_family *fam);
+char *ti_conn_id_prefix(Mili_family *fam);
+void delete_ti_label_index(Mili_family *fam);
 
 /* direc.c - directory management routines. */
 Return_value add_dir_entry(Mili_family *fam, Dir_entry_type etype, int modifier1, int modifier2, int string_qty,
                            char **strings, LONGLONG offset, LONGLONG length);
+Return_value add_dir_entries(Mili_family *fam, int qty, Dir_entry *entries, char **strings);
+Return_value reserve_dir_space(File_dir *p_fd, int entry_qty, int name_qty);
 Return_value commit_dir(Mili_family *fam);
 void delete_dir(Mili_family *fam);
 Return_value load_directories(Mili_family *fam);
+Return_value load_ti_param(Mili_family *fam, char *name, Bool_type *found);
+Return_value load_ti_params(Mili_family *fam);
+Hash_table *ti_param_htable(Mili_family *fam);
+
+/* open_index.c - open-time index sidecar routines. */
+Return_value write_open_index(Mili_family *fam);
+Return_value load_open_index(Mili_family *fam);
+void unload_open_index(Mili_family *fam);
+Return_value open_index_file_open(Mili_family *fam, int index);
+Return_value open_index_seek(Mili_family *fam, LONGLONG offset);
+FILE *open_index_dir_stream(Open_index *idx, int index);
+
+/* time_history.c - transposed time-history stream routines. */
+Return_value th_new_state(Mili_family *fam);
+Return_value th_end_state(Mili_family *fam);
+void th_capture(Mili_family *fam, Sub_srec *psubrec, int start, LONGLONG bytes, void *data);
+Return_value close_th_stream(Mili_family *fam);
+Return_value th_truncate(Mili_family *fam, int state_qty);
+
+/* state_zip.c - compressed state file routines. */
+Bool_type state_codec_available(int codec);
+Return_value compress_state_files(Mili_family *fam);
+Return_value expand_state_files(Mili_family *fam);
+Return_value open_state_stream(char *fname, char *mode, FILE **p_file_descr, LONGLONG *p_size);
+
+/* io_stats.c - runtime I/O statistics routines. */
+double io_stats_now(void);
+Return_value io_stats_enable(Mili_family *fam);
+void io_stats_free(Mili_family *fam);
+double io_stats_clock(Famid fam_id);
+void io_stats_time(Famid fam_id, int func, double start);
 
 /* param.c - parameter management routines. */
+Return_value param_table_search(Mili_family *fam, char *name, Hash_action op, Htable_entry **pp_hte);
 Return_value read_scalar(Mili_family *fam, Param_ref *p_pr, void *p_value);
 Return_value mili_read_string(Mili_family *fam, Param_ref *p_pr, char *p_value);
 Return_value write_string(Mili_family *fam, char *name, char *value, Dir_entry_type etype);
 Return_value write_array(Mili_family *fam, int type, char *name, int order, int *dimensions, void *data,
                          Dir_entry_type etype);
+Return_value write_params(Mili_family *fam, int qty, Named_param *params, Dir_entry_type etype);
 Return_value read_param_array(Mili_family *fam, Param_ref *p_pr, void **p_data);
 Return_value write_scalar(Mili_family *fam, int type, char *name, void *data, Dir_entry_type etype);
 Return_value dump_param(Mili_family *fam, FILE *p_f, Dir_entry dir_ent, char **dir_strings, Dump_control *p_dc,
@@ -607,6 +789,7 @@ void *my_realloc(void *ptr, long size, long add, char *descr);
 void *mili_recalloc(void *ptr, long size, long add, char *descr);
 void *get_write_func(Mili_family *fam, int type);
 int is_numeric(char *ptest);
+int is_zip_suffix(char *ptest);
 int is_all_upper(char *ptest);
 Buffer_queue *create_buffer_queue(int buf_qty, long length);
 Return_value init_buffer_queue(Buffer_queue *p_bq, int buf_qty, long length);
@@ -643,6 +826,7 @@ Return_value load_srec_formats(Mili_family *fam);
 Return_value build_state_map(Mili_family *fam, Bool_type initial_build);
 Return_value dump_state_rec_data(Mili_family *fam, FILE *p_f, Dir_entry dir_ent, char **dir_strings, Dump_control *p_dc,
                                  int head_indent, int body_indent);
+int svar_atoms(Svar *p_svar);
 
 /* mesh_u.c - routines for managing unstructured mesh geometry. */
 Return_value create_class_data(int superclass, char *short_name, char *long_name, Mesh_object_class_data **pp_mocd);
@@ -650,6 +834,8 @@ Return_value check_object_ids(Block_list *obj_group, int qty_id_blks, int *obj_i
 void delete_meshes(Mili_family *fam);
 void delete_mo_data(void *ptr_mo_data);
 Return_value insert_range(Block_list *p_bl, int start, int stop);
+int find_range(Block_list *p_bl, int id);
+void delete_block_list(Block_list *p_bl);
 Return_value get_class_qty(Mili_family *fam, int *modifiers, int *class_qty);
 void get_elem_conn_classes_names(Mili_family *fam, int mesh_id, int *count, char ***out_names);
 int count_elem_conn_defs(Mili_family *fam, int mesh_id, char *class_name);
@@ -686,6 +872,7 @@ Return_value mc_get_class_info_by_index(Mili_family *in, int *mesh_id, int *inde
 /* mili_statemap.c - routines */
 Return_value load_static_maps(Mili_family *, Bool_type, Bool_type);
 Return_value rebuild_state_tfile(Mili_family *);
+Return_value truncate_file(char *fname, LONGLONG length);
 /* read_db.c - routines for managing mesh object structs */
 void mili_delete_mo_class_data(void *p_data);
 
@@ -65,24 +65,54 @@ static void delete_tfile(Mili_family *fam)
     return;
 }
 
+/*****************************************************************
+ * TAG( truncate_file ) PRIVATE
+ *
+ * Cut a file down to "length" bytes.
+ */
+Return_value truncate_file(char *fname, LONGLONG length)
+{
+    int status;
+#ifdef _MSC_VER
+    FILE *fp;
+
+    fp = fopen(fname, "r+b");
+    if ( fp == NULL )
+    {
+        return FAMILY_TRUNCATION_FAILED;
+    }
+    status = _chsize_s(_fileno(fp), length);
+    fclose(fp);
+#else
+    status = truncate(fname, (off_t)length);
+#endif
+
+    return (status == 0) ? OK : FAMILY_TRUNCATION_FAILED;
+}
+
 /*****************************************************************
  * TAG( truncate_family ) LOCAL
  *
  * Prune from a family all states and files including and following
  * the state indicated by "st_index".
+ *
+ * Everything needed is in the state and file maps, so no state data
+ * is read: later state files are unlinked, the file holding the
+ * first pruned state is cut at that state and the tail of the state
+ * map on disk is dropped.  The cost depends on the number of files
+ * removed, not on the number of states in the family.
  */
 static Return_value truncate_family(Mili_family *p_fam, int st_index)
 {
     char fname[M_MAX_NAME_LEN];
     Return_value rval = OK;
-    int status = 0;
     int file_qty = 0;
-    int state_qty = 0;
+    int first_file_state = 0;
     int i = 0;
-    long offset = 0;
+    LONGLONG offset = 0;
     int header[QTY_DIR_HEADER_FIELDS];
     int num_items = -1;
-    char check = ' ';
+    Bool_type use_tfile;
     FILE *fp = NULL;
 
     if ( p_fam->state_qty == st_index )
@@ -94,11 +124,11 @@ static Return_value truncate_family(Mili_family *p_fam, int st_index)
         return INVALID_FILE_STATE_INDEX;
     }
 
+    file_qty = p_fam->state_map[st_index].file;
     offset = p_fam->state_map[st_index].offset;
-    state_qty = p_fam->state_qty;
 
     /* Make sure any file that will be affected is closed. */
-    if ( p_fam->cur_st_index >= p_fam->state_map[st_index].file )
+    if ( p_fam->cur_st_index >= file_qty )
     {
         rval = state_file_close(p_fam);
         if ( rval != OK )
@@ -106,221 +136,177 @@ static Return_value truncate_family(Mili_family *p_fam, int st_index)
             return rval;
         }
     }
+    state_file_pool_close(p_fam);
 
-    /* Get quantity of state files remaining after truncation. */
-    file_qty = p_fam->state_map[st_index].file;
-
+    /* Remove the files following the one holding the first pruned state. */
     for ( i = p_fam->st_file_count - 1; i > file_qty; i-- )
     {
         make_fnam(STATE_DATA, p_fam, ST_FILE_SUFFIX(p_fam, i), fname);
-        status = unlink(fname);
-        if ( status != 0 )
+        if ( unlink(fname) != 0 )
         {
-            rval = FAMILY_TRUNCATION_FAILED;
-            break;
+            p_fam->st_file_count = i + 1;
+            return FAMILY_TRUNCATION_FAILED;
         }
     }
 
-    p_fam->st_file_count = i + 1;
-
-    if ( p_fam->state_map[st_index].file == 0 && st_index == 0 )
+    /* Cut that file at the pruned state, or remove it if nothing precedes it. */
+    make_fnam(STATE_DATA, p_fam, ST_FILE_SUFFIX(p_fam, file_qty), fname);
+    if ( offset == 0 )
     {
-        make_fnam(STATE_DATA, p_fam, ST_FILE_SUFFIX(p_fam, 0), fname);
-        status = unlink(fname);
-        if ( status != 0 )
+        if ( unlink(fname) != 0 )
         {
+            p_fam->st_file_count = file_qty + 1;
             return FAMILY_TRUNCATION_FAILED;
         }
+        p_fam->st_file_count = file_qty;
     }
-    else if ( p_fam->state_map[st_index].offset == 0 )
+    else
     {
-        make_fnam(STATE_DATA, p_fam, ST_FILE_SUFFIX(p_fam, p_fam->state_map[st_index].file), fname);
-        status = unlink(fname);
-        if ( status != 0 )
+        rval = truncate_file(fname, offset);
+        if ( rval != OK )
         {
-            return FAMILY_TRUNCATION_FAILED;
+            p_fam->st_file_count = file_qty + 1;
+            return rval;
         }
-        p_fam->st_file_count -= 1;
-    }
-    else
-    {
-        make_fnam(STATE_DATA, p_fam, ST_FILE_SUFFIX(p_fam, p_fam->state_map[st_index].file), fname);
-#if defined(_WIN32) || defined(WIN32)
-        status = 0;
-#else
-        status = truncate(fname, p_fam->state_map[st_index].offset);
-#endif
-        status = state_file_open(p_fam, p_fam->state_map[st_index].file, p_fam->access_mode);
+        p_fam->st_file_count = file_qty + 1;
     }
 
-    /* Clean up the state maps, in mili file version < 3 these are in the A-file, thereafter they are in the T-file */
+    /*
+     * Drop the tail of the on-disk state map.  In mili file version < 3
+     * it is in the A-file ahead of the directory header, thereafter it is
+     * the T-file - fixed size entries followed by the end marker.
+     */
     if ( p_fam->char_header[DIR_VERSION_IDX] > 1 )
     {
-        if ( p_fam->char_header[HDR_VERSION_IDX] > 2 && p_fam->write_tfile )
-        {
-            if ( p_fam->time_state_file == NULL )
-            {
-                p_fam->time_state_file = fopen(p_fam->time_file_name, "r+b");
-            }
-            fp = p_fam->time_state_file;
-        }
-        else
-        {
-            fp = fopen(p_fam->aFile, "r+b");
-        }
+        use_tfile = (p_fam->char_header[HDR_VERSION_IDX] > 2 && p_fam->write_tfile);
 
-        if ( fp )
+        if ( use_tfile )
         {
-            if ( p_fam->char_header[HDR_VERSION_IDX] > 2 && p_fam->write_tfile )
+            if ( p_fam->time_state_file != NULL )
             {
-                offset = -1;
-            }
-            else
-            {
-                offset = -(QTY_DIR_HEADER_FIELDS)*EXT_SIZE(p_fam, M_INT);
-            }
-            fseek(fp, offset, SEEK_END);
-            if ( status != 0 )
-            {
-                fclose(fp);
-                return SEEK_FAILED;
+                fclose(p_fam->time_state_file);
+                p_fam->time_state_file = NULL;
             }
-            if ( p_fam->char_header[HDR_VERSION_IDX] > 2 && p_fam->write_tfile )
+
+            /* 20 is the size of a statemap. */
+            rval = truncate_file(p_fam->time_file_name, (LONGLONG)st_index * 20);
+            if ( rval == OK )
             {
-                num_items = p_fam->read_funcs[M_STRING](fp, &check, 1);
-                if ( num_items != 1 || check != p_fam->state_end_marker )
+                p_fam->time_state_file = fopen(p_fam->time_file_name, "r+b");
+                if ( p_fam->time_state_file == NULL )
                 {
-                    fclose(fp);
-                    mc_print_error("Standalone state file corrupted ", CORRUPTED_FILE);
+                    rval = OPEN_FAILED;
                 }
-            }
-            else
-            {
-                num_items = p_fam->read_funcs[M_INT](fp, header, QTY_DIR_HEADER_FIELDS);
-                if ( num_items != QTY_DIR_HEADER_FIELDS )
+                else if ( fseek(p_fam->time_state_file, 0, SEEK_END) != 0 )
                 {
-                    fclose(fp);
-                    return BAD_LOAD_READ;
+                    rval = SEEK_FAILED;
+                }
+                else if ( p_fam->write_funcs[M_STRING](p_fam->time_state_file, &p_fam->state_end_marker, 1) != 1 )
+                {
+                    rval = SHORT_WRITE;
+                }
+
+                if ( p_fam->time_state_file != NULL )
+                {
+                    fclose(p_fam->time_state_file);
+                    p_fam->time_state_file = NULL;
                 }
             }
-            if ( p_fam->char_header[HDR_VERSION_IDX] > 2 && p_fam->write_tfile )
+        }
+        else
+        {
+            fp = fopen(p_fam->aFile, "r+b");
+            if ( fp == NULL )
             {
-                offset = 0;
-                status = fseek(fp, offset, SEEK_SET);
+                return NO_A_FILE_FOR_STATEMAP;
             }
-            else
+
+            if ( fseek(fp, -(QTY_DIR_HEADER_FIELDS)*EXT_SIZE(p_fam, M_INT), SEEK_END) != 0 )
             {
-                offset -= header[QTY_STATES_IDX] * 20;
-                status = fseek(fp, offset, SEEK_END);
+                fclose(fp);
+                return SEEK_FAILED;
             }
-
-            if ( st_index > 0 )
+            num_items = p_fam->read_funcs[M_INT](fp, header, QTY_DIR_HEADER_FIELDS);
+            if ( num_items != QTY_DIR_HEADER_FIELDS )
             {
-                status = fseek(fp, st_index * 20, SEEK_CUR);
+                fclose(fp);
+                return BAD_LOAD_READ;
             }
-            offset = ftell(fp);
 
+            /* Map entries for the pruned states precede the header. */
+            fseek(fp, 0, SEEK_END);
+            offset = ftell(fp) - QTY_DIR_HEADER_FIELDS * EXT_SIZE(p_fam, M_INT)
+                     - (LONGLONG)(header[QTY_STATES_IDX] - st_index) * 20;
             fclose(fp);
-            fp = NULL;
-            if ( p_fam->char_header[HDR_VERSION_IDX] > 2 && p_fam->write_tfile )
-            {
-                p_fam->time_state_file = NULL;
-            }
-#if !(defined(_WIN32) || defined(WIN32))
-            if ( p_fam->char_header[HDR_VERSION_IDX] > 2 && p_fam->write_tfile )
-            {
-                strcpy(fname, p_fam->time_file_name);
-            }
-            else
-            {
-                strcpy(fname, p_fam->aFile);
-            }
-            truncate(fname, offset);
-#endif
-            if ( p_fam->char_header[HDR_VERSION_IDX] > 2 && p_fam->write_tfile )
+
+            rval = truncate_file(p_fam->aFile, offset);
+            if ( rval == OK )
             {
-                if ( p_fam->time_state_file == NULL )
+                fp = fopen(p_fam->aFile, "r+b");
+                if ( fp == NULL )
                 {
-                    p_fam->time_state_file = fopen(p_fam->time_file_name, "r+b");
+                    return NO_A_FILE_FOR_STATEMAP;
                 }
-                fp = p_fam->time_state_file;
-                fseek(fp, 0, SEEK_END);
-                p_fam->write_funcs[M_STRING](fp, &p_fam->state_end_marker, 1);
-            }
-            else
-            {
-                fp = fopen(p_fam->aFile, "r+b");
                 fseek(fp, 0, SEEK_END);
                 header[QTY_STATES_IDX] = st_index;
                 num_items = p_fam->write_funcs[M_INT](fp, header, QTY_DIR_HEADER_FIELDS);
+                fclose(fp);
                 if ( num_items != QTY_DIR_HEADER_FIELDS )
                 {
-                    fclose(fp);
                     return SHORT_WRITE;
                 }
             }
-            fclose(fp);
-            p_fam->time_state_file = NULL;
+        }
+
+        if ( rval != OK )
+        {
+            return rval;
         }
     }
 
-    /* Clean up state_map*/
-    if ( rval == OK )
+    /* The time-history stream must not return the pruned states. */
+    rval = th_truncate(p_fam, st_index);
+    if ( rval != OK )
     {
-        if ( st_index == 0 )
-        {
-            memset((void *)fname, (int)0, 64);
+        return rval;
+    }
 
-            free(p_fam->state_map);
-            p_fam->state_map = NULL;
-            free(p_fam->file_map);
-            p_fam->file_map = NULL;
-            p_fam->state_qty = 0;
-            p_fam->cur_st_file_size = 0;
-            p_fam->file_st_qty = 0;
-            p_fam->st_file_count = 0;
-        }
-        else
+    /* Clean up the in-memory maps; the next new state/file extends them. */
+    if ( st_index == 0 )
+    {
+        free(p_fam->state_map);
+        p_fam->state_map = NULL;
+        free(p_fam->file_map);
+        p_fam->file_map = NULL;
+        p_fam->state_qty = 0;
+        p_fam->cur_st_file_size = 0;
+        p_fam->file_st_qty = 0;
+        p_fam->st_file_count = 0;
+    }
+    else
+    {
+        for ( i = 0; i < file_qty; i++ )
         {
-            make_fnam(STATE_DATA, p_fam, ST_FILE_SUFFIX(p_fam, p_fam->state_map[st_index].file), fname);
-            State_descriptor *temp = NEW_N(State_descriptor, st_index, "Shrunken state map on restart");
+            first_file_state += p_fam->file_map[i].state_qty;
+        }
 
-            memcpy((void *)temp, p_fam->state_map, st_index * sizeof(State_descriptor));
-            free(p_fam->state_map);
-            p_fam->state_map = temp;
-            temp = NULL;
-            if ( st_index > 0 && p_fam->state_map == NULL )
-            {
-                rval = ALLOC_FAILED;
-            }
+        p_fam->state_qty = st_index;
+        p_fam->file_map[file_qty].state_qty = st_index - first_file_state;
+        p_fam->file_map[file_qty].file_size = 0;
 
-            if ( file_qty + 1 != p_fam->st_file_count )
-            {
-                p_fam->file_map = RENEW_N(State_file_descriptor, p_fam->file_map, p_fam->st_file_count, file_qty,
-                                          "Shrunken file map on restart");
-            }
-            if ( p_fam->file_map == NULL )
-            {
-                rval = ALLOC_FAILED;
-            }
-            else
-            {
-                p_fam->state_qty = st_index;
-                int file_st_idx = st_index;
-                int file_st_cnt = 0;
-                while( file_st_idx > 0 && p_fam->state_map[ file_st_idx - 1 ].file == p_fam->state_map[ st_index - 1 ].file )
-                {
-                    file_st_cnt += 1;
-                    file_st_idx -= 1;
-                }
-                p_fam->file_st_qty = file_st_cnt;
-                p_fam->file_map[p_fam->state_map[st_index - 1].file].state_qty = p_fam->file_st_qty;
-            }
+        /* Counts for the last remaining file. */
+        i = p_fam->state_map[st_index - 1].file;
+        p_fam->file_st_qty = p_fam->file_map[i].state_qty;
+
+        if ( p_fam->state_map[st_index].offset != 0 )
+        {
+            rval = state_file_open(p_fam, file_qty, p_fam->access_mode);
         }
     }
 
     return rval;
 }
+
 /*****************************************************************
  * TAG( set_state_map_on ) PUBLIC
  *
@@ -369,8 +355,16 @@ Return_value mc_set_state_map_file_on(Famid fam_id, Bool_type on)
 /*****************************************************************
  * TAG( rebuild_state_tfile )
  *
- * Rebuild state file based on plot files
+ * Rebuild the T-file from the state files, e.g. after a job died
+ * before writing its end marker.
  *
+ * Each file is opened once.  State offsets advance by the size of
+ * the record format named in the previous header.  The header read
+ * at each offset supplies the state time and confirms the format.
+ * A partial state left at the end of a file by a crash is dropped,
+ * and the scan stops at the first file without a state.  The map is
+ * grown a file at a time and the T-file is written in one buffered
+ * pass once the scan is done.
  */
 Return_value rebuild_state_tfile(Mili_family *fam)
 {
@@ -379,28 +373,22 @@ Return_value rebuild_state_tfile(Mili_family *fam)
         return OK;
     }
 
-    State_file_descriptor *p_fmap = NULL;
+    State_descriptor *p_sd;
     int index;
     LONGLONG offset;
+    LONGLONG file_size;
+    LONGLONG rec_size;
     LONGLONG (*readi)();
     LONGLONG (*readf)();
     float st_time;
     int srec_id;
     int state_qty;
+    int map_qty;
+    int file_st_qty;
     int hdr_size;
+    int i;
     Return_value rval;
-    int wrt_size = 0;
-
-    offset = 0;
 
-    if ( !fam->time_state_file )
-    {
-        fam->time_state_file = fopen(fam->time_file_name, "w+");
-        if ( fam->time_state_file == NULL )
-        {
-            return MAP_FILE_CREATION_ERROR;
-        }
-    }
     if ( fam->file_map )
     {
         free(fam->file_map);
@@ -416,124 +404,118 @@ Return_value rebuild_state_tfile(Mili_family *fam)
     readi = fam->state_read_funcs[M_INT];
     readf = fam->state_read_funcs[M_FLOAT];
 
-    hdr_size = EXT_SIZE(fam, M_INT) + EXT_SIZE(fam, M_FLOAT);
+    hdr_size = ST_HEADER_SIZE(fam);
 
     rval = OK;
-    index = 0;
     state_qty = 0;
-
-    /* Count offset through mapped states in known last file. */
+    map_qty = 0;
+    file_st_qty = 0;
     offset = 0;
-
-    fam->file_st_qty = 0;
+    rec_size = 0;
 
     /* Traverse the state data files. */
-    while ( state_file_open(fam, index, 'r') == OK )
+    for ( index = 0;; index++ )
     {
+        /* state_file_open() looks up the file's entry. */
+        fam->file_map = RENEWC_N(State_file_descriptor, fam->file_map, index, 1, "Rebuilt file map entry");
         if ( fam->file_map == NULL )
         {
-            fam->file_map = NEW_N(State_file_descriptor, 1, "Allocating state file descriptor in rebuild_state_tfile");
-            if ( !fam->file_map )
-            {
-                return ALLOC_FAILED;
-            }
+            return ALLOC_FAILED;
         }
-        else
+        if ( state_file_open(fam, index, 'r') != OK )
         {
-            fam->file_map = RENEW_N(State_file_descriptor, p_fmap, index, 1,
-                                    "Reallocating state file descriptor in rebuild_state_tfile");
-            if ( !fam->file_map )
-            {
-                return ALLOC_FAILED;
-            }
+            break;
         }
+
+        file_size = fam->cur_st_file_size;
+        file_st_qty = 0;
+
         /* Traverse the state records within the current file. */
-        while ( offset < fam->cur_st_file_size && seek_state_file(fam->cur_st_file, offset) == OK )
+        for ( offset = 0; offset + hdr_size <= file_size; offset += rec_size )
         {
             /* Read the header - time and format. */
-            if ( readf(fam->cur_st_file, &st_time, 1) != 1 )
+            if ( seek_state_file(fam->cur_st_file, offset) != OK || readf(fam->cur_st_file, &st_time, 1) != 1 ||
+                 readi(fam->cur_st_file, &srec_id, 1) != 1 )
             {
-                rval = SHORT_READ;
                 break;
             }
 
-            if ( readi(fam->cur_st_file, &srec_id, 1) != 1 )
+            /* Stop at anything that isn't a whole state. */
+            if ( srec_id < 0 || srec_id >= fam->qty_srecs )
             {
-                rval = SHORT_READ;
                 break;
             }
-
-            /* Add a new entry in the state map. */
-            if ( fam->state_map == NULL )
+            rec_size = hdr_size + fam->srecs[srec_id]->size;
+            if ( offset + rec_size > file_size )
             {
-                fam->state_map = NEW_N(State_descriptor, 1, "Allocate state descriptor in rebuild_state_tfile");
-                if ( !fam->state_map )
-                {
-                    return ALLOC_FAILED;
-                }
+                break;
             }
-            else
+
+            /* Size the map for the rest of the file in one step. */
+            if ( state_qty == map_qty )
             {
-                fam->state_map = RENEWC_N(State_descriptor, fam->state_map, state_qty, 1,
-                                          "Reallocating state file descriptor in rebuild_state_tfile");
-                if ( !fam->state_map )
+                i = (int)((file_size - offset) / rec_size);
+                fam->state_map =
+                    RENEW_N(State_descriptor, fam->state_map, map_qty, i, "Rebuilt state descriptors");
+                if ( fam->state_map == NULL )
                 {
                     return ALLOC_FAILED;
                 }
+                map_qty += i;
             }
 
-            fam->state_map[state_qty].file = index;
-            fam->state_map[state_qty].offset = offset;
-            fam->state_map[state_qty].time = st_time;
-            fam->state_map[state_qty].srec_format = srec_id;
+            p_sd = fam->state_map + state_qty;
+            p_sd->file = index;
+            p_sd->offset = offset;
+            p_sd->time = st_time;
+            p_sd->srec_format = srec_id;
 
-            wrt_size = fam->write_funcs[M_INT](fam->time_state_file, (void *)&index, 1);
-            if ( wrt_size != 1 )
-            {
-                rval = SHORT_WRITE;
-            }
-            wrt_size = fam->write_funcs[M_FLOAT8](fam->time_state_file, (void *)&offset, 1);
-            if ( wrt_size != 1 )
-            {
-                rval = SHORT_WRITE;
-            }
-            wrt_size = fam->write_funcs[M_FLOAT](fam->time_state_file, (void *)&st_time, 1);
-            if ( wrt_size != 1 )
-            {
-                rval = SHORT_WRITE;
-            }
-            wrt_size = fam->write_funcs[M_INT](fam->time_state_file, (void *)&srec_id, 1);
-            if ( wrt_size != 1 )
-            {
-                rval = SHORT_WRITE;
-            }
-            if ( rval != OK )
-            {
-                return rval;
-            }
-            /* Update stuff... */
-            offset += fam->srecs[srec_id]->size + hdr_size;
-
-            fam->cur_st_offset = offset;
             state_qty++;
-            fam->state_qty = state_qty;
-            fam->file_st_qty++;
+            file_st_qty++;
         }
 
-        index++;
-
-        if ( offset == 0 || rval != OK )
+        if ( file_st_qty == 0 )
         {
-            rval = state_file_close(fam);
             break;
         }
-        fam->st_file_count = index;
+
+        fam->file_map[index].state_qty = file_st_qty;
+
+        fam->st_file_count = index + 1;
+        fam->cur_st_offset = offset;
+        fam->file_st_qty = file_st_qty;
+    }
+    state_file_close(fam);
+    fam->state_qty = state_qty;
+
+    /* Write the whole map and the end marker in one pass. */
+    if ( fam->time_state_file )
+    {
+        fclose(fam->time_state_file);
+    }
+    fam->time_state_file = fopen(fam->time_file_name, "w+b");
+    if ( fam->time_state_file == NULL )
+    {
+        return MAP_FILE_CREATION_ERROR;
+    }
+    setvbuf(fam->time_state_file, NULL, _IOFBF, (size_t)(state_qty < 65536 ? state_qty : 65536) * 20 + 1);
+
+    for ( i = 0; i < state_qty && rval == OK; i++ )
+    {
+        p_sd = fam->state_map + i;
+        if ( fam->write_funcs[M_INT](fam->time_state_file, (void *)&p_sd->file, 1) != 1 ||
+             fam->write_funcs[M_INT8](fam->time_state_file, (void *)&p_sd->offset, 1) != 1 ||
+             fam->write_funcs[M_FLOAT](fam->time_state_file, (void *)&p_sd->time, 1) != 1 ||
+             fam->write_funcs[M_INT](fam->time_state_file, (void *)&p_sd->srec_format, 1) != 1 )
+        {
+            rval = SHORT_WRITE;
+        }
     }
 
     if ( rval == OK )
     {
-        index = fam->write_funcs[M_STRING](fam->time_state_file, "~", 1);
-        if ( index != 1 )
+        if ( fam->write_funcs[M_STRING](fam->time_state_file, &fam->state_end_marker, 1) != 1 ||
+             fflush(fam->time_state_file) != 0 )
         {
             rval = SHORT_WRITE;
         }
@@ -650,6 +632,10 @@ Return_value load_static_maps(Mili_family *fam, Bool_type initial_build, Bool_ty
         fam->state_qty = state_count;
 
         // parse state maps
+        if ( fam->state_map != NULL )
+        {
+            free(fam->state_map);
+        }
         fam->state_map = NEW_N(State_descriptor, state_count, "State map descriptors");
         for ( cur_state = 0; cur_state < state_count; cur_state++ )
         {
@@ -681,6 +667,9 @@ Return_value load_static_maps(Mili_family *fam, Bool_type initial_build, Bool_ty
         if ( fam->cur_st_file != NULL )
             state_file_close(fam);
 
+        /* Pooled descriptors may hold stale sizes for files that have grown. */
+        state_file_pool_close(fam);
+
         rval = state_file_open(fam, fam->state_map[ fam->state_qty-1 ].file, fam->access_mode);
         if ( rval != OK )
         {
@@ -690,6 +679,13 @@ Return_value load_static_maps(Mili_family *fam, Bool_type initial_build, Bool_ty
 
     if ( state_count > 0 && fam->access_mode != 'r')
     {
+        /* Writing needs the state files in raw form. */
+        rval = expand_state_files(fam);
+        if ( rval != OK )
+        {
+            return rval;
+        }
+
         rval = state_file_open(fam, fam->st_file_count - 1, fam->access_mode);
         if ( rval != OK )
         {
@@ -809,6 +805,12 @@ Return_value update_static_map(Famid fam_id, State_descriptor *p_sd)
         if ( fam->char_header[HDR_VERSION_IDX] > 2 && fam->write_tfile )
         {
             fam->write_funcs[M_STRING](fp, &fam->state_end_marker, 1);
+
+            /* Publish the state to readers that open the family now. */
+            if ( fflush(fp) != 0 )
+            {
+                return SHORT_WRITE;
+            }
         }
         else
         {
@@ -575,8 +575,7 @@ Return_value mc_query_family(Famid fam_id, int which, void *num_args, char *char
         case LIB_VERSION:
             /*****  Fixed to return the library version
                     used when the database was written *****/
-            p_ht = fam->param_table;
-            rval = htable_search(p_ht, char_args, FIND_ENTRY, &p_hte);
+            rval = param_table_search(fam, char_args, FIND_ENTRY, &p_hte);
             if ( p_hte != NULL )
             {
                 version = (char *)p_hte->data;
@@ -840,6 +839,22 @@ int is_numeric(char *ptest)
     return (p_c == ptest) ? FALSE : TRUE;
 }
 
+/*****************************************************************
+ * TAG( is_zip_suffix ) PRIVATE
+ *
+ * Evaluate a string and return TRUE if it is a state file suffix
+ * followed by the 'z' of a compressed state file.
+ */
+int is_zip_suffix(char *ptest)
+{
+    char *p_c;
+
+    for ( p_c = ptest; isdigit((int)*p_c); p_c++ )
+        ;
+
+    return (p_c != ptest && p_c[0] == 'z' && p_c[1] == (char)0) ? TRUE : FALSE;
+}
+
 /*****************************************************************
  * TAG( is_all_upper ) PRIVATE
  *
@@ -905,6 +920,14 @@ void make_fnam(int ftype, Mili_family *fam, int fnum, char dest[])
             sprintf(dest, "%swlock", fam->root);
             break;
 
+        case OPEN_INDEX:
+            sprintf(dest, "%sindex", fam->root);
+            break;
+
+        case TIME_HISTORY:
+            sprintf(dest, "%sth", fam->root);
+            break;
+
         case TI_DATA:
             to_base26(fnum, TRUE, numtext);
             sprintf(dest, "%s_TI_%s", fam->root, numtext);
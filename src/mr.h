@@ -43,6 +43,42 @@
 #include "misc.h"
 #include "mili_internal.h"
 
+/* A requested (class, state variable) result, gathered by object id. */
+typedef struct _mr_field
+{
+    char *class_name;
+    char *svar_name;
+    int type;        /* Numeric type of the result */
+    int veclen;      /* Atoms per object */
+    int len;         /* Quantity of objects bound to the result */
+    int block_qty;   /* Quantity of object id ranges */
+    int *block_list; /* Object id ranges, in subrecord order */
+    int result_len;  /* Atoms in the result buffer, max object id * veclen */
+    void *result;    /* Result buffer indexed by object id */
+} Mr_field;
+
+/* One subrecord read per state, feeding one or more fields. */
+typedef struct _mr_read
+{
+    int subrec_id;
+    int qty_blocks;
+    int *mo_blocks;
+    int qty;      /* Quantity of results read from the subrecord */
+    char **names; /* Result names for mc_read_results() */
+    int *fields;  /* Destination field of each result */
+    void *buffer; /* Result-ordered data for the subrecord */
+} Mr_read;
+
+/* A one-time mapping of requested results onto subrecord reads. */
+typedef struct _mr_result_plan
+{
+    int dbid;
+    int field_qty;
+    Mr_field *fields;
+    int read_qty;
+    Mr_read *reads;
+} Mr_result_plan;
+
 Return_value mc_mr_get_geom(int dbid, int mesh_id, int element_type, int *qty_elems, int **conn, int **mat,
                             int *num_mats, int **mat_list, int **part, int **elem_ids, int **labels);
 
@@ -53,6 +89,13 @@ Return_value mc_mr_get_result(int dbid, int state, int subrec_qty, Subrecord *p_
                               char *var_name, int *len, int *veclen, int *type, int *block_qty, int **block_list,
                               void **result);
 
+Return_value mc_mr_plan_results(int dbid, int subrec_qty, Subrecord *p_subrec, int qty, char **class_names,
+                                char **svar_names, Mr_result_plan **pp_plan);
+
+Return_value mc_mr_read_plan(Mr_result_plan *p_plan, int state);
+
+void mc_mr_free_plan(Mr_result_plan *p_plan);
+
 Return_value mc_mr_get_subrec_list(int dbid, int subrec_qty, Subrecord *p_subrec, char *class_name,
                                    int *subrec_names_len, char **subrec_names);
 
@@ -270,274 +270,320 @@ Return_value mc_mr_get_result(int dbid, int state, int subrec_qty, Subrecord *p_
                               char *svar_name, int *len, int *veclen, int *type, int *block_qty, int **block_list,
                               void **result)
 {
-    int i, j, k;
-    int block_cnt = 0, total_blocks = 0, temp_block_cnt = 0, temp_len = 0;
-
-    int elem_id_start = 0, elem_id_stop = 0;
-
-    int result_index = 0;
-    float *result_buff_flt = NULL, *temp_result_buff_flt;
-    double *result_buff_dbl = NULL, *temp_result_buff_dbl;
-    int *result_buff_int = NULL, *temp_result_buff_int;
-    LONGLONG *result_buff_long = NULL, *temp_result_buff_long;
-
-    int result_len = 0, result_vec_len = 1;
-    void *result_buff, *temp_result_buff;
-
-    char *results[2];
-    Bool_type valid_result = FALSE;
-    State_variable p_sv;
-    Subrecord *subrec_ptr;
-
-    int *temp_block_list, *block_list_ptr;
-    int max_id = 0;
-
+    Mr_result_plan *p_plan;
+    Mr_field *p_field;
     Return_value status;
 
-    status = mc_get_svar_def(dbid, svar_name, &p_sv);
-
-    if ( status != OK )
-    {
-        return (status);
-    }
-
-    /* Count length of results for all records of this type */
-
     *block_qty = 0;
-    temp_block_cnt = 0;
     *len = 0;
 
-    for ( i = 0; i < subrec_qty; i++ )
+    status = mc_mr_plan_results(dbid, subrec_qty, p_subrec, 1, &class_name, &svar_name, &p_plan);
+    if ( status != OK )
     {
-        if ( !strcmp(p_subrec[i].class_name, class_name) )
-        {
-            for ( j = 0; j < p_subrec[i].qty_svars; j++ )
-            {
-                if ( !strcmp(p_subrec[i].svar_names[j], svar_name) )
-                {
-                    for ( k = 0; k < p_subrec[i].qty_blocks; k++ )
-                    {
-                        temp_block_cnt += 2;
-                    }
-                }
-            }
-        }
+        return status;
     }
 
-    if ( temp_block_cnt == 0 )
+    p_field = p_plan->fields;
+    if ( p_field->len == 0 )
     {
-        return (NOT_OK);
+        mc_mr_free_plan(p_plan);
+        return NOT_OK;
     }
 
-    temp_block_list = (int *)malloc(temp_block_cnt * sizeof(int));
-    if ( temp_block_cnt > 0 && temp_block_list == NULL )
+    status = mc_mr_read_plan(p_plan, state);
+    if ( status == OK )
     {
-        return ALLOC_FAILED;
+        *len = p_field->len;
+        *veclen = p_field->veclen;
+        *type = p_field->type;
+        *block_qty = p_field->block_qty;
+        *block_list = p_field->block_list;
+        *result = p_field->result;
+
+        /* Ownership of the block list and result passes to the caller. */
+        p_field->block_list = NULL;
+        p_field->result = NULL;
     }
 
-    temp_block_cnt = 0;
-    for ( i = 0; i < subrec_qty; i++ )
-    {
-        if ( !strcmp(p_subrec[i].class_name, class_name) )
-        {
-            for ( j = 0; j < p_subrec[i].qty_svars; j++ )
-            {
-                if ( !strcmp(p_subrec[i].svar_names[j], svar_name) )
-                {
-                    block_cnt = 0;
-                    for ( k = 0; k < p_subrec[i].qty_blocks; k++ )
-                    {
-                        subrec_ptr = &p_subrec[i];
-
-                        temp_block_list[temp_block_cnt] = (int)p_subrec[i].mo_blocks[block_cnt];
-                        temp_block_list[temp_block_cnt + 1] = (int)p_subrec[i].mo_blocks[block_cnt + 1];
-                        temp_len += (temp_block_list[temp_block_cnt + 1] - temp_block_list[temp_block_cnt]) + 1;
-                        if ( temp_block_list[temp_block_cnt + 1] > max_id )
-                            max_id = temp_block_list[temp_block_cnt + 1];
-                        block_cnt += 2;
-                        temp_block_cnt += 2;
-                    }
-                }
-            }
-        }
-    }
+    mc_mr_free_plan(p_plan);
+    return status;
+}
 
-    if ( temp_len == 0 )
+/************************************************************
+ * TAG( mc_mr_plan_results )
+ *
+ * Map a list of (class, state variable) results onto the
+ * subrecords which hold them.  The plan is built once and
+ * then read at each state with mc_mr_read_plan(), which
+ * issues one mc_read_results() call per subrecord and does
+ * no name matching.  A result bound to no subrecord stays
+ * in the plan with a length of zero.
+ */
+Return_value mc_mr_plan_results(int dbid, int subrec_qty, Subrecord *p_subrec, int qty, char **class_names,
+                                char **svar_names, Mr_result_plan **pp_plan)
+{
+    Mili_family *fam;
+    Mr_result_plan *p_plan;
+    Mr_field *p_field;
+    Mr_read *p_read;
+    Htable_entry *p_hte;
+    Svar *p_sv;
+    int i, j, k;
+    int max_id, read_size;
+    int *p_block;
+    Return_value status;
+
+    *pp_plan = NULL;
+    status = validate_fam_id(dbid);
+    if ( status != OK )
     {
-        free(temp_block_list);
-        return (NOT_OK);
+        return status;
     }
+    fam = fam_list[dbid];
 
-    *len = temp_len;
-    total_blocks = temp_block_cnt / 2;
-
-    block_list_ptr = (int *)malloc((temp_block_cnt) * sizeof(int));
-
-    if ( temp_block_cnt > 0 && block_list_ptr == NULL )
+    p_plan = NEW(Mr_result_plan, "Result plan");
+    if ( p_plan == NULL )
     {
-        free(temp_block_list);
         return ALLOC_FAILED;
     }
-
-    for ( i = 0; i < temp_block_cnt; i++ )
+    p_plan->dbid = dbid;
+    p_plan->field_qty = qty;
+    p_plan->fields = NEW_N(Mr_field, qty, "Result plan fields");
+    p_plan->reads = NEW_N(Mr_read, subrec_qty, "Result plan reads");
+    if ( (qty > 0 && p_plan->fields == NULL) || (subrec_qty > 0 && p_plan->reads == NULL) )
     {
-        block_list_ptr[i] = temp_block_list[i];
+        mc_mr_free_plan(p_plan);
+        return ALLOC_FAILED;
     }
 
-    free(temp_block_list);
-
-    status = mc_mr_get_result_len(dbid, subrec_qty, p_subrec, class_name, "*", svar_name, &result_len);
-    if ( status != OK )
+    /* Type and size each requested result. */
+    for ( i = 0; i < qty; i++ )
     {
-        free(block_list_ptr);
-        return status;
-    }
-
-    result_vec_len = result_len / (*len);
-    results[0] = strdup(svar_name);
-    results[1] = NULL;
-
-    /* Need to use max_id for computing the max result len to
-     * account for TH files that may have less results than
-     * the max id number.
-     */
-    result_len = max_id * result_vec_len;
+        p_field = p_plan->fields + i;
 
-    /* Allocate space for the result by type */
+        status = htable_search(fam->svar_table, svar_names[i], FIND_ENTRY, &p_hte);
+        if ( p_hte == NULL )
+        {
+            mc_mr_free_plan(p_plan);
+            return status;
+        }
+        p_sv = (Svar *)p_hte->data;
 
-    if ( p_sv.num_type == M_FLOAT )
-    {
-        result_buff_flt = NEW_N(float, result_len, "Result buffer - flt[mc_mr_get_result[");
-        result_buff = (void *)result_buff_flt;
-        temp_result_buff_flt = NEW_N(float, result_len, "Temp result buffer - flt[mc_mr_get_result[");
-        temp_result_buff = (void *)temp_result_buff_flt;
+        p_field->type = *p_sv->data_type;
+        if ( p_field->type != M_FLOAT && p_field->type != M_FLOAT8 && p_field->type != M_INT &&
+             p_field->type != M_INT8 )
+        {
+            mc_mr_free_plan(p_plan);
+            return INVALID_DATA_TYPE;
+        }
+        p_field->veclen = svar_atoms(p_sv);
 
-        for ( i = 0; i < result_len; i++ )
+        p_field->class_name = strdup(class_names[i]);
+        p_field->svar_name = strdup(svar_names[i]);
+        if ( p_field->class_name == NULL || p_field->svar_name == NULL )
         {
-            result_buff_flt[i] = (float)0.0;
-            temp_result_buff_flt[i] = (float)0.0;
+            mc_mr_free_plan(p_plan);
+            return ALLOC_FAILED;
         }
     }
-    else if ( p_sv.num_type == M_FLOAT8 )
+
+    /* Bind the results to subrecords; each bound subrecord becomes one read. */
+    for ( i = 0; i < subrec_qty; i++ )
     {
-        result_buff_dbl = NEW_N(double, result_len, "Result buffer - dbl[mc_mr_get_result[");
-        result_buff = (void *)result_buff_dbl;
-        temp_result_buff_dbl = NEW_N(double, result_len, "Temp result buffer - flt[mc_mr_get_result[");
-        temp_result_buff = (void *)temp_result_buff_dbl;
+        p_read = p_plan->reads + p_plan->read_qty;
+        read_size = 0;
 
-        for ( i = 0; i < result_len; i++ )
+        for ( k = 0; k < qty; k++ )
         {
-            result_buff_dbl[i] = (double)0.0;
-            temp_result_buff_dbl[i] = (double)0.0;
+            p_field = p_plan->fields + k;
+            if ( strcmp(p_subrec[i].class_name, p_field->class_name) )
+            {
+                continue;
+            }
+
+            for ( j = 0; j < p_subrec[i].qty_svars; j++ )
+            {
+                if ( !strcmp(p_subrec[i].svar_names[j], p_field->svar_name) )
+                {
+                    break;
+                }
+            }
+            if ( j == p_subrec[i].qty_svars )
+            {
+                continue;
+            }
+
+            if ( p_read->qty == 0 )
+            {
+                p_read->names = NEW_N(char *, qty, "Result plan read names");
+                p_read->fields = NEW_N(int, qty, "Result plan read fields");
+                if ( p_read->names == NULL || p_read->fields == NULL )
+                {
+                    p_plan->read_qty++;
+                    mc_mr_free_plan(p_plan);
+                    return ALLOC_FAILED;
+                }
+            }
+            p_read->names[p_read->qty] = p_field->svar_name;
+            p_read->fields[p_read->qty] = k;
+            p_read->qty++;
+
+            p_field->block_qty += p_subrec[i].qty_blocks;
+            read_size += p_subrec[i].qty_objects * p_field->veclen * internal_sizes[p_field->type];
         }
-    }
-    else if ( p_sv.num_type == M_INT )
-    {
-        result_buff_int = NEW_N(int, result_len, "Result buffer - int[mc_mr_get_result[");
-        result_buff = (void *)result_buff_int;
-        temp_result_buff_int = NEW_N(int, result_len, "Temp result buffer - int[mc_mr_get_result[");
-        temp_result_buff = (void *)temp_result_buff_int;
 
-        for ( i = 0; i < result_len; i++ )
+        if ( p_read->qty > 0 )
         {
-            result_buff_int[i] = (int)0.0;
-            temp_result_buff_int[i] = (int)0.0;
+            p_read->subrec_id = i;
+            p_read->qty_blocks = p_subrec[i].qty_blocks;
+            p_read->mo_blocks = NEW_N(int, 2 * p_read->qty_blocks, "Result plan read blocks");
+            p_read->buffer = (void *)NEW_N(char, read_size, "Result plan read buffer");
+            if ( (p_read->qty_blocks > 0 && p_read->mo_blocks == NULL) || (read_size > 0 && p_read->buffer == NULL) )
+            {
+                p_plan->read_qty++;
+                mc_mr_free_plan(p_plan);
+                return ALLOC_FAILED;
+            }
+            memcpy(p_read->mo_blocks, p_subrec[i].mo_blocks, 2 * p_read->qty_blocks * sizeof(int));
+            p_plan->read_qty++;
         }
     }
-    else if ( p_sv.num_type == M_INT8 )
-    {
-        result_buff_long = NEW_N(LONGLONG, result_len, "Result buffer - long[mc_mr_get_result[");
-        result_buff = (void *)result_buff_long;
-        temp_result_buff_long = NEW_N(LONGLONG, result_len, "Temp result buffer - long[mc_mr_get_result[");
-        temp_result_buff = (void *)temp_result_buff_long;
 
-        for ( i = 0; i < result_len; i++ )
+    /* Gather the object id ranges of each result in subrecord order. */
+    for ( k = 0; k < qty; k++ )
+    {
+        p_field = p_plan->fields + k;
+        p_field->block_list = NEW_N(int, 2 * p_field->block_qty, "Result plan block list");
+        if ( p_field->block_qty > 0 && p_field->block_list == NULL )
         {
-            result_buff_long[i] = (LONGLONG)0.0;
-            temp_result_buff_long[i] = (LONGLONG)0.0;
+            mc_mr_free_plan(p_plan);
+            return ALLOC_FAILED;
         }
+        p_field->block_qty = 0;
     }
-    else
+
+    for ( i = 0; i < p_plan->read_qty; i++ )
     {
-        free(block_list_ptr);
-        return INVALID_DATA_TYPE;
+        p_read = p_plan->reads + i;
+        for ( j = 0; j < p_read->qty; j++ )
+        {
+            p_field = p_plan->fields + p_read->fields[j];
+            p_block = p_field->block_list + 2 * p_field->block_qty;
+            memcpy(p_block, p_read->mo_blocks, 2 * p_read->qty_blocks * sizeof(int));
+            p_field->block_qty += p_read->qty_blocks;
+        }
     }
-    if ( result_len != 0 && (result_buff == NULL || temp_result_buff == NULL) )
+
+    /*
+     * Size each result by its largest object id to allow for
+     * TH files which hold fewer results than the max id number.
+     */
+    for ( k = 0; k < qty; k++ )
     {
-        if ( result_buff != NULL )
+        p_field = p_plan->fields + k;
+        max_id = 0;
+        for ( j = 0; j < p_field->block_qty; j++ )
         {
-            free(result_buff);
+            p_field->len += p_field->block_list[2 * j + 1] - p_field->block_list[2 * j] + 1;
+            if ( p_field->block_list[2 * j + 1] > max_id )
+            {
+                max_id = p_field->block_list[2 * j + 1];
+            }
         }
-        if ( temp_result_buff != NULL )
+
+        p_field->result_len = max_id * p_field->veclen;
+        p_field->result =
+            (void *)NEW_N(char, (LONGLONG)p_field->result_len * internal_sizes[p_field->type], "Result plan buffer");
+        if ( p_field->result_len > 0 && p_field->result == NULL )
         {
-            free(temp_result_buff);
+            mc_mr_free_plan(p_plan);
+            return ALLOC_FAILED;
         }
-        free(block_list_ptr);
-        return ALLOC_FAILED;
     }
 
-    /* Read the requested result for the specified class */
+    *pp_plan = p_plan;
+    return OK;
+}
 
-    for ( i = 0; i < subrec_qty; i++ )
+/************************************************************
+ * TAG( mc_mr_read_plan )
+ *
+ * Read every result in a plan at one state, scattering each
+ * subrecord's data into the results by object id.
+ */
+Return_value mc_mr_read_plan(Mr_result_plan *p_plan, int state)
+{
+    int i, j, k;
+    int obj_size;
+    LONGLONG block_size;
+    char *p_src;
+    Mr_read *p_read;
+    Mr_field *p_field;
+    Return_value status;
+
+    for ( i = 0; i < p_plan->read_qty; i++ )
     {
-        subrec_ptr = &p_subrec[i];
-        status = mc_mr_is_valid_svar(subrec_ptr, svar_name, &valid_result);
-        if ( !strcmp(p_subrec[i].class_name, class_name) && valid_result )
+        p_read = p_plan->reads + i;
+
+        status = mc_read_results(p_plan->dbid, state, p_read->subrec_id, p_read->qty, p_read->names, p_read->buffer);
+        if ( status != OK )
         {
-            status = mc_read_results(dbid, state, i, 1, results, (void *)temp_result_buff);
+            return status;
+        }
 
-            if ( status != OK )
-            {
-                free(result_buff);
-                free(temp_result_buff);
-                free(block_list_ptr);
-                return status;
-            }
-            result_index = 0;
+        /* Results arrive one after another, each in subrecord object order. */
+        p_src = (char *)p_read->buffer;
+        for ( j = 0; j < p_read->qty; j++ )
+        {
+            p_field = p_plan->fields + p_read->fields[j];
+            obj_size = p_field->veclen * internal_sizes[p_field->type];
 
-            /* Load the result by element id */
-            for ( j = 0; j < subrec_ptr->qty_blocks * 2; j++ )
+            for ( k = 0; k < p_read->qty_blocks; k++ )
             {
-                elem_id_start = subrec_ptr->mo_blocks[j] - 1;
-                elem_id_stop = subrec_ptr->mo_blocks[j + 1];
-                j++;
-
-                for ( k = elem_id_start * result_vec_len; k < elem_id_stop * result_vec_len; k++ )
-                {
-                    switch ( p_sv.num_type )
-                    {
-                        case M_INT:
-                            result_buff_int[k] = temp_result_buff_int[result_index];
-                            break;
-                        case M_INT8:
-                            result_buff_long[k] = temp_result_buff_long[result_index];
-                            break;
-                        case M_FLOAT:
-                            result_buff_flt[k] = temp_result_buff_flt[result_index];
-                            break;
-                        case M_FLOAT8:
-                            result_buff_dbl[k] = temp_result_buff_dbl[result_index];
-                            break;
-                    }
-                    result_index++;
-                }
+                block_size = (LONGLONG)(p_read->mo_blocks[2 * k + 1] - p_read->mo_blocks[2 * k] + 1) * obj_size;
+                memcpy((char *)p_field->result + (LONGLONG)(p_read->mo_blocks[2 * k] - 1) * obj_size, p_src,
+                       block_size);
+                p_src += block_size;
             }
         }
     }
 
-    *type = p_sv.num_type;
-    *veclen = result_vec_len;
-    *result = result_buff;
-    *block_qty = total_blocks;
-    *block_list = block_list_ptr;
+    return OK;
+}
+
+/************************************************************
+ * TAG( mc_mr_free_plan )
+ *
+ * Free a result plan and its buffers.
+ */
+void mc_mr_free_plan(Mr_result_plan *p_plan)
+{
+    int i;
 
-    if ( temp_result_buff )
+    if ( p_plan == NULL )
     {
-        free(temp_result_buff);
+        return;
     }
-    free(results[0]);
-    mc_cleanse_st_variable(&p_sv);
-    return (OK);
+
+    for ( i = 0; i < p_plan->field_qty && p_plan->fields != NULL; i++ )
+    {
+        free(p_plan->fields[i].class_name);
+        free(p_plan->fields[i].svar_name);
+        free(p_plan->fields[i].block_list);
+        free(p_plan->fields[i].result);
+    }
+
+    for ( i = 0; i < p_plan->read_qty; i++ )
+    {
+        free(p_plan->reads[i].mo_blocks);
+        free(p_plan->reads[i].names);
+        free(p_plan->reads[i].fields);
+        free(p_plan->reads[i].buffer);
+    }
+
+    free(p_plan->fields);
+    free(p_plan->reads);
+    free(p_plan);
 }
 
 /************************************************************
@@ -589,13 +635,18 @@ Return_value mc_mr_get_subrec_list(int dbid, int subrec_qty, Subrecord *p_subrec
         }
     }
 
+    /*
+     * The list is returned through a char ** argument which really
+     * addresses the caller's char ** variable; store it with that
+     * type so optimizers see the write.
+     */
     if ( *subrec_names_len > 0 )
     {
-        *subrec_names = (char *)temp_names;
+        *(char ***)subrec_names = temp_names;
     }
     else
     {
-        *subrec_names = (char *)NULL;
+        *(char ***)subrec_names = NULL;
     }
     return OK;
 }
@@ -662,11 +713,11 @@ Return_value mc_mr_get_subrec_vars(int dbid, int subrec_qty, Subrecord *p_subrec
     *subrec_vars_len = var_index;
     if ( *subrec_vars_len > 0 )
     {
-        *subrec_vars = (char *)temp_vars;
+        *(char ***)subrec_vars = temp_vars;
     }
     else
     {
-        *subrec_vars = (char *)NULL;
+        *(char ***)subrec_vars = NULL;
     }
     return OK;
 }
@@ -793,7 +844,7 @@ Return_value mc_mr_get_param_list(int dbid, Bool_type ti_param, char *search_pat
         num_entries = mc_ti_htable_search_wildcard(dbid, 0, FALSE, "*", "NULL", "NULL", temp_list);
     }
 
-    *param_list = (char *)temp_list;
+    *(char ***)param_list = temp_list;
     *list_len = (int)num_entries;
 
     return OK;
@@ -812,12 +863,22 @@ Return_value mc_mr_get_param_attributes(int dbid, char *param_name, Bool_type ti
     int qty_entries;
     Mili_family *fam;
     File_dir *directory;
+    Return_value status;
     if ( strlen(param_name) == 0 )
     {
         return INVALID_NAME;
     }
+    status = validate_fam_id(dbid);
+    if ( status != OK )
+    {
+        return status;
+    }
     name_idx = 0;
     fam = fam_list[dbid];
+    if ( ti_param )
+    {
+        load_ti_params(fam);
+    }
 
     for ( fidx = 0; fidx < fam->file_count; fidx++ )
     {
@@ -872,11 +933,17 @@ Return_value mc_mr_get_param_data(int dbid, char *param_name, Bool_type ti_param
     int qty_entries;
 #endif
     Mili_family *fam;
+    Return_value status;
 
     if ( strlen(param_name) == 0 )
     {
         return INVALID_NAME;
     }
+    status = validate_fam_id(dbid);
+    if ( status != OK )
+    {
+        return status;
+    }
 
     fam = fam_list[dbid];
 
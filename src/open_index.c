@@ -0,0 +1,729 @@
+/*
+ Copyright (c) 2016, Lawrence Livermore National Security, LLC.
+ Produced at the Lawrence Livermore National Laboratory. Written
+ by Kevin Durrenberger: durrenberger1@llnl.gov. CODE-OCEC-16-056.
+ All rights reserved.
+
+ This file is part of Mili. For details, see <URL describing code
+ and how to download source>.
+
+ Please also read this link-- Our Notice and GNU Lesser General
+ Public License.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License (as published by
+ the Free Software Foundation) version 2.1 dated February 1999.
+
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the IMPLIED WARRANTY OF
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the terms
+ and conditions of the GNU General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+ * Routines for the open-time index, an optional sidecar file holding
+ * copies of the non-state file regions read while a family is opened
+ * (directories, svar and srec definitions, class and mesh headers and
+ * small parameters).  A reader with a valid index fetches all of them
+ * with one read instead of a seek and read per directory entry.
+ *
+ * Index layout, in host byte order:
+ *
+ *     char     magic[8]
+ *     LONGLONG version
+ *     char     char_header[CHAR_HEADER_SIZE]
+ *     LONGLONG file_count, commit_count, extent_qty
+ *     LONGLONG file_sizes[file_count]
+ *     LONGLONG extents[extent_qty][3]    (file, offset, length)
+ *     char     extent data, in extent order
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "mili_internal.h"
+
+/*****************************************************************
+ * TAG( fam_list )
+ *
+ * Dynamically allocated array of pointers to all currently open
+ * MILI families.
+ */
+extern Mili_family **fam_list;
+
+#define OPEN_INDEX_MAGIC "MILIIDX"
+#define OPEN_INDEX_VERSION (1)
+#define QTY_EXTENT_FIELDS (3)
+
+/* Largest parameter copied into the index. */
+#define OPEN_INDEX_MAX_PARAM_BYTES (1024)
+
+static LONGLONG dir_tail_length(Mili_family *fam, FILE *p_f);
+static LONGLONG open_read_length(Mili_family *fam, FILE *p_f, LONGLONG *dir_ent);
+static Return_value add_extent(Open_index_extent **p_extents, int *p_qty, int file, LONGLONG offset, LONGLONG length);
+static int compare_extents(const void *a, const void *b);
+static int find_extent(Open_index *idx, int file, LONGLONG offset);
+static Bool_type valid_last_file(Mili_family *fam, Open_index *idx);
+
+/*****************************************************************
+ * TAG( mc_set_open_index ) PUBLIC
+ *
+ * Request that an open-time index be written when a family opened
+ * for writing is closed.  Readers use a valid index automatically.
+ */
+Return_value mc_set_open_index(Famid fam_id, Bool_type write_index)
+{
+    Mili_family *fam;
+    Return_value rval;
+
+    rval = validate_fam_id(fam_id);
+    if ( rval != OK )
+    {
+        return rval;
+    }
+    fam = fam_list[fam_id];
+
+    CHECK_WRITE_ACCESS(fam)
+
+    fam->write_open_index = write_index;
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( write_open_index ) PRIVATE
+ *
+ * Write the open-time index for a family about to be closed.  The
+ * regions are copied from the non-state files as written, so must
+ * be called after the last non-state commit.
+ */
+Return_value write_open_index(Mili_family *fam)
+{
+    char fname[M_MAX_NAME_LEN];
+    char iname[M_MAX_NAME_LEN];
+    char tname[M_MAX_NAME_LEN + 4];
+    FILE *p_f;
+    Open_index_extent *extents = NULL;
+    LONGLONG *sizes = NULL;
+    LONGLONG header[QTY_EXTENT_FIELDS];
+    LONGLONG tail, length;
+    LONGLONG version;
+    int qty = 0, first;
+    int fidx, i;
+    File_dir *p_fd;
+    Return_value rval = OK;
+
+    if ( fam->access_mode == 'r' )
+    {
+        return OK;
+    }
+
+    /* An index left by an earlier writer no longer matches the files. */
+    make_fnam(OPEN_INDEX, fam, 0, iname);
+    if ( !fam->write_open_index || fam->file_count < 1 )
+    {
+        unlink(iname);
+        return OK;
+    }
+
+    sizes = NEW_N(LONGLONG, fam->file_count, "Open index file sizes");
+    if ( sizes == NULL )
+    {
+        return ALLOC_FAILED;
+    }
+
+    /* Collect and read the regions of each non-state file. */
+    for ( fidx = 0; fidx < fam->file_count && rval == OK; fidx++ )
+    {
+        make_fnam(NON_STATE_DATA, fam, fidx, fname);
+        rval = open_buffered(fname, "rb", &p_f, &sizes[fidx]);
+        if ( rval != OK )
+        {
+            break;
+        }
+
+        first = qty;
+        tail = dir_tail_length(fam, p_f);
+        if ( tail <= 0 || tail > sizes[fidx] )
+        {
+            rval = BAD_LOAD_READ;
+        }
+        else
+        {
+            rval = add_extent(&extents, &qty, fidx, sizes[fidx] - tail, tail);
+        }
+
+        p_fd = fam->directory + fidx;
+        for ( i = 0; i < p_fd->qty_entries && rval == OK; i++ )
+        {
+            length = open_read_length(fam, p_f, p_fd->dir_entries[i]);
+            if ( length > 0 )
+            {
+                rval = add_extent(&extents, &qty, fidx, p_fd->dir_entries[i][OFFSET_IDX], length);
+            }
+        }
+
+        for ( i = first; i < qty && rval == OK; i++ )
+        {
+            extents[i].data = NEW_N(char, extents[i].length, "Open index extent");
+            if ( extents[i].data == NULL )
+            {
+                rval = ALLOC_FAILED;
+            }
+            else if ( fseek(p_f, extents[i].offset, SEEK_SET) != 0 )
+            {
+                rval = SEEK_FAILED;
+            }
+            else if ( fread(extents[i].data, 1, extents[i].length, p_f) != (size_t)extents[i].length )
+            {
+                rval = SHORT_READ;
+            }
+        }
+
+        fclose(p_f);
+    }
+
+    /* Write to a temporary name so readers never see a partial index. */
+    if ( rval == OK )
+    {
+        qsort(extents, qty, sizeof(Open_index_extent), compare_extents);
+
+        sprintf(tname, "%s.tmp", iname);
+        p_f = fopen(tname, "wb");
+        if ( p_f == NULL )
+        {
+            rval = OPEN_FAILED;
+        }
+        else
+        {
+            version = OPEN_INDEX_VERSION;
+            header[0] = fam->file_count;
+            header[1] = fam->commit_count;
+            header[2] = qty;
+
+            fwrite(OPEN_INDEX_MAGIC, 1, 8, p_f);
+            fwrite(&version, sizeof(LONGLONG), 1, p_f);
+            fwrite(fam->char_header, 1, CHAR_HEADER_SIZE, p_f);
+            fwrite(header, sizeof(LONGLONG), QTY_EXTENT_FIELDS, p_f);
+            fwrite(sizes, sizeof(LONGLONG), fam->file_count, p_f);
+            for ( i = 0; i < qty; i++ )
+            {
+                header[0] = extents[i].file;
+                header[1] = extents[i].offset;
+                header[2] = extents[i].length;
+                fwrite(header, sizeof(LONGLONG), QTY_EXTENT_FIELDS, p_f);
+            }
+            for ( i = 0; i < qty; i++ )
+            {
+                fwrite(extents[i].data, 1, extents[i].length, p_f);
+            }
+
+            if ( ferror(p_f) )
+            {
+                rval = SHORT_WRITE;
+            }
+            if ( fclose(p_f) != 0 && rval == OK )
+            {
+                rval = SHORT_WRITE;
+            }
+
+            if ( rval == OK && rename(tname, iname) != 0 )
+            {
+                rval = SHORT_WRITE;
+            }
+            if ( rval != OK )
+            {
+                unlink(tname);
+            }
+        }
+    }
+
+    for ( i = 0; i < qty; i++ )
+    {
+        free(extents[i].data);
+    }
+    free(extents);
+    free(sizes);
+
+    return rval;
+}
+
+/*****************************************************************
+ * TAG( dir_tail_length ) LOCAL
+ *
+ * Byte length of the directory region at the end of a non-state
+ * file, as traversed by load_directories().
+ */
+static LONGLONG dir_tail_length(Mili_family *fam, FILE *p_f)
+{
+    int header[QTY_DIR_HEADER_FIELDS];
+    int hdr_qty;
+    LONGLONG entry_size, states_size;
+
+    hdr_qty = (fam->char_header[DIR_VERSION_IDX] > 1) ? QTY_DIR_HEADER_FIELDS : QTY_DIR_HEADER_FIELDS - 1;
+
+    if ( fseek(p_f, -(hdr_qty * EXT_SIZE(fam, M_INT)), SEEK_END) != 0 ||
+         fam->read_funcs[M_INT](p_f, header, hdr_qty) != hdr_qty )
+    {
+        return 0;
+    }
+
+    entry_size = (fam->char_header[DIR_VERSION_IDX] > 2) ? EXT_SIZE(fam, M_INT8) : EXT_SIZE(fam, M_INT);
+
+    states_size = 0;
+    if ( fam->char_header[DIR_VERSION_IDX] > 1 && !(fam->char_header[HDR_VERSION_IDX] > 2 && fam->write_tfile) )
+    {
+        states_size = (LONGLONG)header[QTY_STATES_IDX] * 20; /* 20 is the size af a statemap. */
+    }
+
+    return hdr_qty * EXT_SIZE(fam, M_INT) + (LONGLONG)header[QTY_ENTRIES_IDX] * QTY_ENTRY_FIELDS * entry_size +
+           states_size + header[NAMES_LEN_IDX];
+}
+
+/*****************************************************************
+ * TAG( open_read_length ) LOCAL
+ *
+ * Number of bytes from the start of a directory entry's data that
+ * are read while opening a family, or 0 if none are.
+ */
+static LONGLONG open_read_length(Mili_family *fam, FILE *p_f, LONGLONG *dir_ent)
+{
+    int conn_hdr[QTY_CONN_HEADER_FIELDS];
+    LONGLONG length;
+
+    switch ( (Dir_entry_type)dir_ent[TYPE_IDX] )
+    {
+        case NODES:
+            /* First and last node idents only. */
+            length = QTY_NODE_TAGS * EXT_SIZE(fam, M_INT);
+            break;
+
+        case ELEM_CONNS:
+            /* Header and first/last element block pairs only. */
+            if ( fseek(p_f, dir_ent[OFFSET_IDX], SEEK_SET) != 0 ||
+                 fam->read_funcs[M_INT](p_f, conn_hdr, QTY_CONN_HEADER_FIELDS) != QTY_CONN_HEADER_FIELDS )
+            {
+                return 0;
+            }
+            length = (QTY_CONN_HEADER_FIELDS + 2 * (LONGLONG)conn_hdr[QTY_BLOCKS_IDX]) * EXT_SIZE(fam, M_INT);
+            break;
+
+        case CLASS_IDENTS:
+        case STATE_VAR_DICT:
+        case STATE_REC_DATA:
+            length = dir_ent[LENGTH_IDX];
+            break;
+
+        case MILI_PARAM:
+        case APPLICATION_PARAM:
+        case TI_PARAM:
+            length = (dir_ent[LENGTH_IDX] <= OPEN_INDEX_MAX_PARAM_BYTES) ? dir_ent[LENGTH_IDX] : 0;
+            break;
+
+        default:
+            length = 0;
+            break;
+    }
+
+    return (length < dir_ent[LENGTH_IDX]) ? length : dir_ent[LENGTH_IDX];
+}
+
+/*****************************************************************
+ * TAG( add_extent ) LOCAL
+ *
+ * Append a file region to a list of index extents.
+ */
+static Return_value add_extent(Open_index_extent **p_extents, int *p_qty, int file, LONGLONG offset, LONGLONG length)
+{
+    Open_index_extent *p_ext;
+
+    *p_extents = RENEW_N(Open_index_extent, *p_extents, *p_qty, 1, "Open index extents");
+    if ( *p_extents == NULL )
+    {
+        return ALLOC_FAILED;
+    }
+
+    p_ext = *p_extents + *p_qty;
+    p_ext->file = file;
+    p_ext->offset = offset;
+    p_ext->length = length;
+    p_ext->data = NULL;
+    (*p_qty)++;
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( compare_extents ) LOCAL
+ *
+ * Order extents by file, then offset, for qsort().
+ */
+static int compare_extents(const void *a, const void *b)
+{
+    const Open_index_extent *p_a = (const Open_index_extent *)a;
+    const Open_index_extent *p_b = (const Open_index_extent *)b;
+
+    if ( p_a->file != p_b->file )
+    {
+        return (p_a->file < p_b->file) ? -1 : 1;
+    }
+    if ( p_a->offset != p_b->offset )
+    {
+        return (p_a->offset < p_b->offset) ? -1 : 1;
+    }
+    return 0;
+}
+
+/*****************************************************************
+ * TAG( load_open_index ) PRIVATE
+ *
+ * Read a family's open-time index if one exists and still matches
+ * the non-state files.  A missing or stale index is not an error;
+ * the family is then opened from its files as usual.
+ */
+Return_value load_open_index(Mili_family *fam)
+{
+#ifndef _MSC_VER
+    char fname[M_MAX_NAME_LEN];
+    FILE *p_f;
+    LONGLONG size, pos, data_pos;
+    LONGLONG *p_ll;
+    LONGLONG version;
+    Open_index *idx;
+    Bool_type valid;
+    int i;
+    Return_value rval;
+
+    fam->open_index = NULL;
+
+    if ( fam->access_mode != 'r' || fam->active_family || fam->ti_only )
+    {
+        return OK;
+    }
+
+    make_fnam(OPEN_INDEX, fam, 0, fname);
+    rval = open_buffered(fname, "rb", &p_f, &size);
+    if ( rval != OK )
+    {
+        return OK;
+    }
+
+    pos = 8 + sizeof(LONGLONG) + CHAR_HEADER_SIZE + QTY_EXTENT_FIELDS * sizeof(LONGLONG);
+    idx = NEW(Open_index, "Open index");
+    if ( idx == NULL || size < pos )
+    {
+        fclose(p_f);
+        free(idx);
+        return (idx == NULL) ? ALLOC_FAILED : OK;
+    }
+
+    /* The whole index is read at once. */
+    idx->buffer = NEW_N(char, size, "Open index buffer");
+    if ( idx->buffer == NULL )
+    {
+        fclose(p_f);
+        free(idx);
+        return ALLOC_FAILED;
+    }
+    valid = (fread(idx->buffer, 1, size, p_f) == (size_t)size);
+    fclose(p_f);
+
+    /* Check identity; the version also rejects other byte orders. */
+    if ( valid )
+    {
+        memcpy(&version, idx->buffer + 8, sizeof(LONGLONG));
+        valid = strncmp(idx->buffer, OPEN_INDEX_MAGIC, 8) == 0 && version == OPEN_INDEX_VERSION &&
+                memcmp(idx->buffer + 8 + sizeof(LONGLONG), fam->char_header, CHAR_HEADER_SIZE) == 0;
+    }
+    if ( valid )
+    {
+        p_ll = (LONGLONG *)(idx->buffer + 8 + sizeof(LONGLONG) + CHAR_HEADER_SIZE);
+        idx->file_count = (int)p_ll[0];
+        idx->commit_count = p_ll[1];
+        idx->extent_qty = (int)p_ll[2];
+        data_pos = pos + ((LONGLONG)idx->file_count + (LONGLONG)idx->extent_qty * QTY_EXTENT_FIELDS) * sizeof(LONGLONG);
+        valid = idx->file_count > 0 && idx->extent_qty > 0 && data_pos <= size;
+    }
+    if ( valid )
+    {
+        idx->file_sizes = (LONGLONG *)(idx->buffer + pos);
+        idx->extents = NEW_N(Open_index_extent, idx->extent_qty, "Open index extents");
+        if ( idx->extents == NULL )
+        {
+            free(idx->buffer);
+            free(idx);
+            return ALLOC_FAILED;
+        }
+
+        p_ll = idx->file_sizes + idx->file_count;
+        for ( i = 0; i < idx->extent_qty && valid; i++, p_ll += QTY_EXTENT_FIELDS )
+        {
+            idx->extents[i].file = p_ll[0];
+            idx->extents[i].offset = p_ll[1];
+            idx->extents[i].length = p_ll[2];
+            idx->extents[i].data = idx->buffer + data_pos;
+            data_pos += p_ll[2];
+            valid = p_ll[0] < (LONGLONG)idx->file_count && p_ll[2] > 0 && data_pos <= size;
+        }
+    }
+
+    /* The non-state files must be unchanged since the index was written. */
+    if ( valid )
+    {
+        valid = valid_last_file(fam, idx);
+    }
+
+    if ( !valid )
+    {
+        if ( mili_verbose )
+        {
+            fprintf(stderr, "Mili - ignoring stale or invalid open index.\n");
+        }
+        free(idx->extents);
+        free(idx->buffer);
+        free(idx);
+        return OK;
+    }
+
+    idx->cur_extent = -1;
+    fam->open_index = idx;
+#endif
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( valid_last_file ) LOCAL
+ *
+ * Check an index against the end of the family's non-state files.
+ * Committed files are not rewritten and an appending writer starts
+ * a new file, so only the last file covered, whose size and commit
+ * count are recorded in the index, and the absence of a file after
+ * it need checking.
+ */
+static Bool_type valid_last_file(Mili_family *fam, Open_index *idx)
+{
+    char fname[M_MAX_NAME_LEN];
+    int header[QTY_DIR_HEADER_FIELDS];
+    int hdr_qty;
+    struct stat file_stat;
+    FILE *p_f;
+    Bool_type valid;
+
+    hdr_qty = (fam->char_header[DIR_VERSION_IDX] > 1) ? QTY_DIR_HEADER_FIELDS : QTY_DIR_HEADER_FIELDS - 1;
+
+    make_fnam(NON_STATE_DATA, fam, idx->file_count - 1, fname);
+    p_f = fopen(fname, "rb");
+    if ( p_f == NULL )
+    {
+        return FALSE;
+    }
+
+    valid = fstat(fileno(p_f), &file_stat) == 0 &&
+            (LONGLONG)file_stat.st_size == idx->file_sizes[idx->file_count - 1] &&
+            fseek(p_f, -(hdr_qty * EXT_SIZE(fam, M_INT)), SEEK_END) == 0 &&
+            fam->read_funcs[M_INT](p_f, header, hdr_qty) == hdr_qty &&
+            (LONGLONG)header[COMMIT_COUNT_IDX] == idx->commit_count;
+    fclose(p_f);
+
+    if ( valid )
+    {
+        make_fnam(NON_STATE_DATA, fam, idx->file_count, fname);
+        valid = stat(fname, &file_stat) != 0;
+    }
+
+    return valid;
+}
+
+/*****************************************************************
+ * TAG( unload_open_index ) PRIVATE
+ *
+ * Release a family's open-time index once it is opened; later reads
+ * go to the non-state files.
+ */
+void unload_open_index(Mili_family *fam)
+{
+    Open_index *idx = fam->open_index;
+
+    if ( idx == NULL )
+    {
+        return;
+    }
+
+    if ( fam->cur_index != -1 && fam->cur_file != NULL )
+    {
+        fclose(fam->cur_file);
+    }
+    fam->cur_file = NULL;
+    fam->cur_index = -1;
+
+    free(idx->extents);
+    free(idx->buffer);
+    free(idx);
+    fam->open_index = NULL;
+}
+
+/*****************************************************************
+ * TAG( find_extent ) LOCAL
+ *
+ * Binary search for the extent holding a file offset; -1 if none.
+ */
+static int find_extent(Open_index *idx, int file, LONGLONG offset)
+{
+    int lo, hi, mid;
+    Open_index_extent *p_ext;
+
+    lo = 0;
+    hi = idx->extent_qty - 1;
+    while ( lo <= hi )
+    {
+        mid = (lo + hi) / 2;
+        p_ext = idx->extents + mid;
+        if ( p_ext->file < file || (p_ext->file == file && p_ext->offset + p_ext->length <= offset) )
+        {
+            lo = mid + 1;
+        }
+        else if ( p_ext->file > file || p_ext->offset > offset )
+        {
+            hi = mid - 1;
+        }
+        else
+        {
+            return mid;
+        }
+    }
+
+    return -1;
+}
+
+/*****************************************************************
+ * TAG( open_index_file_open ) PRIVATE
+ *
+ * Index counterpart of non_state_file_open(); the file itself is
+ * only opened if a read falls outside the indexed regions.
+ */
+Return_value open_index_file_open(Mili_family *fam, int index)
+{
+    Open_index *idx = fam->open_index;
+
+    if ( index < 0 || index >= idx->file_count )
+    {
+        return OPEN_FAILED;
+    }
+
+    if ( fam->cur_index != index )
+    {
+        if ( fam->cur_index != -1 && fam->cur_file != NULL )
+        {
+            fclose(fam->cur_file);
+        }
+        fam->cur_file = NULL;
+        fam->cur_index = index;
+        fam->cur_file_size = idx->file_sizes[index];
+        fam->next_free_byte = fam->cur_file_size;
+        idx->cur_extent = -1;
+    }
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( open_index_seek ) PRIVATE
+ *
+ * Index counterpart of non_state_file_seek(); positions cur_file on
+ * the indexed copy of the offset when there is one.
+ */
+Return_value open_index_seek(Mili_family *fam, LONGLONG offset)
+{
+#ifndef _MSC_VER
+    Open_index *idx = fam->open_index;
+    Open_index_extent *p_ext;
+    char fname[M_MAX_NAME_LEN];
+    LONGLONG size;
+    int ext;
+    Return_value rval;
+
+    if ( offset >= fam->next_free_byte )
+    {
+        return SEEK_FAILED;
+    }
+
+    ext = find_extent(idx, fam->cur_index, offset);
+    if ( ext != -1 )
+    {
+        p_ext = idx->extents + ext;
+        if ( ext != idx->cur_extent || fam->cur_file == NULL )
+        {
+            if ( fam->cur_file != NULL )
+            {
+                fclose(fam->cur_file);
+            }
+            fam->cur_file = fmemopen(p_ext->data, p_ext->length, "rb");
+            idx->cur_extent = (fam->cur_file != NULL) ? ext : -1;
+            if ( fam->cur_file == NULL )
+            {
+                return OPEN_FAILED;
+            }
+        }
+        return (fseek(fam->cur_file, offset - p_ext->offset, SEEK_SET) == 0) ? OK : SEEK_FAILED;
+    }
+
+    if ( idx->cur_extent != -1 || fam->cur_file == NULL )
+    {
+        if ( fam->cur_file != NULL )
+        {
+            fclose(fam->cur_file);
+            fam->cur_file = NULL;
+        }
+        idx->cur_extent = -1;
+
+        make_fnam(NON_STATE_DATA, fam, fam->cur_index, fname);
+        rval = open_buffered(fname, "rb", &fam->cur_file, &size);
+        if ( rval != OK )
+        {
+            return rval;
+        }
+    }
+#endif
+
+    return (fseek(fam->cur_file, offset, SEEK_SET) == 0) ? OK : SEEK_FAILED;
+}
+
+/*****************************************************************
+ * TAG( open_index_dir_stream ) PRIVATE
+ *
+ * Open a stream on the indexed directory region of a non-state file.
+ * Offsets from SEEK_END match those in the file itself.
+ */
+FILE *open_index_dir_stream(Open_index *idx, int index)
+{
+#ifndef _MSC_VER
+    Open_index_extent *p_ext;
+    int ext;
+
+    if ( index < 0 || index >= idx->file_count )
+    {
+        return NULL;
+    }
+
+    ext = find_extent(idx, index, idx->file_sizes[index] - 1);
+    if ( ext == -1 )
+    {
+        return NULL;
+    }
+    p_ext = idx->extents + ext;
+
+    return fmemopen(p_ext->data, p_ext->length, "rb");
+#else
+    return NULL;
+#endif
+}
@@ -97,6 +97,36 @@ extern int fam_qty;
  */
 extern int fam_array_length;
 
+/*****************************************************************
+ * TAG( param_table_search ) PRIVATE
+ *
+ * Find a parameter in a family's param table, first entering it
+ * from the directories if it is a TI parameter deferred at open.
+ */
+Return_value param_table_search(Mili_family *fam, char *name, Hash_action op, Htable_entry **pp_hte)
+{
+    Return_value rval;
+    Bool_type found;
+
+    *pp_hte = NULL;
+    rval = htable_search(fam->param_table, name, op, pp_hte);
+    if ( op == FIND_ENTRY && *pp_hte == NULL && fam->ti_params_deferred )
+    {
+        rval = load_ti_param(fam, name, &found);
+        if ( rval != OK )
+        {
+            return rval;
+        }
+        if ( !found )
+        {
+            return ENTRY_NOT_FOUND;
+        }
+        rval = htable_search(fam->param_table, name, op, pp_hte);
+    }
+
+    return rval;
+}
+
 /*****************************************************************
  * TAG( mc_read_scalar ) PUBLIC
  *
@@ -120,7 +150,7 @@ Return_value mc_read_scalar(Famid fam_id, char *name, void *p_value)
         return ENTRY_NOT_FOUND;
     }
 
-    rval = htable_search(fam->param_table, name, FIND_ENTRY, &phte);
+    rval = param_table_search(fam, name, FIND_ENTRY, &phte);
     if ( phte == NULL )
     {
         return rval;
@@ -414,7 +444,7 @@ Return_value mc_read_string(Famid fam_id, char *name, char *p_value)
         return ENTRY_NOT_FOUND;
     }
 
-    status = htable_search(fam->param_table, name, FIND_ENTRY, &phte);
+    status = param_table_search(fam, name, FIND_ENTRY, &phte);
     if ( phte == NULL )
     {
         return status;
@@ -680,7 +710,7 @@ Return_value mc_read_param_array(Famid fam_id, char *name, void **p_data)
         return ENTRY_NOT_FOUND;
     }
 
-    status = htable_search(fam->param_table, name, FIND_ENTRY, &phte);
+    status = param_table_search(fam, name, FIND_ENTRY, &phte);
     if ( phte == NULL )
     {
         return status;
@@ -720,7 +750,7 @@ Return_value mc_read_param_array_len(Famid fam_id, char *name, int *param_array_
         return ENTRY_NOT_FOUND;
     }
 
-    rval = htable_search(fam->param_table, name, FIND_ENTRY, &phte);
+    rval = param_table_search(fam, name, FIND_ENTRY, &phte);
     if ( phte == NULL )
     {
         return rval;
@@ -1062,9 +1092,385 @@ Return_value write_array(Mili_family *fam, int type, char *name, int order, int
         return rval;
     }
 
+    /* A new label array makes the TI label index stale. */
+    delete_ti_label_index(fam);
+
     return OK;
 }
 
+/*****************************************************************
+ * TAG( mc_wrt_params ) PUBLIC
+ *
+ * Write a set of named parameters into the referenced family with
+ * one buffered write.
+ */
+Return_value mc_wrt_params(Famid fam_id, int qty, Named_param *params)
+{
+    Mili_family *fam;
+    Return_value status;
+
+#ifdef SILOENABLED
+    if ( milisilo )
+    {
+        int i;
+
+        for ( i = 0, status = OK; i < qty && status == OK; i++ )
+        {
+            if ( params[i].type == M_STRING )
+            {
+                status = mc_silo_wrt_string(fam_id, params[i].name, (char *)params[i].data);
+            }
+            else if ( params[i].order == 0 )
+            {
+                status = mc_silo_wrt_scalar(fam_id, params[i].type, params[i].name, params[i].data);
+            }
+            else
+            {
+                status = mc_silo_wrt_array(fam_id, params[i].type, params[i].name, params[i].order,
+                                           params[i].dimensions, params[i].data);
+            }
+        }
+        return (status);
+    }
+#endif
+
+    status = validate_fam_id(fam_id);
+    if ( status != OK )
+    {
+        return status;
+    }
+    fam = fam_list[fam_id];
+
+    if ( fam->access_mode == 'r' )
+    {
+        return BAD_ACCESS_TYPE;
+    }
+
+    if ( fam->param_table == NULL )
+    {
+        fam->param_table = htable_create(DEFAULT_HASH_TABLE_SIZE);
+        if ( fam->param_table == NULL )
+        {
+            return ALLOC_FAILED;
+        }
+    }
+
+    status = write_params(fam, qty, params, APPLICATION_PARAM);
+    return status;
+}
+
+/*****************************************************************
+ * TAG( write_params ) PRIVATE
+ *
+ * Write a set of parameters into the referenced family.  New
+ * parameters are written back to back after a single positioning
+ * of the file, so that the stream buffers them into a few large
+ * writes, and their directory entries are added together.  Scalars
+ * and strings that already exist are re-written in place afterwards
+ * as write_scalar() and write_string() would.
+ */
+Return_value write_params(Mili_family *fam, int qty, Named_param *params, Dir_entry_type etype)
+{
+    static char pad[8] = {'\0'};
+    Named_param *p_np;
+    Dir_entry *entries;
+    char **names;
+    Htable_entry **phtes, *phte;
+    Bool_type *rewrite;
+    Param_ref **refs;
+    int *i_buf;
+    int i, j, atoms, new_qty, first_entry, fidx;
+    LONGLONG outbytes, total_bytes, s_len, write_ct;
+    Return_value rval;
+
+    /* Check the input data before doing anything. */
+    for ( i = 0; i < qty; i++ )
+    {
+        p_np = params + i;
+        if ( p_np->name == NULL || *p_np->name == '\0' )
+        {
+            return INVALID_NAME;
+        }
+        if ( p_np->type < M_STRING || p_np->type > QTY_PD_ENTRY_TYPES ||
+             (p_np->type == M_STRING && p_np->order != 0) )
+        {
+            return INVALID_DATA_TYPE;
+        }
+        if ( p_np->data == NULL || (p_np->order > 0 && p_np->dimensions == NULL) )
+        {
+            return NULL_POINTER;
+        }
+        if ( p_np->order < 0 )
+        {
+            return INVALID_DIMENSIONALITY;
+        }
+    }
+    if ( qty <= 0 )
+    {
+        return OK;
+    }
+
+    /* Ensure file is open and positioned. */
+    if ( (rval = prep_for_new_data(fam, NON_STATE_DATA)) != OK )
+    {
+        return rval;
+    }
+
+    entries = NEW_N(Dir_entry, qty, "Param batch entries");
+    names = NEW_N(char *, qty, "Param batch names");
+    phtes = NEW_N(Htable_entry *, qty, "Param batch table entries");
+    rewrite = NEW_N(Bool_type, qty, "Param batch rewrites");
+    refs = NEW_N(Param_ref *, qty, "Param batch table refs");
+    i_buf = NULL;
+    if ( entries == NULL || names == NULL || phtes == NULL || rewrite == NULL || refs == NULL )
+    {
+        rval = ALLOC_FAILED;
+    }
+
+    /* Lay out the new parameters and build their directory entries. */
+    new_qty = 0;
+    total_bytes = 0;
+    for ( i = 0; rval == OK && i < qty; i++ )
+    {
+        p_np = params + i;
+
+        /*
+         * Scalars and strings already in the table, or new earlier in
+         * this batch, are re-written once the batch is entered.
+         */
+        if ( p_np->order == 0 )
+        {
+            htable_search(fam->param_table, p_np->name, FIND_ENTRY, &phte);
+            for ( j = 0; phte == NULL && j < i; j++ )
+            {
+                if ( params[j].order == 0 && !rewrite[j] && strcmp(params[j].name, p_np->name) == 0 )
+                {
+                    break;
+                }
+            }
+            if ( phte != NULL || j < i )
+            {
+                rewrite[i] = TRUE;
+                continue;
+            }
+        }
+
+        if ( p_np->type == M_STRING )
+        {
+            outbytes = ROUND_UP_INT((LONGLONG)strlen((char *)p_np->data) + 1, 8);
+            entries[new_qty][MODIFIER1_IDX] = M_STRING;
+            entries[new_qty][MODIFIER2_IDX] = DONT_CARE;
+        }
+        else if ( p_np->order == 0 )
+        {
+            outbytes = EXT_SIZE(fam, p_np->type);
+            entries[new_qty][MODIFIER1_IDX] = p_np->type;
+            entries[new_qty][MODIFIER2_IDX] = SCALAR;
+        }
+        else
+        {
+            for ( j = 0, atoms = 1; j < p_np->order; j++ )
+            {
+                atoms *= p_np->dimensions[j];
+            }
+            outbytes = ((p_np->order + 1) * EXT_SIZE(fam, M_INT)) + atoms * EXT_SIZE(fam, p_np->type);
+            entries[new_qty][MODIFIER1_IDX] = p_np->type;
+            entries[new_qty][MODIFIER2_IDX] = ARRAY;
+        }
+        entries[new_qty][TYPE_IDX] = etype;
+        entries[new_qty][STRING_QTY_IDX] = 1;
+        entries[new_qty][OFFSET_IDX] = fam->next_free_byte + total_bytes;
+        entries[new_qty][LENGTH_IDX] = outbytes;
+        names[new_qty] = p_np->name;
+        new_qty++;
+        total_bytes += outbytes;
+    }
+
+    /* Write the new parameters back to back. */
+    for ( i = 0; rval == OK && i < qty; i++ )
+    {
+        p_np = params + i;
+        if ( rewrite[i] )
+        {
+            continue;
+        }
+
+        if ( p_np->type == M_STRING )
+        {
+            s_len = strlen((char *)p_np->data) + 1;
+            outbytes = ROUND_UP_INT(s_len, 8);
+            write_ct = fam->write_funcs[M_STRING](fam->cur_file, p_np->data, s_len);
+            if ( write_ct == s_len && outbytes > s_len )
+            {
+                write_ct += fam->write_funcs[M_STRING](fam->cur_file, pad, outbytes - s_len);
+            }
+            if ( write_ct != outbytes )
+            {
+                rval = SHORT_WRITE;
+            }
+        }
+        else if ( p_np->order == 0 )
+        {
+            write_ct = (fam->write_funcs[p_np->type])(fam->cur_file, p_np->data, 1);
+            if ( write_ct != 1 )
+            {
+                rval = SHORT_WRITE;
+            }
+        }
+        else
+        {
+            i_buf = RENEW_N(int, i_buf, 0, p_np->order + 1, "Param batch array descr buf");
+            if ( i_buf == NULL )
+            {
+                rval = ALLOC_FAILED;
+                break;
+            }
+            i_buf[0] = p_np->order;
+            for ( j = 0, atoms = 1; j < p_np->order; j++ )
+            {
+                i_buf[j + 1] = p_np->dimensions[j];
+                atoms *= p_np->dimensions[j];
+            }
+            write_ct = fam->write_funcs[M_INT](fam->cur_file, i_buf, p_np->order + 1);
+            if ( write_ct == p_np->order + 1 )
+            {
+                write_ct = (fam->write_funcs[p_np->type])(fam->cur_file, p_np->data, (LONGLONG)atoms);
+                if ( write_ct != atoms )
+                {
+                    rval = SHORT_WRITE;
+                }
+            }
+            else
+            {
+                rval = SHORT_WRITE;
+            }
+        }
+    }
+
+    /* Allocate every table reference before entering any of them. */
+    for ( i = 0; rval == OK && i < qty; i++ )
+    {
+        if ( !rewrite[i] )
+        {
+            refs[i] = NEW(Param_ref, "Param table entry - batch");
+            if ( refs[i] == NULL )
+            {
+                rval = ALLOC_FAILED;
+            }
+        }
+    }
+
+    /*
+     * Enter the new parameters in the param table, then the directory.
+     * A failure removes the entries made here, so no entry is left
+     * without data.
+     */
+    fidx = fam->cur_index;
+    first_entry = fam->directory[fidx].qty_entries;
+    for ( i = 0, j = 0; rval == OK && i < qty; i++ )
+    {
+        p_np = params + i;
+        if ( rewrite[i] )
+        {
+            continue;
+        }
+
+        refs[i]->file_index = fidx;
+        refs[i]->entry_index = first_entry + j++;
+        rval = htable_search(fam->param_table, p_np->name, (p_np->order == 0) ? ENTER_UNIQUE : ENTER_ALWAYS,
+                             &phtes[i]);
+        if ( rval == OK )
+        {
+            phtes[i]->data = (void *)refs[i];
+        }
+        else
+        {
+            phtes[i] = NULL;
+        }
+    }
+    if ( rval == OK )
+    {
+        rval = add_dir_entries(fam, new_qty, entries, names);
+    }
+
+    if ( rval == OK )
+    {
+        fam->next_free_byte += total_bytes;
+
+        for ( i = 0; i < qty; i++ )
+        {
+            p_np = params + i;
+            if ( !rewrite[i] && p_np->order == 0 && p_np->type != M_STRING &&
+                 strncmp(p_np->name, "nproc", strlen("nproc")) == 0 )
+            {
+                fam->num_procs = *(int *)p_np->data;
+            }
+        }
+
+        /* New label arrays make the TI label index stale. */
+        delete_ti_label_index(fam);
+    }
+    else if ( refs != NULL && phtes != NULL )
+    {
+        for ( i = 0; i < qty; i++ )
+        {
+            if ( phtes[i] != NULL )
+            {
+                htable_del_entry(fam->param_table, phtes[i]);
+            }
+            if ( refs[i] != NULL )
+            {
+                free(refs[i]);
+            }
+        }
+    }
+
+    /* Re-write existing scalars and strings in place. */
+    for ( i = 0; rval == OK && i < qty; i++ )
+    {
+        p_np = params + i;
+        if ( !rewrite[i] )
+        {
+            continue;
+        }
+        if ( p_np->type == M_STRING )
+        {
+            rval = write_string(fam, p_np->name, (char *)p_np->data, etype);
+        }
+        else
+        {
+            rval = write_scalar(fam, p_np->type, p_np->name, p_np->data, etype);
+        }
+    }
+
+    if ( entries != NULL )
+    {
+        free(entries);
+    }
+    if ( names != NULL )
+    {
+        free(names);
+    }
+    if ( phtes != NULL )
+    {
+        free(phtes);
+    }
+    if ( rewrite != NULL )
+    {
+        free(rewrite);
+    }
+    if ( refs != NULL )
+    {
+        free(refs);
+    }
+    if ( i_buf != NULL )
+    {
+        free(i_buf);
+    }
+
+    return rval;
+}
+
 /*****************************************************************
  * TAG( mc_get_app_parameter_count ) PUBLIC
  *
@@ -1084,6 +1490,7 @@ int mc_get_app_parameter_count(Famid fam_id)
     Mili_family *fam;
     fam = fam_list[fam_id];
 
+    load_ti_params(fam);
     count = htable_search_wildcard(fam->param_table, 0, FALSE, "*", "NULL", "NULL", list);
     list = (char **)malloc(count * sizeof(char *));
     count = htable_search_wildcard(fam->param_table, 0, FALSE, "*", "NULL", "NULL", list);
@@ -1131,6 +1538,7 @@ void mc_get_app_parameter_names(Famid fam_id, char **names, int in_size)
     Mili_family *fam;
     fam = fam_list[fam_id];
 
+    load_ti_params(fam);
     count = htable_search_wildcard(fam->param_table, 0, FALSE, "*", "NULL", "NULL", list);
     list = (char **)malloc(count * sizeof(char *));
     count = htable_search_wildcard(fam->param_table, 0, FALSE, "*", "NULL", "NULL", list);
@@ -27,6 +27,8 @@
 
 #ifndef _MSC_VER
 #include <unistd.h>
+#include <limits.h>
+#include <sys/uio.h>
 #else
 #include <io.h>
 #endif
@@ -37,6 +39,10 @@
 #define RANGE_QTY (1000)
 #define DFLT_BUF_COUNT 2
 
+#if !defined(_MSC_VER) && !defined(IOV_MAX)
+#define IOV_MAX 1024
+#endif
+
 char *org_names[] = {"Result", "Object"};
 
 /*****************************************************************
@@ -69,6 +75,10 @@ static Return_value get_ro_svars(Mili_family *fam, int state, Sub_srec *p_subrec
                                  void **p_out);
 static Return_value get_oo_svars(Mili_family *fam, int state, Sub_srec *p_subrec, int qty, Translated_ref *refs,
                                  void **p_out);
+static Return_value load_taurus_state(Mili_family *fam, int state, char **pp_rec);
+static Return_value resolve_subrec(Famid fam_id, char *subrec_name, Subrec_ref *p_ref);
+static void locate_subrec_lumps(Mili_family *fam, Subrec_ref *p_ref, int start, int stop, LONGLONG *p_loc,
+                                LONGLONG *p_qty, int *p_type);
 static Return_value translate_reference(Sub_srec *p_subrec, char *result, Svar **pp_svar, Translated_ref *p_tref);
 static Return_value map_subset_spec(Svar *p_svar, int indices[], int index_qty, char *component, int comp_index,
                                     char *sub_component, int sub_comp_index, Translated_ref *p_tref);
@@ -88,6 +98,11 @@ static Return_value def_subrec_from_db(Mili_family *fam, int srec_id, int *i_dat
 static Return_value set_metrics(Mili_family *fam, int data_org, Sub_srec *psubrec, Mesh_object_class_data *p_mocd,
                                 LONGLONG *size);
 static Return_value get_start_index(Mili_family *fam);
+static Return_value pad_state_record(Mili_family *fam, LONGLONG target);
+static int compare_spans(const void *p_a, const void *p_b);
+static Return_value new_state(Famid fam_id, int srec_id, float time, int *p_file_suffix, int *p_file_state_index);
+static Return_value end_state(Famid fam_id, int srec_id);
+static Return_value read_results(Famid fam_id, int state, int subrec_id, int qty, char **results, void *data);
 static int svar_atom_qty(Svar *p_svar);
 
 /*****************************************************************
@@ -127,7 +142,7 @@ Return_value mc_check_subrec_start(Famid fam_id, int srec_id)
         return STATE_NOT_INSTATIATED;
     }
 
-    offset = ftell(fam->cur_st_file) - fam->state_map[fam->state_qty - 1].offset - 8;
+    offset = ftell(fam->cur_st_file) - fam->state_map[fam->state_qty - 1].offset - ST_HEADER_SIZE(fam);
     if ( offset == psr->size )
     {
         return OK;
@@ -294,7 +309,11 @@ Return_value mc_close_srec(Famid fam_id, int srec_id)
         fam->non_state_ready = TRUE;
     }
 
+#ifdef MILI_READER
+    return OK;
+#else
     return mc_write_mili_metadata(fam_id);
+#endif
 }
 
 /*****************************************************************
@@ -679,8 +698,8 @@ Return_value mc_def_subrec(Famid fam_id, int srec_id, char *subrec_name, int org
     psr = fam->srecs[srec_id];
     psubrec->offset = psr->size;
 
-    /* Update the record size. */
-    psr->size += sub_size;
+    /* Update the record size, padded so the next subrecord is aligned. */
+    psr->size = ST_ALIGN(fam, psr->size + sub_size);
 
     /* Save a reference in order of its creation. */
     psr->subrecs = RENEW_N(Sub_srec *, psr->subrecs, psr->qty_subrecs, 1, "Srec data order incr");
@@ -1048,6 +1067,16 @@ static int svar_atom_qty(Svar *p_svar)
     return qty;
 }
 
+/*****************************************************************
+ * TAG( svar_atoms ) PRIVATE
+ *
+ * Quantity of atoms per object in a state variable.
+ */
+int svar_atoms(Svar *p_svar)
+{
+    return svar_atom_qty(p_svar);
+}
+
 /*****************************************************************
  * TAG( mc_get_subrec_def ) PUBLIC
  *
@@ -1791,8 +1820,8 @@ static Return_value def_subrec_from_db(Mili_family *fam, int srec_id, int *i_dat
     /* Offset to subrecord is previous record size. */
     p_subrec->offset = p_sr->size;
 
-    /* Update the record size. */
-    p_sr->size += sub_size;
+    /* Update the record size, padded so the next subrecord is aligned. */
+    p_sr->size = ST_ALIGN(fam, p_sr->size + sub_size);
 
     /* Save a reference in order of its creation. */
     p_sr->subrecs = RENEW_N(Sub_srec *, p_sr->subrecs, p_sr->qty_subrecs, 1, "Srec data order incr");
@@ -1819,6 +1848,23 @@ static Return_value def_subrec_from_db(Mili_family *fam, int srec_id, int *i_dat
  * ordered arrays in the caller's data buffer.
  */
 Return_value mc_read_results(Famid fam_id, int state, int subrec_id, int qty, char **results, void *data)
+{
+    double start;
+    Return_value rval;
+
+    start = io_stats_clock(fam_id);
+    rval = read_results(fam_id, state, subrec_id, qty, results, data);
+    io_stats_time(fam_id, M_STAT_READ_RESULTS, start);
+
+    return rval;
+}
+
+/*****************************************************************
+ * TAG( read_results ) LOCAL
+ *
+ * Read results for mc_read_results().
+ */
+static Return_value read_results(Famid fam_id, int state, int subrec_id, int qty, char **results, void *data)
 {
     Mili_family *fam;
     int st;
@@ -2262,6 +2308,96 @@ static Return_value map_subset_spec(Svar *p_svar, int indices[], int index_qty,
     return OK;
 }
 
+/*****************************************************************
+ * TAG( load_taurus_state ) LOCAL
+ *
+ * Read a whole Taurus state record into the family's state buffer
+ * in one pass over the plot files it spans, using the file sizes
+ * kept when the state map was built.  All Taurus results are
+ * M_FLOAT, so the record is read as one float array.  The last
+ * state read stays buffered for subsequent subrecord requests.
+ */
+static Return_value load_taurus_state(Mili_family *fam, int state, char **pp_rec)
+{
+    State_descriptor *p_sd;
+    LONGLONG rec_size, offset, length, read_atoms, read_cnt, buf_pos;
+    int file_num;
+    Return_value rval;
+
+    if ( fam->taurus_st_buf_state == state )
+    {
+        *pp_rec = fam->taurus_st_buf;
+        return OK;
+    }
+
+    p_sd = fam->state_map + state;
+    rec_size = fam->srecs[p_sd->srec_format]->size;
+    if ( rec_size > fam->taurus_st_buf_size )
+    {
+        free(fam->taurus_st_buf);
+        fam->taurus_st_buf = NEW_N(char, rec_size, "Taurus state buffer");
+        if ( fam->taurus_st_buf == NULL )
+        {
+            fam->taurus_st_buf_size = 0;
+            return ALLOC_FAILED;
+        }
+        fam->taurus_st_buf_size = rec_size;
+    }
+    fam->taurus_st_buf_state = -1;
+
+    file_num = p_sd->file;
+    offset = p_sd->offset + ST_HEADER_SIZE(fam);
+    length = rec_size / EXT_SIZE(fam, M_FLOAT);
+    buf_pos = 0;
+    while ( length > 0 )
+    {
+        if ( file_num >= fam->st_file_count )
+        {
+            return SHORT_READ;
+        }
+        if ( offset >= fam->taurus_file_sizes[file_num] )
+        {
+            offset -= fam->taurus_file_sizes[file_num];
+            file_num++;
+            continue;
+        }
+
+        rval = state_file_open(fam, file_num, fam->access_mode);
+        if ( rval != OK )
+        {
+            return rval;
+        }
+        IO_STAT(fam, seeks, 1)
+        rval = seek_state_file(fam->cur_st_file, offset);
+        if ( rval != OK )
+        {
+            return rval;
+        }
+
+        read_atoms = (fam->taurus_file_sizes[file_num] - offset) / EXT_SIZE(fam, M_FLOAT);
+        if ( read_atoms > length )
+        {
+            read_atoms = length;
+        }
+        read_cnt = fam->state_read_funcs[M_FLOAT](fam->cur_st_file, fam->taurus_st_buf + buf_pos, read_atoms);
+        IO_STAT_XFER(fam, read, M_FLOAT, read_cnt)
+        if ( read_cnt != read_atoms )
+        {
+            return SHORT_READ;
+        }
+
+        length -= read_atoms;
+        buf_pos += read_atoms * internal_sizes[M_FLOAT];
+        offset = 0;
+        file_num++;
+    }
+
+    fam->taurus_st_buf_state = state;
+    *pp_rec = fam->taurus_st_buf;
+
+    return OK;
+}
+
 /*****************************************************************
  * TAG( get_ro_svars ) LOCAL
  *
@@ -2272,12 +2408,11 @@ static Return_value get_ro_svars(Mili_family *fam, int state, Sub_srec *p_subrec
 {
     State_descriptor *p_sd;
     LONGLONG offset;
-    LONGLONG read_cnt, new_read_atoms, read_atoms, length;
-    int file_num;
-    LONGLONG buf_pos;
+    LONGLONG read_cnt, read_atoms;
     int i, j;
     int idx;
     int data_type;
+    char *p_rec;
     char *p_tmp;
     char *p_obuf;
     Bool_type subset;
@@ -2322,96 +2457,40 @@ static Return_value get_ro_svars(Mili_family *fam, int state, Sub_srec *p_subrec
             p_obuf = (char *)p_out[i];
         }
 
-        /* Seek to result array. */
-        p_sd = fam->state_map + state;
-        rval = state_file_open(fam, p_sd->file, fam->access_mode);
-        if ( rval != OK )
-        {
-            break;
-        }
-        offset = p_sd->offset + EXT_SIZE(fam, M_INT) + EXT_SIZE(fam, M_FLOAT) + p_subrec->offset +
-                 p_subrec->lump_offsets[idx];
+        read_atoms = (LONGLONG)p_subrec->lump_atoms[idx];
         if ( fam->db_type == TAURUS_DB_TYPE )
         {
-            file_num = p_sd->file;
-            while ( offset >= fam->cur_st_file_size )
-            {
-                offset -= fam->cur_st_file_size;
-                file_num++;
-            }
-            if ( file_num != p_sd->file )
+            /* Copy the lump out of the buffered state record. */
+            rval = load_taurus_state(fam, state, &p_rec);
+            if ( rval == OK )
             {
-                rval = state_file_close(fam);
-                if ( rval != OK )
-                {
-                    break;
-                }
-                rval = state_file_open(fam, file_num, fam->access_mode);
-                if ( rval != OK )
-                {
-                    break;
-                }
+                memcpy(p_obuf, p_rec + p_subrec->offset + p_subrec->lump_offsets[idx],
+                       read_atoms * internal_sizes[data_type]);
             }
         }
-        rval = seek_state_file(fam->cur_st_file, offset);
-        if ( rval != OK )
+        else
         {
-            break;
-        }
+            /* Seek to result array. */
+            p_sd = fam->state_map + state;
+            rval = state_file_open(fam, p_sd->file, fam->access_mode);
+            if ( rval == OK )
+            {
+                offset = p_sd->offset + ST_HEADER_SIZE(fam) + p_subrec->offset + p_subrec->lump_offsets[idx];
+                IO_STAT(fam, seeks, 1)
+                rval = seek_state_file(fam->cur_st_file, offset);
+            }
 
-        /* Read data. */
-        read_atoms = (LONGLONG)p_subrec->lump_atoms[idx];
-        if ( fam->db_type == TAURUS_DB_TYPE )
-        {
-            length = read_atoms;
-            buf_pos = 0;
-            while ( length > 0 )
+            /* Read data. */
+            if ( rval == OK )
             {
-                if ( offset + length * EXT_SIZE(fam, data_type) <= fam->cur_st_file_size )
+                read_cnt = fam->state_read_funcs[data_type](fam->cur_st_file, p_obuf, read_atoms);
+                IO_STAT_XFER(fam, read, data_type, read_cnt)
+                if ( read_cnt != (LONGLONG)read_atoms )
                 {
-                    read_cnt = fam->state_read_funcs[data_type](fam->cur_st_file, p_obuf + buf_pos, length);
-                    if ( read_cnt < length )
-                    {
-                        rval = SHORT_READ;
-                        break;
-                    }
-                    length = 0;
-                }
-                else
-                {
-                    new_read_atoms = (LONGLONG)(fam->cur_st_file_size - offset) / EXT_SIZE(fam, data_type);
-                    read_cnt = fam->state_read_funcs[data_type](fam->cur_st_file, p_obuf + buf_pos, new_read_atoms);
-                    if ( read_cnt < new_read_atoms )
-                    {
-                        rval = SHORT_READ;
-                        break;
-                    }
-                    offset = 0;
-                    file_num++;
-                    ;
-                    rval = state_file_close(fam);
-                    if ( rval != OK )
-                    {
-                        break;
-                    }
-                    rval = state_file_open(fam, file_num, fam->access_mode);
-                    if ( rval != OK )
-                    {
-                        break;
-                    }
-                    length -= new_read_atoms;
-                    buf_pos += (new_read_atoms * EXT_SIZE(fam, data_type));
+                    rval = SHORT_READ;
                 }
             }
         }
-        else
-        {
-            read_cnt = fam->state_read_funcs[data_type](fam->cur_st_file, p_obuf, read_atoms);
-            if ( read_cnt != (LONGLONG)read_atoms )
-            {
-                rval = SHORT_READ;
-            }
-        }
 
         if ( rval != OK )
         {
@@ -2488,9 +2567,7 @@ static Return_value get_oo_svars(Mili_family *fam, int state, Sub_srec *p_subrec
     LONGLONG offset;
     void (*dist_func)();
     LONGLONG read_cnt, read_atoms;
-    int file_num;
-    LONGLONG length, new_read_atoms;
-    LONGLONG buf_pos;
+    char *p_rec;
     int obj_vec_size, obj_vec_offset;
     int srec_id, superclass;
     int id, qty_facets;
@@ -2585,42 +2662,6 @@ static Return_value get_oo_svars(Mili_family *fam, int state, Sub_srec *p_subrec
     /* Input from file if necessary. */
     if ( read_from_file )
     {
-        p_sd = fam->state_map + state;
-        rval = state_file_open(fam, p_sd->file, fam->access_mode);
-        if ( rval != OK )
-        {
-            return rval;
-        }
-        offset = p_sd->offset + EXT_SIZE(fam, M_INT) + EXT_SIZE(fam, M_FLOAT) + p_subrec->offset;
-        if ( fam->db_type == TAURUS_DB_TYPE )
-        {
-            file_num = p_sd->file;
-            while ( offset >= fam->cur_st_file_size )
-            {
-                offset -= fam->cur_st_file_size;
-                file_num++;
-            }
-            if ( file_num != p_sd->file )
-            {
-                rval = state_file_close(fam);
-                if ( rval != OK )
-                {
-                    return rval;
-                }
-                rval = state_file_open(fam, file_num, fam->access_mode);
-                if ( rval != OK )
-                {
-                    return rval;
-                }
-            }
-        }
-        rval = seek_state_file(fam->cur_st_file, offset);
-        if ( rval != OK )
-        {
-            return rval;
-        }
-
-        /* Read data. */
         if ( M_SURFACE == superclass )
         {
             read_atoms = p_subrec->lump_atoms[0];
@@ -2632,56 +2673,37 @@ static Return_value get_oo_svars(Mili_family *fam, int state, Sub_srec *p_subrec
 
         if ( fam->db_type == TAURUS_DB_TYPE )
         {
-            length = read_atoms;
-            buf_pos = 0;
-            while ( length > 0 )
+            /* Copy the subrecord out of the buffered state record. */
+            rval = load_taurus_state(fam, state, &p_rec);
+            if ( rval != OK )
             {
-                if ( offset + length * EXT_SIZE(fam, data_type) <= fam->cur_st_file_size )
-                {
-                    read_cnt = fam->state_read_funcs[data_type](fam->cur_st_file, (char *)ibuf + buf_pos, length);
-                    if ( read_cnt < (LONGLONG)length )
-                    {
-                        if ( p_bq->buffer_count == 0 )
-                        {
-                            free(ibuf);
-                        }
-                        return SHORT_READ;
-                    }
-                    length = 0;
-                }
-                else
+                if ( p_bq->buffer_count == 0 )
                 {
-                    new_read_atoms = (LONGLONG)(fam->cur_st_file_size - offset) / EXT_SIZE(fam, data_type);
-                    read_cnt =
-                        fam->state_read_funcs[data_type](fam->cur_st_file, (char *)ibuf + buf_pos, new_read_atoms);
-                    if ( read_cnt < new_read_atoms )
-                    {
-                        if ( p_bq->buffer_count == 0 )
-                        {
-                            free(ibuf);
-                        }
-                        return SHORT_READ;
-                    }
-                    offset = 0;
-                    file_num++;
-                    rval = state_file_close(fam);
-                    if ( rval != OK )
-                    {
-                        return rval;
-                    }
-                    rval = state_file_open(fam, file_num, fam->access_mode);
-                    if ( rval != OK )
-                    {
-                        return rval;
-                    }
-                    length -= new_read_atoms;
-                    buf_pos += (new_read_atoms * EXT_SIZE(fam, data_type));
+                    free(ibuf);
                 }
+                return rval;
             }
+            memcpy(ibuf, p_rec + p_subrec->offset, read_atoms * internal_sizes[data_type]);
         }
         else
         {
+            p_sd = fam->state_map + state;
+            rval = state_file_open(fam, p_sd->file, fam->access_mode);
+            if ( rval != OK )
+            {
+                return rval;
+            }
+            offset = p_sd->offset + ST_HEADER_SIZE(fam) + p_subrec->offset;
+            IO_STAT(fam, seeks, 1)
+            rval = seek_state_file(fam->cur_st_file, offset);
+            if ( rval != OK )
+            {
+                return rval;
+            }
+
+            /* Read data. */
             read_cnt = fam->state_read_funcs[data_type](fam->cur_st_file, (char *)ibuf, read_atoms);
+            IO_STAT_XFER(fam, read, data_type, read_cnt)
             if ( read_cnt != read_atoms )
             {
                 if ( p_bq->buffer_count == 0 )
@@ -2946,6 +2968,7 @@ Return_value mc_wrt_stream(Famid fam_id, int type, LONGLONG qty, void *data)
     LONGLONG byte_ct;
 
     write_ct = (fam_list[fam_id]->state_write_funcs[type])(fam_list[fam_id]->cur_st_file, data, qty);
+    IO_STAT_XFER(fam_list[fam_id], write, type, write_ct)
     if ( write_ct != qty )
     {
         return SHORT_WRITE;
@@ -2962,28 +2985,17 @@ Return_value mc_wrt_stream(Famid fam_id, int type, LONGLONG qty, void *data)
 }
 
 /*****************************************************************
- * TAG( mc_wrt_subrec ) PUBLIC
+ * TAG( resolve_subrec ) LOCAL
  *
- * Write state sub-record data to disk.  All "lumps" written in one
- * call are assumed to have the same data type.  For object-ordered
- * data, start and stop indicate order numbers for the objects
- * represented in the subrecord.  For result-ordered data, start and
- * stop indicate order numbers of the state variables (results) in
- * the state vector bound to the subrecord.
+ * Look up a subrecord by name along with the superclass of its
+ * class in the mesh bound to the current state record.
  */
-Return_value mc_wrt_subrec(Famid fam_id, char *subrec_name, int start, int stop, void *data)
+static Return_value resolve_subrec(Famid fam_id, char *subrec_name, Subrec_ref *p_ref)
 {
     Mili_family *fam;
-    Sub_srec *psubrec;
     Htable_entry *subrec_entry;
-    LONGLONG *lump_offsets;
-    LONGLONG loc, qty;
-    int srec_id, mesh_id, superclass;
-    int start_i, stop_i;
-    int type;
+    int srec_id, mesh_id;
     Return_value rval;
-    LONGLONG write_ct;
-    int byte_ct;
 
     fam = fam_list[fam_id];
     rval = htable_search(fam->subrec_table, subrec_name, FIND_ENTRY, &subrec_entry);
@@ -2999,34 +3011,42 @@ Return_value mc_wrt_subrec(Famid fam_id, char *subrec_name, int start, int stop,
         return (rval);
     }
 
-    psubrec = (Sub_srec *)subrec_entry->data;
-    rval = mc_query_family(fam_id, CLASS_SUPERCLASS, &mesh_id, psubrec->mclass, (void *)&superclass);
-    if ( rval != OK )
-    {
-        return rval;
-    }
+    p_ref->psubrec = (Sub_srec *)subrec_entry->data;
+    return mc_query_family(fam_id, CLASS_SUPERCLASS, &mesh_id, p_ref->psubrec->mclass, (void *)&p_ref->superclass);
+}
 
-    rval = mc_query_family(fam_id, CLASS_SUPERCLASS, &mesh_id, psubrec->mclass, (void *)&superclass);
-    if ( rval != OK )
-    {
-        return rval;
-    }
+/*****************************************************************
+ * TAG( locate_subrec_lumps ) LOCAL
+ *
+ * Compute the current-state file offset, atom count and data type
+ * of lumps start through stop of a resolved subrecord.
+ */
+static void locate_subrec_lumps(Mili_family *fam, Subrec_ref *p_ref, int start, int stop, LONGLONG *p_loc,
+                                LONGLONG *p_qty, int *p_type)
+{
+    Sub_srec *psubrec;
+    LONGLONG *lump_offsets;
+    int start_i, stop_i;
+    int type;
 
+    psubrec = p_ref->psubrec;
     start_i = start - 1;
-    type = *psubrec->svars[start_i]->data_type;
+
+    /* Object-ordered lumps are objects, whose svars share one type (see mc_def_subrec). */
+    type = *psubrec->svars[(psubrec->organization == OBJECT_ORDERED) ? 0 : start_i]->data_type;
 
     if ( psubrec->organization == OBJECT_ORDERED )
     {
         /* Calc file offset. */
-        loc = fam->cur_st_offset + psubrec->offset + psubrec->lump_sizes[0] * start_i;
+        *p_loc = fam->cur_st_offset + psubrec->offset + psubrec->lump_sizes[0] * start_i;
         /* Calc atom count. */
-        if ( superclass != M_SURFACE )
+        if ( p_ref->superclass != M_SURFACE )
         {
-            qty = psubrec->lump_atoms[0] * (stop - start + 1);
+            *p_qty = psubrec->lump_atoms[0] * (stop - start + 1);
         }
         else
         {
-            qty = psubrec->lump_atoms[0];
+            *p_qty = psubrec->lump_atoms[0];
         }
     }
     else
@@ -3035,11 +3055,38 @@ Return_value mc_wrt_subrec(Famid fam_id, char *subrec_name, int start, int stop,
         lump_offsets = psubrec->lump_offsets;
 
         /* Calc file offset. */
-        loc = fam->cur_st_offset + psubrec->offset + lump_offsets[start_i];
+        *p_loc = fam->cur_st_offset + psubrec->offset + lump_offsets[start_i];
         /* Calc atom count. */
-        qty = (lump_offsets[stop_i] - lump_offsets[start_i] + psubrec->lump_sizes[stop_i]) / EXT_SIZE(fam, type);
+        *p_qty = (lump_offsets[stop_i] - lump_offsets[start_i] + psubrec->lump_sizes[stop_i]) / EXT_SIZE(fam, type);
+    }
+
+    *p_type = type;
+}
+
+/*****************************************************************
+ * TAG( write_subrec_lumps ) LOCAL
+ *
+ * Write lumps start through stop of a resolved subrecord into the
+ * current state, which must have been begun by mc_new_state().
+ */
+static Return_value write_subrec_lumps(Mili_family *fam, Subrec_ref *p_ref, int start, int stop, void *data)
+{
+    LONGLONG loc, qty;
+    int type;
+    Return_value rval;
+    LONGLONG write_ct;
+    int byte_ct;
+
+    CHECK_WRITE_ACCESS(fam)
+
+    if ( fam->cur_st_file == NULL || fam->state_qty == 0 )
+    {
+        return STATE_NOT_INSTATIATED;
     }
 
+    locate_subrec_lumps(fam, p_ref, start, stop, &loc, &qty, &type);
+
+    IO_STAT(fam, seeks, 1)
     rval = seek_state_file(fam->cur_st_file, loc);
     if ( rval != OK )
     {
@@ -3047,6 +3094,7 @@ Return_value mc_wrt_subrec(Famid fam_id, char *subrec_name, int start, int stop,
     }
 
     write_ct = (fam->state_write_funcs[type])(fam->cur_st_file, data, qty);
+    IO_STAT_XFER(fam, write, type, write_ct)
     if ( write_ct != qty )
     {
         return SHORT_WRITE;
@@ -3057,27 +3105,693 @@ Return_value mc_wrt_subrec(Famid fam_id, char *subrec_name, int start, int stop,
     {
         return INVALID_DATA_TYPE;
     }
-    fam_list[fam_id]->cur_st_file_size += byte_ct;
+    fam->cur_st_file_size += byte_ct;
+
+    if ( fam->th_stream != NULL && p_ref->psubrec->organization == OBJECT_ORDERED )
+    {
+        th_capture(fam, p_ref->psubrec, start, byte_ct, data);
+    }
 
     return OK;
 }
 
 /*****************************************************************
- * TAG( mc_reload_states ) PUBLIC
+ * TAG( mc_wrt_subrec ) PUBLIC
  *
- * External access for codes to call and reload the database times
+ * Write state sub-record data to disk.  All "lumps" written in one
+ * call are assumed to have the same data type.  For object-ordered
+ * data, start and stop indicate order numbers for the objects
+ * represented in the subrecord.  For result-ordered data, start and
+ * stop indicate order numbers of the state variables (results) in
+ * the state vector bound to the subrecord.
  */
-Return_value mc_reload_states(Famid famid)
+Return_value mc_wrt_subrec(Famid fam_id, char *subrec_name, int start, int stop, void *data)
 {
-    return load_static_maps(fam_list[famid], 0, TRUE);
-}
+    Subrec_ref ref;
+    Return_value rval;
 
-/*****************************************************************
- * TAG( mc_end_state ) PUBLIC
- *
- * Close a state and update the mapping in the A file.
- */
-Return_value mc_end_state(Famid fam_id, int srec_id)
+    if ( INVALID_FAM_ID(fam_id) )
+    {
+        return BAD_FAMILY;
+    }
+
+    rval = resolve_subrec(fam_id, subrec_name, &ref);
+    if ( rval != OK )
+    {
+        return rval;
+    }
+
+    return write_subrec_lumps(fam_list[fam_id], &ref, start, stop, data);
+}
+
+/*****************************************************************
+ * TAG( mc_get_subrec_handle ) PUBLIC
+ *
+ * Resolve a subrecord once and return a handle for writing it with
+ * mc_wrt_subrec_h() or mc_wrt_subrecs(), avoiding the name lookup
+ * and class queries on every write.  Handles remain valid until the
+ * family is closed; resolving the same subrecord again returns the
+ * same handle.
+ */
+Return_value mc_get_subrec_handle(Famid fam_id, char *subrec_name, int *p_handle)
+{
+    Mili_family *fam;
+    Subrec_ref ref;
+    Subrec_ref *refs;
+    int i;
+    Return_value rval;
+
+    if ( INVALID_FAM_ID(fam_id) )
+    {
+        return BAD_FAMILY;
+    }
+
+    if ( subrec_name == NULL || p_handle == NULL )
+    {
+        return NULL_POINTER;
+    }
+
+    rval = resolve_subrec(fam_id, subrec_name, &ref);
+    if ( rval != OK )
+    {
+        return rval;
+    }
+
+    fam = fam_list[fam_id];
+    for ( i = 0; i < fam->qty_subrec_refs; i++ )
+    {
+        if ( fam->subrec_refs[i].psubrec == ref.psubrec )
+        {
+            *p_handle = i;
+            return OK;
+        }
+    }
+
+    /* Handles already returned must survive a failed allocation. */
+    refs = RENEW_N(Subrec_ref, fam->subrec_refs, fam->qty_subrec_refs, 1, "Subrec handles");
+    if ( refs == NULL )
+    {
+        return ALLOC_FAILED;
+    }
+    fam->subrec_refs = refs;
+    fam->subrec_refs[fam->qty_subrec_refs] = ref;
+    *p_handle = fam->qty_subrec_refs++;
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( mc_wrt_subrec_h ) PUBLIC
+ *
+ * Write state sub-record data to disk, as mc_wrt_subrec(), for a
+ * subrecord resolved by mc_get_subrec_handle().
+ */
+Return_value mc_wrt_subrec_h(Famid fam_id, int handle, int start, int stop, void *data)
+{
+    Mili_family *fam;
+
+    if ( INVALID_FAM_ID(fam_id) )
+    {
+        return BAD_FAMILY;
+    }
+
+    fam = fam_list[fam_id];
+    if ( handle < 0 || handle >= fam->qty_subrec_refs )
+    {
+        return INVALID_SUBREC_INDEX;
+    }
+
+    return write_subrec_lumps(fam, fam->subrec_refs + handle, start, stop, data);
+}
+
+/*****************************************************************
+ * TAG( mc_get_subrec_extent ) PUBLIC
+ *
+ * Return the current-state file offset and byte extent (including
+ * alignment padding) of a subrecord, so that its data can be written
+ * directly into the state file by another writer.
+ */
+Return_value mc_get_subrec_extent(Famid fam_id, char *subrec_name, LONGLONG *p_offset, LONGLONG *p_size)
+{
+    Mili_family *fam;
+    Htable_entry *subrec_entry;
+    Sub_srec *psubrec;
+    Srec *psr;
+    int i;
+    Return_value rval;
+
+    if ( INVALID_FAM_ID(fam_id) )
+    {
+        return BAD_FAMILY;
+    }
+    fam = fam_list[fam_id];
+
+    if ( fam->cur_st_file == NULL || fam->state_qty == 0 || fam->qty_srecs == 0 )
+    {
+        return STATE_NOT_INSTATIATED;
+    }
+
+    rval = htable_search(fam->subrec_table, subrec_name, FIND_ENTRY, &subrec_entry);
+    if ( subrec_entry == NULL )
+    {
+        return rval;
+    }
+    psubrec = (Sub_srec *)subrec_entry->data;
+
+    psr = fam->srecs[fam->cur_srec_id];
+    for ( i = 0; i < psr->qty_subrecs; i++ )
+    {
+        if ( psr->subrecs[i] == psubrec )
+        {
+            break;
+        }
+    }
+    if ( i == psr->qty_subrecs )
+    {
+        return INVALID_SUBREC_INDEX;
+    }
+
+    *p_offset = fam->state_map[fam->state_qty - 1].offset + ST_HEADER_SIZE(fam) + psubrec->offset;
+    *p_size = ((i + 1 < psr->qty_subrecs) ? psr->subrecs[i + 1]->offset : psr->size) - psubrec->offset;
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( Lump_write ) LOCAL
+ *
+ * A resolved subrecord write: where it lands in the state file
+ * and what is written there.
+ */
+typedef struct _lump_write
+{
+    LONGLONG loc;
+    LONGLONG qty;
+    LONGLONG bytes;
+    int type;
+    void *data;
+    Sub_srec *psubrec;
+    int start;
+} Lump_write;
+
+#ifndef _MSC_VER
+/*****************************************************************
+ * TAG( gather_write_lumps ) LOCAL
+ *
+ * Write resolved subrecord data with positioned vector writes,
+ * one system call per run of file-contiguous writes (in call
+ * order).  Data needing byte swaps is swapped into a single
+ * scratch buffer first.  The stdio stream is flushed before and
+ * repositioned after so that buffered and direct I/O stay coherent.
+ */
+static Return_value gather_write_lumps(Mili_family *fam, int qty, Lump_write *lumps)
+{
+    struct iovec *iov;
+    unsigned char *swapdata, *p_swap;
+    LONGLONG total, run_bytes, end;
+    ssize_t written;
+    int fd;
+    int i, run_start, iov_qty;
+    Return_value rval;
+
+    iov = NEW_N(struct iovec, qty, "Subrec write vector");
+    if ( iov == NULL )
+    {
+        return ALLOC_FAILED;
+    }
+
+    swapdata = NULL;
+    if ( fam->swap_bytes )
+    {
+        total = 0;
+        for ( i = 0; i < qty; i++ )
+        {
+            total += lumps[i].bytes;
+        }
+        swapdata = NEW_N(unsigned char, total, "Subrec swap buffer");
+        if ( swapdata == NULL )
+        {
+            free(iov);
+            return ALLOC_FAILED;
+        }
+    }
+
+    p_swap = swapdata;
+    for ( i = 0; i < qty; i++ )
+    {
+        if ( swapdata != NULL && EXT_SIZE(fam, lumps[i].type) > 1 )
+        {
+            swap_bytes(lumps[i].qty, EXT_SIZE(fam, lumps[i].type), lumps[i].data, p_swap);
+            iov[i].iov_base = p_swap;
+            p_swap += lumps[i].bytes;
+        }
+        else
+        {
+            iov[i].iov_base = lumps[i].data;
+        }
+        iov[i].iov_len = lumps[i].bytes;
+    }
+
+    rval = OK;
+    if ( fflush(fam->cur_st_file) != 0 )
+    {
+        rval = SHORT_WRITE;
+    }
+    fd = fileno(fam->cur_st_file);
+
+    for ( run_start = 0; run_start < qty && rval == OK; run_start += iov_qty )
+    {
+        run_bytes = lumps[run_start].bytes;
+        end = lumps[run_start].loc + run_bytes;
+        for ( iov_qty = 1; run_start + iov_qty < qty && iov_qty < IOV_MAX; iov_qty++ )
+        {
+            if ( lumps[run_start + iov_qty].loc != end )
+            {
+                break;
+            }
+            run_bytes += lumps[run_start + iov_qty].bytes;
+            end += lumps[run_start + iov_qty].bytes;
+        }
+
+        written = pwritev(fd, iov + run_start, iov_qty, (off_t)lumps[run_start].loc);
+        if ( written != run_bytes )
+        {
+            rval = SHORT_WRITE;
+        }
+    }
+
+    /* Leave the stream where the last write in call order ended. */
+    if ( rval == OK )
+    {
+        rval = seek_state_file(fam->cur_st_file, lumps[qty - 1].loc + lumps[qty - 1].bytes);
+    }
+
+    if ( swapdata != NULL )
+    {
+        free(swapdata);
+    }
+    free(iov);
+
+    return rval;
+}
+#endif
+
+/*****************************************************************
+ * TAG( mc_wrt_subrecs ) PUBLIC
+ *
+ * Write data for a set of subrecords in the current state.  Each
+ * entry is interpreted as by mc_wrt_subrec(), naming its subrecord
+ * or, if subrec_name is NULL, giving a handle from
+ * mc_get_subrec_handle().  All file offsets are computed up front
+ * and the data is written directly from the caller's buffers, with
+ * one system call per run of entries that are contiguous in the file.
+ */
+Return_value mc_wrt_subrecs(Famid fam_id, int qty, Subrec_write *writes)
+{
+    Mili_family *fam;
+    Lump_write *lumps;
+    Subrec_ref ref, *p_ref;
+    int i;
+    Return_value rval;
+
+    if ( INVALID_FAM_ID(fam_id) )
+    {
+        return BAD_FAMILY;
+    }
+
+    if ( qty <= 0 )
+    {
+        return OK;
+    }
+
+    if ( writes == NULL )
+    {
+        return NULL_POINTER;
+    }
+
+    fam = fam_list[fam_id];
+
+    CHECK_WRITE_ACCESS(fam)
+
+    if ( fam->cur_st_file == NULL || fam->state_qty == 0 )
+    {
+        return STATE_NOT_INSTATIATED;
+    }
+
+    lumps = NEW_N(Lump_write, qty, "Subrec writes");
+    if ( lumps == NULL )
+    {
+        return ALLOC_FAILED;
+    }
+
+    for ( i = 0; i < qty; i++ )
+    {
+        if ( writes[i].subrec_name != NULL )
+        {
+            rval = resolve_subrec(fam_id, writes[i].subrec_name, &ref);
+            if ( rval != OK )
+            {
+                free(lumps);
+                return rval;
+            }
+            p_ref = &ref;
+        }
+        else if ( writes[i].handle >= 0 && writes[i].handle < fam->qty_subrec_refs )
+        {
+            p_ref = fam->subrec_refs + writes[i].handle;
+        }
+        else
+        {
+            free(lumps);
+            return INVALID_SUBREC_INDEX;
+        }
+
+        locate_subrec_lumps(fam, p_ref, writes[i].start, writes[i].stop, &lumps[i].loc, &lumps[i].qty,
+                            &lumps[i].type);
+
+        lumps[i].bytes = mc_calc_bytecount(lumps[i].type, lumps[i].qty);
+        if ( lumps[i].bytes == 0 )
+        {
+            free(lumps);
+            return INVALID_DATA_TYPE;
+        }
+        lumps[i].data = writes[i].data;
+        lumps[i].psubrec = p_ref->psubrec;
+        lumps[i].start = writes[i].start;
+    }
+
+#ifndef _MSC_VER
+    rval = gather_write_lumps(fam, qty, lumps);
+#else
+    rval = OK;
+    for ( i = 0; i < qty && rval == OK; i++ )
+    {
+        rval = seek_state_file(fam->cur_st_file, lumps[i].loc);
+        if ( rval == OK && (fam->state_write_funcs[lumps[i].type])(fam->cur_st_file, lumps[i].data, lumps[i].qty)
+                               != lumps[i].qty )
+        {
+            rval = SHORT_WRITE;
+        }
+    }
+#endif
+
+    if ( rval == OK )
+    {
+        for ( i = 0; i < qty; i++ )
+        {
+            fam->cur_st_file_size += lumps[i].bytes;
+            IO_STAT_XFER(fam, write, lumps[i].type, lumps[i].qty)
+
+            if ( fam->th_stream != NULL && lumps[i].psubrec->organization == OBJECT_ORDERED )
+            {
+                th_capture(fam, lumps[i].psubrec, lumps[i].start, lumps[i].bytes, lumps[i].data);
+            }
+        }
+    }
+
+    free(lumps);
+
+    return rval;
+}
+
+/*****************************************************************
+ * TAG( mc_reload_states ) PUBLIC
+ *
+ * External access for codes to call and reload the database times
+ */
+Return_value mc_reload_states(Famid famid)
+{
+    return load_static_maps(fam_list[famid], 0, TRUE);
+}
+
+/*****************************************************************
+ * TAG( compare_spans ) LOCAL
+ *
+ * qsort() comparison of shared span pointers by offset.
+ */
+static int compare_spans(const void *p_a, const void *p_b)
+{
+    Shared_span *p_sa = *(Shared_span **)p_a;
+    Shared_span *p_sb = *(Shared_span **)p_b;
+
+    if ( p_sa->offset != p_sb->offset )
+    {
+        return (p_sa->offset < p_sb->offset) ? -1 : 1;
+    }
+
+    return 0;
+}
+
+/*****************************************************************
+ * TAG( mc_map_shared_spans ) PUBLIC
+ *
+ * Place the lumps each rank will write within a state record of
+ * format srec_id, for ranks sharing one family.  The offsets hold
+ * for every state of the format, so this is done once, after which
+ * ranks write their spans with mc_wrt_shared_span() (or pwrite()
+ * them into the file named by mc_get_shared_state()).  Spans may
+ * not overlap.
+ */
+Return_value mc_map_shared_spans(Famid fam_id, int srec_id, int qty, Shared_span *spans)
+{
+    Mili_family *fam;
+    Srec *psr;
+    Subrec_ref ref;
+    Shared_span **order;
+    LONGLONG loc, atoms;
+    int i, j, lump_qty;
+    Return_value rval;
+
+    if ( INVALID_FAM_ID(fam_id) )
+    {
+        return BAD_FAMILY;
+    }
+    fam = fam_list[fam_id];
+
+    CHECK_WRITE_ACCESS(fam)
+
+    if ( srec_id < 0 || srec_id >= fam->qty_srecs )
+    {
+        return INVALID_SREC_INDEX;
+    }
+    psr = fam->srecs[srec_id];
+
+    for ( i = 0; i < qty; i++ )
+    {
+        rval = resolve_subrec(fam_id, spans[i].subrec_name, &ref);
+        if ( rval != OK )
+        {
+            return rval;
+        }
+
+        for ( j = 0; j < psr->qty_subrecs && psr->subrecs[j] != ref.psubrec; j++ )
+            ;
+        if ( j == psr->qty_subrecs )
+        {
+            return INVALID_SUBREC_INDEX;
+        }
+
+        lump_qty = (ref.psubrec->organization == OBJECT_ORDERED) ? ref.psubrec->mo_qty : ref.psubrec->qty_svars;
+        if ( spans[i].start < 1 || spans[i].stop < spans[i].start || spans[i].stop > lump_qty )
+        {
+            return INVALID_INDEX;
+        }
+
+        locate_subrec_lumps(fam, &ref, spans[i].start, spans[i].stop, &loc, &atoms, &spans[i].type);
+        spans[i].offset = loc - fam->cur_st_offset + ST_HEADER_SIZE(fam);
+        spans[i].size = atoms * EXT_SIZE(fam, spans[i].type);
+    }
+
+    order = NEW_N(Shared_span *, qty, "Shared span order");
+    if ( qty > 0 && order == NULL )
+    {
+        return ALLOC_FAILED;
+    }
+    for ( i = 0; i < qty; i++ )
+    {
+        order[i] = spans + i;
+    }
+    qsort(order, qty, sizeof(Shared_span *), compare_spans);
+
+    rval = OK;
+    for ( i = 1; i < qty; i++ )
+    {
+        if ( order[i - 1]->offset + order[i - 1]->size > order[i]->offset )
+        {
+            rval = OBJECT_RANGE_OVERLAP;
+            break;
+        }
+    }
+    free(order);
+
+    if ( rval == OK )
+    {
+        fam->shared_spans = TRUE;
+    }
+
+    return rval;
+}
+
+/*****************************************************************
+ * TAG( mc_get_shared_state ) PUBLIC
+ *
+ * Return the state file and offset of the state record begun by the
+ * last mc_new_state(), for ranks writing their spans themselves.
+ */
+Return_value mc_get_shared_state(Famid fam_id, char *state_file_name, LONGLONG *p_offset)
+{
+    Mili_family *fam;
+
+    if ( INVALID_FAM_ID(fam_id) )
+    {
+        return BAD_FAMILY;
+    }
+    fam = fam_list[fam_id];
+
+    if ( fam->cur_st_file == NULL || fam->state_qty == 0 )
+    {
+        return STATE_NOT_INSTATIATED;
+    }
+
+    make_fnam(STATE_DATA, fam, ST_FILE_SUFFIX(fam, fam->cur_st_index), state_file_name);
+    *p_offset = fam->state_map[fam->state_qty - 1].offset;
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( mc_wrt_shared_span ) PUBLIC
+ *
+ * Write one span into the current state record.  Spans of a state
+ * may be written concurrently from multiple threads, between the
+ * mc_new_state() and mc_end_state() calls of the family's owner.
+ */
+Return_value mc_wrt_shared_span(Famid fam_id, Shared_span *span, void *data)
+{
+    Mili_family *fam;
+    LONGLONG loc;
+#ifndef _MSC_VER
+    unsigned char *swapdata, *p_out;
+    LONGLONG done;
+    ssize_t written;
+    int fd;
+#endif
+    Return_value rval = OK;
+
+    if ( INVALID_FAM_ID(fam_id) )
+    {
+        return BAD_FAMILY;
+    }
+    fam = fam_list[fam_id];
+
+    if ( fam->cur_st_file == NULL || fam->state_qty == 0 )
+    {
+        return STATE_NOT_INSTATIATED;
+    }
+    loc = fam->state_map[fam->state_qty - 1].offset + span->offset;
+
+#ifndef _MSC_VER
+    p_out = (unsigned char *)data;
+    swapdata = NULL;
+    if ( fam->swap_bytes && EXT_SIZE(fam, span->type) > 1 )
+    {
+        swapdata = NEW_N(unsigned char, span->size, "Shared span swap buffer");
+        if ( swapdata == NULL )
+        {
+            return ALLOC_FAILED;
+        }
+        swap_bytes(span->size / EXT_SIZE(fam, span->type), EXT_SIZE(fam, span->type), data, swapdata);
+        p_out = swapdata;
+    }
+
+    /* pwrite() leaves the stream position alone, so writers don't race. */
+    fd = fileno(fam->cur_st_file);
+    for ( done = 0; done < span->size; done += written )
+    {
+        written = pwrite(fd, p_out + done, span->size - done, (off_t)(loc + done));
+        if ( written <= 0 )
+        {
+            rval = SHORT_WRITE;
+            break;
+        }
+    }
+
+    if ( swapdata != NULL )
+    {
+        free(swapdata);
+    }
+#else
+    /* No positional writes; spans must be written one at a time. */
+    rval = seek_state_file(fam->cur_st_file, loc);
+    if ( rval == OK
+         && (fam->state_write_funcs[span->type])(fam->cur_st_file, data, span->size / EXT_SIZE(fam, span->type))
+                != span->size / EXT_SIZE(fam, span->type) )
+    {
+        rval = SHORT_WRITE;
+    }
+#endif
+
+    return rval;
+}
+
+/*****************************************************************
+ * TAG( pad_state_record ) LOCAL
+ *
+ * Extend the current state file with zeros to the end of the state
+ * record.  Data already written is never overwritten.
+ */
+static Return_value pad_state_record(Mili_family *fam, LONGLONG target)
+{
+    char zeros[4096];
+    LONGLONG end, qty;
+
+    if ( fseek(fam->cur_st_file, 0, SEEK_END) != 0 )
+    {
+        return SEEK_FAILED;
+    }
+    end = ftell(fam->cur_st_file);
+
+    memset(zeros, 0, sizeof(zeros));
+    while ( end < target )
+    {
+        qty = (target - end < sizeof(zeros)) ? target - end : sizeof(zeros);
+        if ( fwrite(zeros, 1, qty, fam->cur_st_file) != qty )
+        {
+            return SHORT_WRITE;
+        }
+        IO_STAT_XFER(fam, write, M_STRING, qty)
+        end += qty;
+    }
+
+    /* Count data written around the stream as well. */
+    fam->cur_st_file_size = end;
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( mc_end_state ) PUBLIC
+ *
+ * Close a state and update the mapping in the A file.
+ */
+Return_value mc_end_state(Famid fam_id, int srec_id)
+{
+    double start;
+    Return_value rval;
+
+    start = io_stats_clock(fam_id);
+    rval = end_state(fam_id, srec_id);
+    io_stats_time(fam_id, M_STAT_END_STATE, start);
+
+    return rval;
+}
+
+/*****************************************************************
+ * TAG( end_state ) LOCAL
+ *
+ * Complete a state record for mc_end_state().
+ */
+static Return_value end_state(Famid fam_id, int srec_id)
 {
     Mili_family *fam;
     int state_qty;
@@ -3108,12 +3822,35 @@ Return_value mc_end_state(Famid fam_id, int srec_id)
         fseek(fam->cur_st_file, 0, SEEK_END);
     }
 
+    if ( fam->qty_srecs != 0 )
+    {
+        target = fam->state_map[fam->state_qty - 1].offset + fam->srecs[0]->size + ST_HEADER_SIZE(fam);
+    }
+    else // this database has no srecs
+    {
+        target = fam->state_map[fam->state_qty - 1].offset + ST_HEADER_SIZE(fam);
+    }
+
+    if ( fam->state_align > 1 || fam->shared_spans )
+    {
+        /*
+         * Subrecords may be written in any order; pad out the record
+         * before it is synced and published in the state map.
+         */
+        rval = pad_state_record(fam, target);
+        if ( rval != OK )
+        {
+            return rval;
+        }
+    }
+
     /* flush and fsync state file so we guarantee the state data is completely written before updating
      * the state maps with the new state. This prevents issues when xmilics/griz try to read
      * a database while it is being written.
      */
     fflush( fam->cur_st_file ); // Flush buffered state data to OS
     fsync( fileno(fam->cur_st_file) ); // Tell OS to write the data to disk
+    IO_STAT(fam, fsyncs, 1)
 
     /* Add a new entry in the state map. */
     state_qty = fam->state_qty;
@@ -3129,19 +3866,22 @@ Return_value mc_end_state(Famid fam_id, int srec_id)
     if ( rval == OK )
     {
         fam->state_closed = 1;
+#ifndef MILI_READER
         mc_update_visit_file(fam_id);
+#endif
     }
 
-    position = ftell(fam->cur_st_file);
-    if ( fam->qty_srecs != 0 )
+    if ( rval == OK )
     {
-        target = fam->state_map[fam->state_qty - 1].offset + fam->srecs[0]->size + sizeof(int) * 2;
+        rval = th_end_state(fam);
     }
-    else // this database has no srecs
+    if ( rval != OK )
     {
-        target = fam->state_map[fam->state_qty - 1].offset + sizeof(int) * 2;
+        return rval;
     }
 
+    position = ftell(fam->cur_st_file);
+
     if ( position != target )
     {
         return position < target ? INVALID_SR_OFFSET_UNDER : INVALID_SR_OFFSET_OVER;
@@ -3155,6 +3895,23 @@ Return_value mc_end_state(Famid fam_id, int srec_id)
  * Set db to receive data for a new state.
  */
 Return_value mc_new_state(Famid fam_id, int srec_id, float time, int *p_file_suffix, int *p_file_state_index)
+{
+    double start;
+    Return_value rval;
+
+    start = io_stats_clock(fam_id);
+    rval = new_state(fam_id, srec_id, time, p_file_suffix, p_file_state_index);
+    io_stats_time(fam_id, M_STAT_NEW_STATE, start);
+
+    return rval;
+}
+
+/*****************************************************************
+ * TAG( new_state ) LOCAL
+ *
+ * Begin a state record for mc_new_state().
+ */
+static Return_value new_state(Famid fam_id, int srec_id, float time, int *p_file_suffix, int *p_file_state_index)
 {
     Mili_family *fam;
     Return_value rval;
@@ -3190,18 +3947,20 @@ Return_value mc_new_state(Famid fam_id, int srec_id, float time, int *p_file_suf
 
     /* Write state record header. */
     write_ct = (*fam->state_write_funcs[M_FLOAT])(fam->cur_st_file, &time, 1);
+    IO_STAT_XFER(fam, write, M_FLOAT, write_ct)
     if ( write_ct != 1 )
     {
         return SHORT_READ;
     }
     write_ct = (*fam->state_write_funcs[M_INT])(fam->cur_st_file, &srec_id, 1);
+    IO_STAT_XFER(fam, write, M_INT, write_ct)
     if ( write_ct != 1 )
     {
         return SHORT_READ;
     }
 
     /* Update byte count */
-    fam->cur_st_file_size += 8; /* time + srec_id */
+    fam->cur_st_file_size += ST_HEADER_SIZE(fam); /* time + srec_id */
 
     /* Add a new entry in the state map. */
     state_qty = fam->state_qty;
@@ -3254,12 +4013,22 @@ Return_value mc_new_state(Famid fam_id, int srec_id, float time, int *p_file_suf
      * data that Mili writes so it will be positioned properly
      * for application data I/O that needs it.
      */
-    fam->cur_st_offset += EXT_SIZE(fam, M_FLOAT) + EXT_SIZE(fam, M_INT);
+    fam->cur_st_offset += ST_HEADER_SIZE(fam);
+    if ( fam->state_align > 1 )
+    {
+        IO_STAT(fam, seeks, 1)
+        rval = seek_state_file(fam->cur_st_file, fam->cur_st_offset);
+        if ( rval != OK )
+        {
+            return rval;
+        }
+    }
 
     *p_file_suffix = ST_FILE_SUFFIX(fam, fam->cur_st_index);
     *p_file_state_index = fam->file_st_qty - 1;
     fam->state_closed = 0;
-    return OK;
+
+    return th_new_state(fam);
 }
 
 
@@ -3300,8 +4069,8 @@ Return_value mc_rewrite_subrec(Famid fid, char *subrec_name, int start, int stop
     sd = fam_list[fid]->state_map;
     replace_st_offset = sd[st_index - 1].offset;
 
-    /* Add 8 bytes for data at beginning of state files */
-    replace_st_offset += (EXT_SIZE(fam_list[fid], M_INT) + EXT_SIZE(fam_list[fid], M_FLOAT));
+    /* Skip the state record header */
+    replace_st_offset += ST_HEADER_SIZE(fam_list[fid]);
 
     /* Set offset to state to change */
     fam_list[fid]->cur_st_offset = replace_st_offset;
@@ -3435,8 +4204,14 @@ void delete_srecs(Mili_family *fam)
     free(fam->srecs);
     free(fam->srec_meshes);
 
-    /* Delete subrec descriptors. */
+    /* Delete subrec descriptors and handles to them. */
     htable_delete(fam->subrec_table, delete_subrec, TRUE);
+    if ( fam->subrec_refs != NULL )
+    {
+        free(fam->subrec_refs);
+        fam->subrec_refs = NULL;
+        fam->qty_subrec_refs = 0;
+    }
 
     fam->srecs = NULL;
     fam->srec_meshes = NULL;
@@ -3477,7 +4252,7 @@ Return_value build_state_map(Mili_family *fam, Bool_type initial_build)
     p_smap = &fam->state_map;
     readi = fam->state_read_funcs[M_INT];
     readf = fam->state_read_funcs[M_FLOAT];
-    hdr_size = EXT_SIZE(fam, M_INT) + EXT_SIZE(fam, M_FLOAT);
+    hdr_size = ST_HEADER_SIZE(fam);
     rval = OK;
     initial = initial_build;
     if ( !fam->srecs )
@@ -4415,8 +5190,8 @@ Return_value mc_def_subrec_from_subrec(Famid fam_id, int srec_id, Subrecord *in_
     psr = fam->srecs[srec_id];
     psubrec->offset = psr->size;
 
-    /* Update the record size. */
-    psr->size += sub_size;
+    /* Update the record size, padded so the next subrecord is aligned. */
+    psr->size = ST_ALIGN(fam, psr->size + sub_size);
 
     /* Save a reference in order of its creation. */
     psr->subrecs = RENEW_N(Sub_srec *, psr->subrecs, psr->qty_subrecs, 1, "Srec data order incr");
@@ -0,0 +1,900 @@
+/*
+ Copyright (c) 2016, Lawrence Livermore National Security, LLC.
+ Produced at the Lawrence Livermore National Laboratory. Written
+ by Kevin Durrenberger: durrenberger1@llnl.gov. CODE-OCEC-16-056.
+ All rights reserved.
+
+ This file is part of Mili. For details, see <URL describing code
+ and how to download source>.
+
+ Please also read this link-- Our Notice and GNU Lesser General
+ Public License.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License (as published by
+ the Free Software Foundation) version 2.1 dated February 1999.
+
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the IMPLIED WARRANTY OF
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the terms
+ and conditions of the GNU General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+ * Routines for compressed state files.  When a family written with a
+ * state codec is closed, each state file is replaced by a compressed
+ * copy (the state file name with a "z" appended) made of independently
+ * compressed fixed-size blocks.  Readers open a compressed file in
+ * place of a missing state file and decompress only the blocks that
+ * reads touch, so state records and subrecords are still accessed
+ * by their raw offsets.  Families opened for append expand their
+ * state files back to raw form.
+ *
+ * Compressed file layout, in host byte order:
+ *
+ *     char     magic[8]
+ *     int      version, endian_check, codec, shuffle_width
+ *     LONGLONG raw_size, block_size, block_qty
+ *     LONGLONG block_offsets[block_qty + 1]
+ *     compressed blocks; a block whose compressed length equals its
+ *     raw length is stored raw
+ */
+
+#if !defined(_GNU_SOURCE) && defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#include "mili_internal.h"
+
+/*****************************************************************
+ * TAG( fam_list )
+ *
+ * Dynamically allocated array of pointers to all currently open
+ * MILI families.
+ */
+extern Mili_family **fam_list;
+
+#define ZST_MAGIC "MILIZST"
+#define ZST_VERSION (1)
+#define ZST_BLOCK_SIZE (256 * 1024)
+#define ZST_SHUFFLE_WIDTH (4)
+
+/* Failure return for LONGLONG lengths, which may be unsigned. */
+#define ZST_FAIL ((LONGLONG)-1)
+
+/* Bytes before the block offsets. */
+#define ZST_HEADER_SIZE (8 + 4 * sizeof(int) + 3 * sizeof(LONGLONG))
+
+typedef struct _zst_file
+{
+    FILE *file;
+    int codec;
+    int shuffle_width;
+    LONGLONG raw_size;
+    LONGLONG block_size;
+    LONGLONG block_qty;
+    LONGLONG *block_offsets;
+    LONGLONG pos;
+    LONGLONG cached_block; /* Block held in raw_buf, ZST_FAIL if none */
+    unsigned char *raw_buf;
+    unsigned char *work_buf;
+    unsigned char *comp_buf;
+} Zst_file;
+
+static void shuffle(unsigned char *p_src, LONGLONG len, int width, unsigned char *p_dest);
+static void unshuffle(unsigned char *p_src, LONGLONG len, int width, unsigned char *p_dest);
+static LONGLONG put_literals(unsigned char *p_src, LONGLONG qty, unsigned char *p_dest, LONGLONG out, LONGLONG limit);
+static LONGLONG rle_encode(unsigned char *p_src, LONGLONG len, unsigned char *p_dest, LONGLONG limit);
+static LONGLONG rle_decode(unsigned char *p_src, LONGLONG len, unsigned char *p_dest, LONGLONG limit);
+static LONGLONG encode_block(int codec, int width, unsigned char *p_raw, LONGLONG len, unsigned char *p_work,
+                             unsigned char *p_dest, LONGLONG limit);
+static Return_value write_compressed(FILE *p_in, LONGLONG raw_size, int codec, FILE *p_out);
+static Return_value compress_state_file(char *fname, int codec);
+static Return_value expand_state_file(char *fname);
+static Zst_file *zst_open(char *zname);
+static void zst_delete(Zst_file *zf);
+static Return_value zst_load_block(Zst_file *zf, LONGLONG block);
+static LONGLONG zst_read(Zst_file *zf, unsigned char *p_dest, LONGLONG len);
+
+/*****************************************************************
+ * TAG( mc_set_state_compression ) PUBLIC
+ *
+ * Select the codec used to compress a writable family's state files
+ * when it is closed.  M_CODEC_NONE leaves them uncompressed.
+ */
+Return_value mc_set_state_compression(Famid fam_id, int codec)
+{
+    Mili_family *fam;
+    Return_value rval;
+
+    rval = validate_fam_id(fam_id);
+    if ( rval != OK )
+    {
+        return rval;
+    }
+    fam = fam_list[fam_id];
+
+    CHECK_WRITE_ACCESS(fam)
+
+    if ( !state_codec_available(codec) )
+    {
+        return NOT_APPLICABLE;
+    }
+
+    fam->state_codec = codec;
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( state_codec_available ) PRIVATE
+ *
+ * TRUE if a state codec is known and built into the library.
+ */
+Bool_type state_codec_available(int codec)
+{
+    switch ( codec )
+    {
+        case M_CODEC_NONE:
+        case M_CODEC_RLE:
+            return TRUE;
+#ifdef HAVE_ZLIB
+        case M_CODEC_ZLIB:
+            return TRUE;
+#endif
+        default:
+            return FALSE;
+    }
+}
+
+/*****************************************************************
+ * TAG( shuffle, unshuffle ) LOCAL
+ *
+ * Regroup bytes so that byte k of every width-byte word is stored
+ * together, which makes exponent and high mantissa bytes of smooth
+ * fields highly repetitive.  Trailing bytes are copied as-is.
+ */
+static void shuffle(unsigned char *p_src, LONGLONG len, int width, unsigned char *p_dest)
+{
+    LONGLONG words, i;
+    int k;
+
+    words = len / width;
+    for ( k = 0; k < width; k++ )
+    {
+        for ( i = 0; i < words; i++ )
+        {
+            *p_dest++ = p_src[i * width + k];
+        }
+    }
+    memcpy(p_dest, p_src + words * width, len - words * width);
+}
+
+static void unshuffle(unsigned char *p_src, LONGLONG len, int width, unsigned char *p_dest)
+{
+    LONGLONG words, i;
+    int k;
+
+    words = len / width;
+    for ( k = 0; k < width; k++ )
+    {
+        for ( i = 0; i < words; i++ )
+        {
+            p_dest[i * width + k] = *p_src++;
+        }
+    }
+    memcpy(p_dest + words * width, p_src, len - words * width);
+}
+
+/*****************************************************************
+ * TAG( put_literals, rle_encode, rle_decode ) LOCAL
+ *
+ * Byte run-length coding.  A control byte c < 128 is followed by
+ * c + 1 literal bytes; c >= 128 is followed by one byte repeated
+ * c - 125 times.  Return the output length, or ZST_FAIL if it
+ * would exceed limit.
+ */
+static LONGLONG put_literals(unsigned char *p_src, LONGLONG qty, unsigned char *p_dest, LONGLONG out, LONGLONG limit)
+{
+    LONGLONG n;
+
+    while ( qty > 0 )
+    {
+        n = qty > 128 ? 128 : qty;
+        if ( out + 1 + n > limit )
+        {
+            return ZST_FAIL;
+        }
+        p_dest[out++] = (unsigned char)(n - 1);
+        memcpy(p_dest + out, p_src, n);
+        out += n;
+        p_src += n;
+        qty -= n;
+    }
+
+    return out;
+}
+
+static LONGLONG rle_encode(unsigned char *p_src, LONGLONG len, unsigned char *p_dest, LONGLONG limit)
+{
+    LONGLONG in, out, run, lit_start;
+
+    in = 0;
+    out = 0;
+    lit_start = 0;
+    while ( in < len )
+    {
+        for ( run = 1; in + run < len && run < 130 && p_src[in + run] == p_src[in]; run++ )
+            ;
+
+        if ( run < 3 )
+        {
+            in += run;
+            continue;
+        }
+
+        out = put_literals(p_src + lit_start, in - lit_start, p_dest, out, limit);
+        if ( out == ZST_FAIL || out + 2 > limit )
+        {
+            return ZST_FAIL;
+        }
+        p_dest[out++] = (unsigned char)(run + 125);
+        p_dest[out++] = p_src[in];
+        in += run;
+        lit_start = in;
+    }
+
+    return put_literals(p_src + lit_start, len - lit_start, p_dest, out, limit);
+}
+
+static LONGLONG rle_decode(unsigned char *p_src, LONGLONG len, unsigned char *p_dest, LONGLONG limit)
+{
+    LONGLONG in, out, n;
+    unsigned char c;
+
+    in = 0;
+    out = 0;
+    while ( in < len )
+    {
+        c = p_src[in++];
+        if ( c < 128 )
+        {
+            n = c + 1;
+            if ( in + n > len || out + n > limit )
+            {
+                return ZST_FAIL;
+            }
+            memcpy(p_dest + out, p_src + in, n);
+            in += n;
+        }
+        else
+        {
+            n = c - 125;
+            if ( in >= len || out + n > limit )
+            {
+                return ZST_FAIL;
+            }
+            memset(p_dest + out, p_src[in++], n);
+        }
+        out += n;
+    }
+
+    return out;
+}
+
+/*****************************************************************
+ * TAG( encode_block ) LOCAL
+ *
+ * Compress one block into p_dest.  Return the compressed length, or
+ * len with the raw block copied if compression doesn't reduce it.
+ */
+static LONGLONG encode_block(int codec, int width, unsigned char *p_raw, LONGLONG len, unsigned char *p_work,
+                             unsigned char *p_dest, LONGLONG limit)
+{
+    LONGLONG clen = ZST_FAIL;
+#ifdef HAVE_ZLIB
+    uLongf zlen;
+#endif
+
+    shuffle(p_raw, len, width, p_work);
+
+    switch ( codec )
+    {
+        case M_CODEC_RLE:
+            clen = rle_encode(p_work, len, p_dest, len - 1);
+            break;
+#ifdef HAVE_ZLIB
+        case M_CODEC_ZLIB:
+            zlen = limit;
+            if ( compress2(p_dest, &zlen, p_work, len, Z_BEST_SPEED) == Z_OK && (LONGLONG)zlen < len )
+            {
+                clen = zlen;
+            }
+            break;
+#endif
+        default:
+            break;
+    }
+
+    if ( clen == ZST_FAIL )
+    {
+        memcpy(p_dest, p_raw, len);
+        clen = len;
+    }
+
+    return clen;
+}
+
+/*****************************************************************
+ * TAG( write_compressed ) LOCAL
+ *
+ * Write the compressed form of raw_size bytes read from p_in.
+ */
+static Return_value write_compressed(FILE *p_in, LONGLONG raw_size, int codec, FILE *p_out)
+{
+    char magic[8];
+    int ihdr[4];
+    LONGLONG lhdr[3];
+    LONGLONG *offsets;
+    LONGLONG len, clen, b;
+    unsigned char *raw_buf, *work_buf, *comp_buf;
+    Return_value rval = OK;
+
+    lhdr[0] = raw_size;
+    lhdr[1] = ZST_BLOCK_SIZE;
+    lhdr[2] = (raw_size + ZST_BLOCK_SIZE - 1) / ZST_BLOCK_SIZE;
+
+    offsets = NEW_N(LONGLONG, lhdr[2] + 1, "Compressed block offsets");
+    raw_buf = NEW_N(unsigned char, ZST_BLOCK_SIZE, "Compress raw buffer");
+    work_buf = NEW_N(unsigned char, ZST_BLOCK_SIZE, "Compress work buffer");
+    comp_buf = NEW_N(unsigned char, 2 * ZST_BLOCK_SIZE, "Compress output buffer");
+    if ( offsets == NULL || raw_buf == NULL || work_buf == NULL || comp_buf == NULL )
+    {
+        rval = ALLOC_FAILED;
+    }
+
+    if ( rval == OK )
+    {
+        memset(magic, 0, sizeof(magic));
+        strcpy(magic, ZST_MAGIC);
+        ihdr[0] = ZST_VERSION;
+        ihdr[1] = 1;
+        ihdr[2] = codec;
+        ihdr[3] = ZST_SHUFFLE_WIDTH;
+
+        /* Offsets are rewritten once known. */
+        offsets[0] = ZST_HEADER_SIZE + (lhdr[2] + 1) * sizeof(LONGLONG);
+        if ( fwrite(magic, 1, sizeof(magic), p_out) != sizeof(magic) || fwrite(ihdr, sizeof(int), 4, p_out) != 4
+             || fwrite(lhdr, sizeof(LONGLONG), 3, p_out) != 3
+             || fwrite(offsets, sizeof(LONGLONG), lhdr[2] + 1, p_out) != (size_t)(lhdr[2] + 1) )
+        {
+            rval = SHORT_WRITE;
+        }
+    }
+
+    for ( b = 0; b < lhdr[2] && rval == OK; b++ )
+    {
+        len = raw_size - b * ZST_BLOCK_SIZE < ZST_BLOCK_SIZE ? raw_size - b * ZST_BLOCK_SIZE : ZST_BLOCK_SIZE;
+        if ( fread(raw_buf, 1, len, p_in) != (size_t)len )
+        {
+            rval = SHORT_READ;
+            break;
+        }
+        clen = encode_block(codec, ZST_SHUFFLE_WIDTH, raw_buf, len, work_buf, comp_buf, 2 * ZST_BLOCK_SIZE);
+        if ( fwrite(comp_buf, 1, clen, p_out) != (size_t)clen )
+        {
+            rval = SHORT_WRITE;
+            break;
+        }
+        offsets[b + 1] = offsets[b] + clen;
+    }
+
+    if ( rval == OK
+         && (fseek(p_out, ZST_HEADER_SIZE, SEEK_SET) != 0
+             || fwrite(offsets, sizeof(LONGLONG), lhdr[2] + 1, p_out) != (size_t)(lhdr[2] + 1)) )
+    {
+        rval = SHORT_WRITE;
+    }
+
+    free(offsets);
+    free(raw_buf);
+    free(work_buf);
+    free(comp_buf);
+
+    return rval;
+}
+
+/*****************************************************************
+ * TAG( compress_state_file ) LOCAL
+ *
+ * Replace a state file with its compressed form.  The compressed
+ * file is written under a temporary name and renamed into place
+ * before the raw file is removed.
+ */
+static Return_value compress_state_file(char *fname, int codec)
+{
+    char zname[M_MAX_NAME_LEN + 2];
+    char tname[M_MAX_NAME_LEN + 6];
+    struct stat file_stat;
+    FILE *p_in, *p_out;
+    Return_value rval;
+
+    if ( stat(fname, &file_stat) != 0 )
+    {
+        return OK;
+    }
+
+    sprintf(zname, "%sz", fname);
+    sprintf(tname, "%sz.tmp", fname);
+
+    p_in = fopen(fname, "rb");
+    if ( p_in == NULL )
+    {
+        return OPEN_FAILED;
+    }
+    p_out = fopen(tname, "wb");
+    if ( p_out == NULL )
+    {
+        fclose(p_in);
+        return OPEN_FAILED;
+    }
+
+    rval = write_compressed(p_in, file_stat.st_size, codec, p_out);
+
+    fclose(p_in);
+    if ( fclose(p_out) != 0 && rval == OK )
+    {
+        rval = SHORT_WRITE;
+    }
+
+    if ( rval == OK && (rename(tname, zname) != 0 || unlink(fname) != 0) )
+    {
+        rval = OPEN_FAILED;
+    }
+    if ( rval != OK )
+    {
+        unlink(tname);
+    }
+
+    return rval;
+}
+
+/*****************************************************************
+ * TAG( compress_state_files ) PRIVATE
+ *
+ * Compress all state files of a family being closed, if it has a
+ * state codec.
+ */
+Return_value compress_state_files(Mili_family *fam)
+{
+    char fname[M_MAX_NAME_LEN];
+    int i;
+    Return_value rval = OK;
+
+    if ( fam->state_codec == M_CODEC_NONE || fam->access_mode == 'r' )
+    {
+        return OK;
+    }
+
+    for ( i = 0; i < fam->st_file_count && rval == OK; i++ )
+    {
+        make_fnam(STATE_DATA, fam, ST_FILE_SUFFIX(fam, i), fname);
+        rval = compress_state_file(fname, fam->state_codec);
+    }
+
+    return rval;
+}
+
+/*****************************************************************
+ * TAG( expand_state_file ) LOCAL
+ *
+ * Replace a compressed state file with its raw form.
+ */
+static Return_value expand_state_file(char *fname)
+{
+    char zname[M_MAX_NAME_LEN + 2];
+    char tname[M_MAX_NAME_LEN + 6];
+    struct stat file_stat;
+    Zst_file *zf;
+    FILE *p_out;
+    LONGLONG len;
+    Return_value rval = OK;
+
+    sprintf(zname, "%sz", fname);
+    if ( stat(fname, &file_stat) == 0 || stat(zname, &file_stat) != 0 )
+    {
+        return OK;
+    }
+
+    zf = zst_open(zname);
+    if ( zf == NULL )
+    {
+        return CORRUPTED_FILE;
+    }
+
+    sprintf(tname, "%s.tmp", fname);
+    p_out = fopen(tname, "wb");
+    if ( p_out == NULL )
+    {
+        zst_delete(zf);
+        return OPEN_FAILED;
+    }
+
+    while ( zf->pos < zf->raw_size && rval == OK )
+    {
+        len = zst_read(zf, zf->work_buf, zf->block_size);
+        if ( len == 0 || len == ZST_FAIL )
+        {
+            rval = CORRUPTED_FILE;
+        }
+        else if ( fwrite(zf->work_buf, 1, len, p_out) != (size_t)len )
+        {
+            rval = SHORT_WRITE;
+        }
+    }
+
+    zst_delete(zf);
+    if ( fclose(p_out) != 0 && rval == OK )
+    {
+        rval = SHORT_WRITE;
+    }
+
+    if ( rval == OK && (rename(tname, fname) != 0 || unlink(zname) != 0) )
+    {
+        rval = OPEN_FAILED;
+    }
+    if ( rval != OK )
+    {
+        unlink(tname);
+    }
+
+    return rval;
+}
+
+/*****************************************************************
+ * TAG( expand_state_files ) PRIVATE
+ *
+ * Restore the raw state files of a family opened for append.
+ */
+Return_value expand_state_files(Mili_family *fam)
+{
+    char fname[M_MAX_NAME_LEN];
+    int i;
+    Return_value rval;
+
+    rval = state_file_close(fam);
+    for ( i = 0; i < fam->st_file_count && rval == OK; i++ )
+    {
+        make_fnam(STATE_DATA, fam, ST_FILE_SUFFIX(fam, i), fname);
+        rval = expand_state_file(fname);
+    }
+
+    return rval;
+}
+
+/*****************************************************************
+ * TAG( zst_open ) LOCAL
+ *
+ * Open a compressed state file and read its block table.
+ */
+static Zst_file *zst_open(char *zname)
+{
+    Zst_file *zf;
+    char magic[8];
+    int ihdr[4];
+    LONGLONG lhdr[3];
+
+    zf = NEW(Zst_file, "Compressed state file");
+    if ( zf == NULL )
+    {
+        return NULL;
+    }
+    zf->cached_block = ZST_FAIL;
+
+    zf->file = fopen(zname, "rb");
+    if ( zf->file == NULL )
+    {
+        free(zf);
+        return NULL;
+    }
+
+    if ( fread(magic, 1, sizeof(magic), zf->file) != sizeof(magic) || fread(ihdr, sizeof(int), 4, zf->file) != 4
+         || fread(lhdr, sizeof(LONGLONG), 3, zf->file) != 3 || strncmp(magic, ZST_MAGIC, sizeof(magic)) != 0
+         || ihdr[0] != ZST_VERSION || ihdr[1] != 1 || !state_codec_available(ihdr[2]) || ihdr[3] < 1
+         || lhdr[1] < 1 || lhdr[2] != (lhdr[0] + lhdr[1] - 1) / lhdr[1] )
+    {
+        zst_delete(zf);
+        return NULL;
+    }
+
+    zf->codec = ihdr[2];
+    zf->shuffle_width = ihdr[3];
+    zf->raw_size = lhdr[0];
+    zf->block_size = lhdr[1];
+    zf->block_qty = lhdr[2];
+
+    zf->block_offsets = NEW_N(LONGLONG, zf->block_qty + 1, "Compressed block offsets");
+    zf->raw_buf = NEW_N(unsigned char, zf->block_size, "Decompressed block");
+    zf->work_buf = NEW_N(unsigned char, zf->block_size, "Decompress work buffer");
+    zf->comp_buf = NEW_N(unsigned char, 2 * zf->block_size, "Compressed block");
+    if ( zf->block_offsets == NULL || zf->raw_buf == NULL || zf->work_buf == NULL || zf->comp_buf == NULL
+         || fread(zf->block_offsets, sizeof(LONGLONG), zf->block_qty + 1, zf->file) != (size_t)(zf->block_qty + 1) )
+    {
+        zst_delete(zf);
+        return NULL;
+    }
+
+    return zf;
+}
+
+/*****************************************************************
+ * TAG( zst_delete ) LOCAL
+ *
+ * Close a compressed state file and free its buffers.
+ */
+static void zst_delete(Zst_file *zf)
+{
+    if ( zf->file != NULL )
+    {
+        fclose(zf->file);
+    }
+    free(zf->block_offsets);
+    free(zf->raw_buf);
+    free(zf->work_buf);
+    free(zf->comp_buf);
+    free(zf);
+}
+
+/*****************************************************************
+ * TAG( zst_load_block ) LOCAL
+ *
+ * Decompress a block into the block cache.
+ */
+static Return_value zst_load_block(Zst_file *zf, LONGLONG block)
+{
+    LONGLONG raw_len, clen;
+#ifdef HAVE_ZLIB
+    uLongf zlen;
+#endif
+
+    if ( block == zf->cached_block )
+    {
+        return OK;
+    }
+
+    raw_len = zf->raw_size - block * zf->block_size;
+    if ( raw_len > zf->block_size )
+    {
+        raw_len = zf->block_size;
+    }
+    clen = zf->block_offsets[block + 1] - zf->block_offsets[block];
+    if ( clen < 1 || clen > 2 * zf->block_size )
+    {
+        return CORRUPTED_FILE;
+    }
+
+    if ( fseek(zf->file, zf->block_offsets[block], SEEK_SET) != 0 )
+    {
+        return SEEK_FAILED;
+    }
+    if ( clen == raw_len )
+    {
+        if ( fread(zf->raw_buf, 1, raw_len, zf->file) != (size_t)raw_len )
+        {
+            return SHORT_READ;
+        }
+        zf->cached_block = block;
+        return OK;
+    }
+
+    if ( fread(zf->comp_buf, 1, clen, zf->file) != (size_t)clen )
+    {
+        return SHORT_READ;
+    }
+
+    switch ( zf->codec )
+    {
+        case M_CODEC_RLE:
+            if ( rle_decode(zf->comp_buf, clen, zf->work_buf, raw_len) != raw_len )
+            {
+                return CORRUPTED_FILE;
+            }
+            break;
+#ifdef HAVE_ZLIB
+        case M_CODEC_ZLIB:
+            zlen = raw_len;
+            if ( uncompress(zf->work_buf, &zlen, zf->comp_buf, clen) != Z_OK || (LONGLONG)zlen != raw_len )
+            {
+                return CORRUPTED_FILE;
+            }
+            break;
+#endif
+        default:
+            return CORRUPTED_FILE;
+    }
+
+    unshuffle(zf->work_buf, raw_len, zf->shuffle_width, zf->raw_buf);
+    zf->cached_block = block;
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( zst_read ) LOCAL
+ *
+ * Read raw bytes at the current position.  Return the count read,
+ * or ZST_FAIL on error.
+ */
+static LONGLONG zst_read(Zst_file *zf, unsigned char *p_dest, LONGLONG len)
+{
+    LONGLONG done, block, start, n;
+
+    done = 0;
+    while ( done < len && zf->pos < zf->raw_size )
+    {
+        block = zf->pos / zf->block_size;
+        if ( zst_load_block(zf, block) != OK )
+        {
+            return ZST_FAIL;
+        }
+        start = zf->pos - block * zf->block_size;
+        n = zf->block_size - start;
+        if ( n > zf->raw_size - zf->pos )
+        {
+            n = zf->raw_size - zf->pos;
+        }
+        if ( n > len - done )
+        {
+            n = len - done;
+        }
+        memcpy(p_dest + done, zf->raw_buf + start, n);
+        done += n;
+        zf->pos += n;
+    }
+
+    return done;
+}
+
+#if defined(__GLIBC__)
+/*****************************************************************
+ * TAG( zst_cookie_read, zst_cookie_seek, zst_cookie_close ) LOCAL
+ *
+ * stdio stream callbacks presenting a compressed state file as its
+ * raw contents.
+ */
+static ssize_t zst_cookie_read(void *cookie, char *buf, size_t size)
+{
+    LONGLONG len;
+
+    len = zst_read((Zst_file *)cookie, (unsigned char *)buf, size);
+
+    return (len == ZST_FAIL) ? -1 : (ssize_t)len;
+}
+
+static int zst_cookie_seek(void *cookie, off64_t *p_offset, int whence)
+{
+    Zst_file *zf = (Zst_file *)cookie;
+    off64_t pos;
+
+    switch ( whence )
+    {
+        case SEEK_SET:
+            pos = *p_offset;
+            break;
+        case SEEK_CUR:
+            pos = (off64_t)zf->pos + *p_offset;
+            break;
+        case SEEK_END:
+            pos = (off64_t)zf->raw_size + *p_offset;
+            break;
+        default:
+            return -1;
+    }
+    if ( pos < 0 )
+    {
+        return -1;
+    }
+
+    zf->pos = pos;
+    *p_offset = pos;
+
+    return 0;
+}
+
+static int zst_cookie_close(void *cookie)
+{
+    zst_delete((Zst_file *)cookie);
+
+    return 0;
+}
+#endif
+
+/*****************************************************************
+ * TAG( open_state_stream ) PRIVATE
+ *
+ * Open a state file as open_buffered() does.  A state file opened
+ * read-only that is missing but has a compressed form is read
+ * through a stream that decompresses blocks on demand (or, where
+ * custom streams aren't available, from a decompressed temporary
+ * file).
+ */
+Return_value open_state_stream(char *fname, char *mode, FILE **p_file_descr, LONGLONG *p_size)
+{
+    char zname[M_MAX_NAME_LEN + 2];
+    Zst_file *zf;
+    Return_value rval;
+
+    rval = open_buffered(fname, mode, p_file_descr, p_size);
+    if ( rval != OPEN_FAILED || mode[0] != 'r' || strchr(mode, '+') != NULL )
+    {
+        return rval;
+    }
+
+    sprintf(zname, "%sz", fname);
+    zf = zst_open(zname);
+    if ( zf == NULL )
+    {
+        return rval;
+    }
+    *p_size = zf->raw_size;
+
+#if defined(__GLIBC__)
+    {
+        cookie_io_functions_t funcs;
+
+        funcs.read = zst_cookie_read;
+        funcs.write = NULL;
+        funcs.seek = zst_cookie_seek;
+        funcs.close = zst_cookie_close;
+
+        *p_file_descr = fopencookie(zf, "r", funcs);
+        if ( *p_file_descr == NULL )
+        {
+            zst_delete(zf);
+            return OPEN_FAILED;
+        }
+    }
+#else
+    {
+        LONGLONG len;
+        FILE *p_f;
+
+        p_f = tmpfile();
+        if ( p_f == NULL )
+        {
+            zst_delete(zf);
+            return OPEN_FAILED;
+        }
+        while ( zf->pos < zf->raw_size )
+        {
+            len = zst_read(zf, zf->work_buf, zf->block_size);
+            if ( len == 0 || len == ZST_FAIL || fwrite(zf->work_buf, 1, len, p_f) != (size_t)len )
+            {
+                fclose(p_f);
+                zst_delete(zf);
+                return CORRUPTED_FILE;
+            }
+        }
+        zst_delete(zf);
+        rewind(p_f);
+        *p_file_descr = p_f;
+    }
+#endif
+
+    return OK;
+}
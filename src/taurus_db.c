@@ -230,11 +230,13 @@ int taurus_open(char *root_name, char *path, char *mode, Famid *fam_id)
     /* Initialize file indices. */
     fam->cur_index = -1;
     fam->cur_st_index = -1;
+    fam->taurus_st_buf_state = -1;
 
     fam->commit_max = -1;
 
     /* State data file pointer. */
     fam->cur_st_file = NULL;
+    fam->st_file_pool_size = DEFAULT_ST_FILE_POOL_SIZE;
 
     /* Open the family. */
     rval = (Return_value)taurus_open_family(fam, *fam_id, "r");
@@ -1170,12 +1172,9 @@ Return_value taurus_close(Famid fam_id)
 
     if ( fam->cur_st_file != NULL )
     {
-        fclose(fam->cur_st_file);
-        fam->cur_st_file = NULL;
-
-        fam->cur_st_index = -1;
-        fam->cur_st_file_mode = '\0';
+        state_file_close(fam);
     }
+    state_file_pool_close(fam);
 
     taurus_cleanse(fam);
     free(fam);
@@ -1207,6 +1206,15 @@ static void taurus_cleanse(Mili_family *fam)
     if ( fam->state_map != NULL )
         free(fam->state_map);
 
+    if ( fam->taurus_file_sizes != NULL )
+        free(fam->taurus_file_sizes);
+
+    if ( fam->taurus_st_buf != NULL )
+        free(fam->taurus_st_buf);
+
+    if ( fam->st_file_pool != NULL )
+        free(fam->st_file_pool);
+
     if ( fam->directory != NULL )
         delete_dir(fam);
 
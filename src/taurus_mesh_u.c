@@ -465,8 +465,7 @@ static void taurus_delete_mo_data(void *ptr_mo_data)
     free(p_mocd->long_name);
     free(p_mocd->short_name);
 
-    DELETE_LIST(p_mocd->blocks->blocks);
-    free(p_mocd->blocks);
+    delete_block_list(p_mocd->blocks);
 
     free(p_mocd);
 }
@@ -68,6 +68,7 @@ extern int fam_array_length;
 static Return_value set_metrics(Mili_family *fam, int data_org, Sub_srec *psubrec, LONGLONG *size);
 static int make_srec(Mili_family *fam, int mesh_id);
 static int svar_atom_qty(Svar *p_svar);
+static Return_value taurus_get_states_per_file(Mili_family *fam, int ctl[]);
 Return_value taurus_commit_srecs(Mili_family *fam);
 
 /*****************************************************************
@@ -552,18 +553,16 @@ Return_value taurus_get_subrec_def(Famid fam_id, int srec_id, int subrec_id, Sub
 }
 
 /*****************************************************************
- * TAG( taurus_get_states_per_file )
+ * TAG( taurus_get_states_per_file ) LOCAL
  *
- * Open a family of MDG plot files.  Returns -1 if unsuccessful,
- * otherwise returns the number of states in the family.  Note
- * that if the plot file has valid geometry but no states, the
- * routine returns 0.
+ * Stat the files of a Taurus plot family once, keeping their sizes
+ * in the family, and estimate the number of states they can hold.
  */
-int taurus_get_states_per_file(Mili_family *fam, int ctl[], int *file_sz)
+static Return_value taurus_get_states_per_file(Mili_family *fam, int ctl[])
 {
     struct stat statbuf;
     int num_files = 0, geom_sz = 0, state_sz = 0, num_states = 0;
-    int sum = 0, sumsav = 0, max_st = 0;
+    LONGLONG sum = 0, max_st = 0;
     int ndim = 0, numnp = 0, icode = 0, nglbv = 0, it = 0, iu = 0, iv = 0, ia = 0, ixd = 0, xnd = 0, nvqty = 0;
     int nel8 = 0, nv3d = 0, nel2 = 0, nv1d = 0;
     int nel4 = 0, nv2d = 0, activ = 0;
@@ -572,32 +571,47 @@ int taurus_get_states_per_file(Mili_family *fam, int ctl[], int *file_sz)
     int i = 0;
 
     /*
-     * Loop to get the number of files.  Then get the length of each
-     * file.
+     * Count the files, then get the length of each file.  There is no
+     * limit on the family size.
      */
-    i = 0;
-    make_fnam(TAURUS_DATA, fam, i, fname);
-    while ( stat(fname, &statbuf) != -1 )
+    if ( fam->taurus_file_sizes != NULL )
     {
-        i++;
-        make_fnam(TAURUS_DATA, fam, i, fname);
+        free(fam->taurus_file_sizes);
+        fam->taurus_file_sizes = NULL;
     }
-    num_files = i;
 
+    make_fnam(TAURUS_DATA, fam, num_files, fname);
+    while ( stat(fname, &statbuf) == 0 )
+    {
+        num_files++;
+        make_fnam(TAURUS_DATA, fam, num_files, fname);
+    }
+
+    if ( num_files > 0 )
+    {
+        fam->taurus_file_sizes = NEW_N(LONGLONG, num_files, "Taurus file sizes");
+        if ( fam->taurus_file_sizes == NULL )
+        {
+            return ALLOC_FAILED;
+        }
+    }
     for ( i = 0; i < num_files; i++ )
     {
         make_fnam(TAURUS_DATA, fam, i, fname);
-        stat(fname, &statbuf);
-        file_sz[i] = (int)statbuf.st_size;
+        if ( stat(fname, &statbuf) != 0 )
+        {
+            num_files = i;
+            break;
+        }
+        fam->taurus_file_sizes[i] = (LONGLONG)statbuf.st_size;
     }
 
     if ( ctl[0] == 4 )
     {
         ctl[0] = 3;
     }
-    else
 
-        ndim = ctl[0];
+    ndim = ctl[0];
     numnp = ctl[1];
     icode = ctl[2];
     nglbv = ctl[3];
@@ -641,51 +655,47 @@ int taurus_get_states_per_file(Mili_family *fam, int ctl[], int *file_sz)
     geom_sz = (ndim * numnp + 9 * nel8 + 5 * nel4 + 6 * nel2) * EXT_SIZE(fam, M_FLOAT);
     state_sz = (nvqty * numnp + nel8 * nv3dact + nel4 * nv2dact + nel2 * nv1dact + nglbv + 1) * EXT_SIZE(fam, M_FLOAT);
 
-    /*
-     * Calculate the maximum possible number of states.  When(ever) we can
-     * forget IRIX 4.x compatibility, type sum as "long long" (64 bit) and
-     * go back to previous code for max_st calculation to avoid overflow
-     * checking.
-     */
-    max_st = 0;
-    for ( i = 0, sum = -geom_sz; i < num_files; i++ )
+    /* Calculate the maximum possible number of states. */
+    for ( i = 0, sum = 0; i < num_files; i++ )
     {
-        sumsav = sum;
-        sum += file_sz[i];
-        if ( sum < sumsav ) /* oops, overflow */
-        {
-            max_st += sumsav / state_sz;
-            sum = sumsav % state_sz + file_sz[i];
-        }
+        sum += fam->taurus_file_sizes[i];
     }
-    max_st += sum / state_sz;
-    num_states = max_st / num_files;
+    max_st = (sum > (LONGLONG)geom_sz) ? (sum - geom_sz) / state_sz : 0;
+    num_states = (num_files > 0) ? (int)(max_st / num_files) : 0;
 
     fam->st_file_count = num_files;
     fam->states_per_file = num_states;
-    fam->state_qty = max_st;
+    fam->state_qty = (int)max_st;
 
-    return state_sz;
+    return OK;
 }
 
 /*****************************************************************
  * TAG( taurus_build_state_map ) PRIVATE
  *
  * Build file/offset map of state-data records in family.
+ *
+ * Record offsets follow from the file sizes and the record size, so
+ * each state costs only the read of its time.  A record starting
+ * within a file must fit in that file; one starting a file may span
+ * the files that follow it, and the file holding its tail never
+ * starts a new state.  The map is sized from the estimate made by
+ * taurus_get_states_per_file() and is rebuilt from scratch when
+ * initial_build is FALSE.
  */
 Return_value taurus_build_state_map(Mili_family *fam, Bool_type initial_build, int ctl[], int srec_id)
 {
-    State_descriptor **p_smap;
-    int index, end_geom_idx;
+    State_descriptor *p_smap;
+    LONGLONG *file_sz;
+    int index, last;
     int ndim, numnp, nel8, nel4, nel2;
     LONGLONG offset;
     LONGLONG (*readf)();
     float st_time;
-    int state_qty;
-    State_descriptor *p_sd;
-    int *file_sz;
-    int state_size;
-    long remainder;
+    int state_qty, map_qty;
+    LONGLONG state_size;
+    LONGLONG span;
+    Return_value rval;
 
     ndim = ctl[0];
     numnp = ctl[1];
@@ -693,128 +703,119 @@ Return_value taurus_build_state_map(Mili_family *fam, Bool_type initial_build, i
     nel2 = ctl[13];
     nel4 = ctl[16];
 
-    p_smap = &fam->state_map;
+    if ( !initial_build && fam->state_map != NULL )
+    {
+        state_file_close(fam);
+        free(fam->state_map);
+        fam->state_map = NULL;
+        fam->taurus_st_buf_state = -1;
+    }
+
     readf = fam->state_read_funcs[M_FLOAT];
-    if ( initial_build )
+    rval = taurus_get_states_per_file(fam, ctl);
+    if ( rval != OK )
     {
-        index = 0;
-        state_qty = 0;
-        /* We will be in trouble if there are more than 10000 files. */
-        file_sz = NEW_N(int, 10000, "File_sz array");
-        taurus_get_states_per_file(fam, ctl, file_sz);
-        /*  Take into account the geometry data in the first file */
-        offset = 64 * EXT_SIZE(fam, M_INT) + (ndim * numnp + 9 * nel8 + 5 * nel4 + 6 * nel2) * EXT_SIZE(fam, M_FLOAT);
-
-        /* Loop through the files to get the first file with
-         * actual state information
-         */
-        while ( index < fam->st_file_count && offset >= (LONGLONG)file_sz[index] )
-        {
-            offset = offset - file_sz[index];
-            index++;
-        }
+        return rval;
+    }
+    file_sz = fam->taurus_file_sizes;
 
-        /* Something's wrong if we traversed all the files. */
-        if ( index == fam->st_file_count )
-        {
-            free(file_sz);
-            return TAURUS_INCOMPLETE_GEOM;
-        }
-        else
-            end_geom_idx = index;
+    /*  Take into account the geometry data in the first file(s). */
+    offset = 64 * EXT_SIZE(fam, M_INT) + (ndim * numnp + 9 * nel8 + 5 * nel4 + 6 * nel2) * EXT_SIZE(fam, M_FLOAT);
+    index = 0;
+    while ( index < fam->st_file_count && offset >= file_sz[index] )
+    {
+        offset -= file_sz[index];
+        index++;
     }
-    else
+
+    /* Something's wrong if we traversed all the files. */
+    if ( index == fam->st_file_count )
     {
-        index = fam->st_file_count - 1;
-        state_qty = fam->state_qty;
-
-        /*  Take into account the geometry data in the first file */
-        offset = 64 * EXT_SIZE(fam, M_INT) + (ndim * numnp + 9 * nel8 + 5 * nel4 + 6 * nel2) * EXT_SIZE(fam, M_FLOAT);
-        /* Count offset through mapped states in known last file. */
-        for ( p_sd = fam->state_map + fam->state_qty - 1;
-              ((LONGLONG)p_sd >= (LONGLONG)fam->state_map) && p_sd->file == index; p_sd-- )
-            offset += fam->srecs[p_sd->srec_format]->size;
+        fam->state_qty = 0;
+        return TAURUS_INCOMPLETE_GEOM;
+    }
+
+    map_qty = fam->state_qty + 1;
+    p_smap = NEW_N(State_descriptor, map_qty, "Taurus state map");
+    if ( p_smap == NULL )
+    {
+        return ALLOC_FAILED;
     }
 
     /* Traverse the state data files. */
-    state_size = (int)fam->srecs[srec_id]->size;
+    state_size = fam->srecs[srec_id]->size;
     state_qty = 0;
-    st_time = 0.0;
-    while ( state_file_open(fam, index, 'r') == OK )
+    while ( index < fam->st_file_count )
     {
-        /* Traverse the state records within the current file. */
-        while ( (offset == 0 || fam->cur_st_file_size - offset >= (LONGLONG)state_size) &&
-                seek_state_file(fam->cur_st_file, offset) == OK )
+        /* A record starting within a file must fit in it. */
+        if ( file_sz[index] - offset < EXT_SIZE(fam, M_FLOAT) ||
+             (offset > 0 && file_sz[index] - offset < state_size) )
         {
-            /* Read the time. */
-            if ( readf(fam->cur_st_file, &st_time, 1) != 1 )
-                break;
-
-            /* End of data in file? */
-            if ( st_time < 0 )
-                break;
-
-            /* Add a new entry in the state map. */
-            *p_smap = RENEW_N(State_descriptor, *p_smap, state_qty, 1, "Addl state descr");
-
-            (*p_smap)[state_qty].file = index;
-            (*p_smap)[state_qty].offset = offset;
-            (*p_smap)[state_qty].time = st_time;
-            (*p_smap)[state_qty].srec_format = srec_id;
+            offset = 0;
+            index++;
+            continue;
+        }
 
-            state_qty++;
-            fam->state_qty = state_qty;
-            fam->file_st_qty++;
+        /* Find the last file of a record starting this file. */
+        last = index;
+        span = file_sz[index] - offset;
+        while ( span < state_size && last + 1 < fam->st_file_count )
+        {
+            last++;
+            span += file_sz[last];
+        }
 
-            offset += state_size;
+        /* Truncated record at the end of the family. */
+        if ( span < state_size )
+        {
+            break;
         }
 
-        /* Prepare for next file... */
-        if ( st_time < 0 || (LONGLONG)state_size <= fam->cur_st_file_size || index == end_geom_idx )
+        /* Read the time; a negative time ends the data in the file. */
+        if ( state_file_open(fam, index, 'r') != OK )
+        {
+            break;
+        }
+        if ( seek_state_file(fam->cur_st_file, offset) != OK || readf(fam->cur_st_file, &st_time, 1) != 1 ||
+             st_time < 0 )
         {
-            /* End of valid data in file; try next. */
-            state_file_close(fam);
             offset = 0;
             index++;
+            continue;
         }
-        else
-        {
-            /*
-             * State must straddle files.  Loop through files to get past
-             * rest of state.
-             */
-
-            remainder = (int)((LONGLONG)state_size - fam->cur_st_file_size);
 
-            do
-            {
-                state_file_close(fam);
-                index++;
-            } while ( state_file_open(fam, index, 'r') == OK && (remainder -= fam->cur_st_file_size) > 0 );
-
-            if ( remainder <= 0 )
+        if ( state_qty == map_qty )
+        {
+            p_smap = RENEW_N(State_descriptor, p_smap, map_qty, map_qty, "Addl state descr");
+            if ( p_smap == NULL )
             {
-                /*
-                 * Last file with a partial state will never start a new state.
-                 */
-                state_file_close(fam);
-                index++;
-                offset = 0;
+                return ALLOC_FAILED;
             }
+            map_qty *= 2;
         }
-    }
-
-    for ( state_qty = 0; state_qty < fam->state_qty; state_qty++ )
-    {
-        (*p_smap)[state_qty].offset -= (EXT_SIZE(fam, M_INT) + EXT_SIZE(fam, M_FLOAT));
-    }
 
-    fam->st_file_count = index;
+        p_smap[state_qty].file = index;
+        p_smap[state_qty].offset = offset - (EXT_SIZE(fam, M_INT) + EXT_SIZE(fam, M_FLOAT));
+        p_smap[state_qty].time = st_time;
+        p_smap[state_qty].srec_format = srec_id;
+        state_qty++;
 
-    if ( initial_build )
-    {
-        free(file_sz);
+        /* Prepare for the next record. */
+        if ( last == index )
+        {
+            offset += state_size;
+        }
+        else
+        {
+            offset = 0;
+            index = last + 1;
+        }
     }
+    state_file_close(fam);
+
+    fam->state_map = p_smap;
+    fam->state_qty = state_qty;
+    fam->file_st_qty = state_qty;
 
     /*
      * Always return OK because there don't have to be any states,
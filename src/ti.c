@@ -192,6 +192,7 @@ Return_value mc_ti_read_scalar(Famid fam_id, char *name, void *p_value)
         return INVALID_NAME;
     }
 
+    load_ti_params(fam);
     if ( fam->ti_param_table == NULL )
     {
         return ENTRY_NOT_FOUND;
@@ -320,6 +321,7 @@ Return_value mc_ti_read_string(Famid fam_id, char *name, char *p_value)
         return INVALID_NAME;
     }
 
+    load_ti_params(fam);
     if ( fam->ti_param_table == NULL )
     {
         return ENTRY_NOT_FOUND;
@@ -369,7 +371,6 @@ Return_value mc_ti_wrt_string(Famid fam_id, char *name, char *value)
 Return_value read_htable_array(Famid fam_id, char *name, void **p_data, int *num_items_read)
 {
     Htable_entry *phte, *next;
-    Hash_table *table;
     Param_ref *p_pr;
     Mili_family *fam = fam_list[fam_id];
     Return_value status = OK;
@@ -386,8 +387,7 @@ Return_value read_htable_array(Famid fam_id, char *name, void **p_data, int *num
     int current_count = 0;
     *num_items_read = 0;
 
-    table = fam->param_table;
-    status = htable_search(table, name, FIND_ENTRY, &phte);
+    status = param_table_search(fam, name, FIND_ENTRY, &phte);
     if ( status != OK )
     {
         return status;
@@ -739,7 +739,7 @@ Return_value mc_ti_read_array(Famid fam_id, char *name, void **p_data, int *num_
         return read_htable_array(fam_id, name, p_data, num_items_read);
     }
 
-    table = fam->ti_param_table;
+    table = ti_param_htable(fam);
 
     if ( table == NULL )
     {
@@ -803,6 +803,37 @@ Return_value mc_ti_wrt_array(Famid fam_id, int type, char *name, int order, int
     return status;
 }
 
+/*****************************************************************
+ * TAG( mc_ti_wrt_params ) PUBLIC
+ *
+ * Write a set of TI parameters into the referenced family with one
+ * buffered write.
+ */
+Return_value mc_ti_wrt_params(Famid fam_id, int qty, Named_param *params)
+{
+    Mili_family *fam;
+    Return_value status;
+
+    status = validate_fam_id(fam_id);
+    if ( status != OK )
+    {
+        return status;
+    }
+    fam = fam_list[fam_id];
+
+    if ( fam->param_table == NULL )
+    {
+        fam->param_table = htable_create(DEFAULT_HASH_TABLE_SIZE);
+        if ( fam->param_table == NULL )
+        {
+            return ALLOC_FAILED;
+        }
+    }
+
+    status = write_params(fam, qty, params, TI_PARAM);
+    return status;
+}
+
 /*****************************************************************
  * TAG( mc_ti_def_class ) PUBLIC
  *
@@ -1108,14 +1139,7 @@ Bool_type mc_ti_find_var_name(Famid fam_id, char *name, char *class, char **var_
 
     fam = fam_list[fam_id];
 
-    if ( fam->char_header[DIR_VERSION_IDX] > 1 )
-    {
-        table = fam->param_table;
-    }
-    else
-    {
-        table = fam->ti_param_table;
-    }
+    table = ti_param_htable(fam);
     strcpy(vname, name);
     strcat(vname, "[");
     strcpy(sname, "Sname-");
@@ -1163,14 +1187,7 @@ Bool_type mc_ti_verify_var_name(Famid fam_id, char *name)
     Hash_table *table;
 
     fam = fam_list[fam_id];
-    if ( fam->char_header[DIR_VERSION_IDX] > 1 )
-    {
-        table = fam->param_table;
-    }
-    else
-    {
-        table = fam->ti_param_table;
-    }
+    table = ti_param_htable(fam);
     status = ti_htable_search(table, name, FIND_ENTRY, &phte);
 
     if ( status != OK && phte == NULL )
@@ -1215,6 +1232,7 @@ Return_value mc_ti_get_data_attributes(Famid fam_id, int meshid, char *name, cha
     Return_value status;
 
     fam = fam_list[fam_id];
+    load_ti_params(fam);
 
     status = ti_htable_search(fam->ti_param_table, name, FIND_ENTRY, &phte);
 
@@ -1446,14 +1464,7 @@ Return_value mc_ti_get_data_len(Famid fam_id, char *name, int *datatype, int *da
     Return_value status;
     *datalength = 0;
     fam = fam_list[fam_id];
-    if ( fam->char_header[DIR_VERSION_IDX] > 1 )
-    {
-        table = fam->param_table;
-    }
-    else
-    {
-        table = fam->ti_param_table;
-    }
+    table = ti_param_htable(fam);
     status = ti_htable_search(table, name, FIND_ENTRY, &phte);
 
     if ( phte == NULL )
@@ -1670,4 +1681,295 @@ Return_value mc_ti_get_metadata_from_name(char *name, char *class, int *meshid,
     return OK;
 }
 
+/*****************************************************************
+ * TAG( delete_ti_label_class ) LOCAL
+ *
+ * Free a label class entry of the TI label index.
+ */
+static void delete_ti_label_class(void *data)
+{
+    Ti_label_class *p_lc;
+    int i;
+
+    p_lc = (Ti_label_class *)data;
+    if ( p_lc == NULL )
+    {
+        return;
+    }
+
+    for ( i = 0; i < p_lc->qty_conn_labels; i++ )
+    {
+        free(p_lc->conn_labels[i]);
+    }
+    if ( p_lc->conn_labels != NULL )
+    {
+        free(p_lc->conn_labels);
+    }
+    if ( p_lc->node_labels != NULL )
+    {
+        free(p_lc->node_labels);
+    }
+    free(p_lc);
+}
+
+/*****************************************************************
+ * TAG( add_ti_conn_label ) LOCAL
+ *
+ * Append an element label parameter name to a label class.
+ */
+static Return_value add_ti_conn_label(Ti_label_class *p_lc, char *name)
+{
+    p_lc->conn_labels = RENEW_N(char *, p_lc->conn_labels, p_lc->qty_conn_labels, 1, "Label index names");
+    if ( p_lc->conn_labels == NULL )
+    {
+        p_lc->qty_conn_labels = 0;
+        return ALLOC_FAILED;
+    }
+
+    str_dup(&p_lc->conn_labels[p_lc->qty_conn_labels], name);
+    if ( p_lc->conn_labels[p_lc->qty_conn_labels] == NULL )
+    {
+        return ALLOC_FAILED;
+    }
+    p_lc->qty_conn_labels++;
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( label_short_name ) LOCAL
+ *
+ * Extract the class short name from a TI label parameter name, ie
+ * "brick" from "Element Labels[/Mesh-0/Sname-brick/...]".
+ */
+static Bool_type label_short_name(char *name, char *short_name)
+{
+    char *p_sname;
+    int i;
+
+    p_sname = strstr(name, "Sname-");
+    if ( p_sname == NULL )
+    {
+        return FALSE;
+    }
+    p_sname += 6;
+
+    for ( i = 0; i < M_MAX_NAME_LEN - 1; i++ )
+    {
+        if ( p_sname[i] == '/' )
+        {
+            short_name[i] = '\0';
+            return TRUE;
+        }
+        if ( p_sname[i] == '\0' )
+        {
+            break;
+        }
+        short_name[i] = p_sname[i];
+    }
+
+    return FALSE;
+}
+
+/*****************************************************************
+ * TAG( build_ti_label_index ) LOCAL
+ *
+ * Build the label index of a family with one pass over its TI
+ * parameters, recording the label parameter names of each class
+ * in the order the parameter table holds them.
+ */
+static Return_value build_ti_label_index(Mili_family *fam)
+{
+    Ti_label_index *p_li;
+    Ti_label_class *p_lc;
+    Hash_table *table;
+    Htable_entry *phte, *p_class_hte;
+    char short_name[M_MAX_NAME_LEN];
+    char mili_version[M_MAX_NAME_LEN], host[M_MAX_NAME_LEN], arch[M_MAX_NAME_LEN], timestamp[M_MAX_NAME_LEN],
+        xmilics_version[M_MAX_NAME_LEN];
+    char *major, *minor;
+    Bool_type conn_label, node_label;
+    Return_value rval = OK;
+    int i;
+
+    table = ti_param_htable(fam);
+
+    p_li = NEW(Ti_label_index, "TI label index");
+    if ( p_li == NULL )
+    {
+        return ALLOC_FAILED;
+    }
+    p_li->classes = htable_create(DEFAULT_HASH_TABLE_SIZE);
+    if ( p_li->classes == NULL )
+    {
+        free(p_li);
+        return ALLOC_FAILED;
+    }
+
+    for ( i = 0; table != NULL && i < table->size && rval == OK; i++ )
+    {
+        for ( phte = table->table[i]; phte != NULL && rval == OK; phte = phte->next )
+        {
+            conn_label = strstr(phte->key, "Element Labels[") != NULL;
+            node_label = strstr(phte->key, "Node Labels[") != NULL;
+            if ( !(conn_label || node_label) || !label_short_name(phte->key, short_name) )
+            {
+                continue;
+            }
+
+            rval = htable_search(p_li->classes, short_name, ENTER_MERGE, &p_class_hte);
+            if ( p_class_hte == NULL )
+            {
+                break;
+            }
+            rval = OK;
+            if ( p_class_hte->data == NULL )
+            {
+                p_class_hte->data = NEW(Ti_label_class, "TI label class");
+                if ( p_class_hte->data == NULL )
+                {
+                    rval = ALLOC_FAILED;
+                    break;
+                }
+            }
+            p_lc = (Ti_label_class *)p_class_hte->data;
+
+            if ( conn_label )
+            {
+                rval = add_ti_conn_label(p_lc, phte->key);
+
+                /* Particle classes fall back on any "ml..." class. */
+                if ( rval == OK && strncmp(short_name, "ml", 2) == 0 )
+                {
+                    rval = add_ti_conn_label(&p_li->particle, phte->key);
+                }
+            }
+            else if ( p_lc->node_labels == NULL )
+            {
+                str_dup(&p_lc->node_labels, phte->key);
+                if ( p_lc->node_labels == NULL )
+                {
+                    rval = ALLOC_FAILED;
+                }
+            }
+        }
+    }
+
+    if ( rval != OK )
+    {
+        fam->ti_label_index = p_li;
+        delete_ti_label_index(fam);
+        return rval;
+    }
+
+    /* Databases before Mili 8.1 name the element id arrays by material. */
+    mc_get_metadata(fam->my_id, mili_version, host, arch, timestamp, xmilics_version);
+    strcpy(p_li->conn_id_prefix, "Element Labels-ElemIds");
+    if ( strlen(mili_version) == 0 )
+    {
+        strcpy(p_li->conn_id_prefix, "Element Labels-Mats");
+    }
+    else
+    {
+        major = strtok(mili_version, "_");
+        major[0] = '0';
+        minor = strtok(NULL, "_");
+        if ( atoi(major) < 8 || (atoi(major) == 8 && minor != NULL && atoi(minor) == 0) )
+        {
+            strcpy(p_li->conn_id_prefix, "Element Labels-Mats");
+        }
+    }
+
+    fam->ti_label_index = p_li;
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( find_ti_label_class ) PRIVATE
+ *
+ * Return the label parameter names recorded for a class, building
+ * the family's label index on first use.  NULL if the class has
+ * no labels.
+ */
+Ti_label_class *find_ti_label_class(Mili_family *fam, char *short_name)
+{
+    Htable_entry *phte;
+
+    if ( fam->ti_label_index == NULL && build_ti_label_index(fam) != OK )
+    {
+        return NULL;
+    }
+
+    htable_search(fam->ti_label_index->classes, short_name, FIND_ENTRY, &phte);
+    if ( phte == NULL )
+    {
+        return NULL;
+    }
+
+    return (Ti_label_class *)phte->data;
+}
+
+/*****************************************************************
+ * TAG( find_ti_particle_labels ) PRIVATE
+ *
+ * Return the element label parameter names of all "ml..." classes,
+ * used for particle classes written under an older naming scheme.
+ */
+Ti_label_class *find_ti_particle_labels(Mili_family *fam)
+{
+    if ( fam->ti_label_index == NULL && build_ti_label_index(fam) != OK )
+    {
+        return NULL;
+    }
+
+    return &fam->ti_label_index->particle;
+}
+
+/*****************************************************************
+ * TAG( ti_conn_id_prefix ) PRIVATE
+ *
+ * Return the name prefix of the element id arrays that accompany
+ * the element label arrays of this family.
+ */
+char *ti_conn_id_prefix(Mili_family *fam)
+{
+    if ( fam->ti_label_index == NULL && build_ti_label_index(fam) != OK )
+    {
+        return "Element Labels-ElemIds";
+    }
+
+    return fam->ti_label_index->conn_id_prefix;
+}
+
+/*****************************************************************
+ * TAG( delete_ti_label_index ) PRIVATE
+ *
+ * Free a family's TI label index.  It is rebuilt on the next label
+ * load, so this is also how new label parameters invalidate it.
+ */
+void delete_ti_label_index(Mili_family *fam)
+{
+    Ti_label_index *p_li;
+    int i;
+
+    p_li = fam->ti_label_index;
+    if ( p_li == NULL )
+    {
+        return;
+    }
+
+    htable_delete(p_li->classes, delete_ti_label_class, FALSE);
+    for ( i = 0; i < p_li->particle.qty_conn_labels; i++ )
+    {
+        free(p_li->particle.conn_labels[i]);
+    }
+    if ( p_li->particle.conn_labels != NULL )
+    {
+        free(p_li->particle.conn_labels);
+    }
+    free(p_li);
+    fam->ti_label_index = NULL;
+}
+
 /* End of ti.c */
@@ -94,6 +94,7 @@ Return_value add_ti_dir_entry(Mili_family *fam, Dir_entry_type etype, int modifi
     int qty_ent, qty_nam;
     int i;
     int len;
+    Return_value rval;
 
     /* Check the input data before doing anything. */
     if ( !valid_ti_dir_entry_data(etype, string_qty, strings) )
@@ -113,19 +114,10 @@ Return_value add_ti_dir_entry(Mili_family *fam, Dir_entry_type etype, int modifi
     qty_ent = p_fd->qty_entries;
     qty_nam = p_fd->qty_names;
 
-    p_fd->dir_entries = RENEW_N(Dir_entry, p_fd->dir_entries, qty_ent, 1, "Addl file dir entry");
-    if ( p_fd->dir_entries == NULL )
-    {
-        return ALLOC_FAILED;
-    }
-
-    if ( string_qty > 0 )
+    rval = reserve_dir_space(p_fd, 1, string_qty);
+    if ( rval != OK )
     {
-        p_fd->names = RENEW_N(char *, p_fd->names, qty_nam, string_qty, "Addl name ptr");
-        if ( string_qty > 0 && p_fd->names == NULL )
-        {
-            return ALLOC_FAILED;
-        }
+        return rval;
     }
 
     entry = p_fd->dir_entries[qty_ent];
@@ -493,6 +485,8 @@ Return_value load_ti_directories(Mili_family *fam)
         p_fd->commit_count = header[COMMIT_COUNT_IDX];
         p_fd->qty_entries = qty_ent;
         p_fd->qty_names = qty_nam;
+        p_fd->entry_capacity = qty_ent;
+        p_fd->name_capacity = qty_nam;
         p_fd->names = NEW_N(char *, qty_nam, "File_dir entry names");
         if ( qty_nam > 0 && p_fd->names == NULL )
         {
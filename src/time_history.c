@@ -0,0 +1,829 @@
+/*
+ Copyright (c) 2016, Lawrence Livermore National Security, LLC.
+ Produced at the Lawrence Livermore National Laboratory. Written
+ by Kevin Durrenberger: durrenberger1@llnl.gov. CODE-OCEC-16-056.
+ All rights reserved.
+
+ This file is part of Mili. For details, see <URL describing code
+ and how to download source>.
+
+ Please also read this link-- Our Notice and GNU Lesser General
+ Public License.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License (as published by
+ the Free Software Foundation) version 2.1 dated February 1999.
+
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the IMPLIED WARRANTY OF
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the terms
+ and conditions of the GNU General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+ * Routines for the time-history stream, an optional secondary output
+ * holding selected object-ordered subrecords transposed so that the
+ * data of one object over a run of states is contiguous.  Data passed
+ * to the subrecord write routines is captured per state and appended
+ * to the stream in chunks of a fixed number of states.
+ *
+ * Stream layout, in host byte order:
+ *
+ *     char     magic[8]
+ *     int      version, endian_check, chunk_states, first_state,
+ *              state_qty, qty_subrecs
+ *     per subrecord:
+ *         int      name_length
+ *         char     name[name_length]
+ *         int      obj_qty
+ *         LONGLONG lump_size
+ *     chunks, each chunk_states * state_size bytes; within a chunk,
+ *     per subrecord, per object, chunk_states lumps
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mili_internal.h"
+
+/*****************************************************************
+ * TAG( fam_list )
+ *
+ * Dynamically allocated array of pointers to all currently open
+ * MILI families.
+ */
+extern Mili_family **fam_list;
+
+#define TH_MAGIC "MILITH"
+#define TH_VERSION (1)
+#define TH_DFLT_CHUNK_STATES (64)
+
+/* Byte offsets of first_state and state_qty in the header. */
+#define TH_FIRST_STATE_OFFSET (8 + 3 * sizeof(int))
+#define TH_STATE_QTY_OFFSET   (8 + 4 * sizeof(int))
+
+static Return_value write_th_header(Th_stream *th);
+static Return_value write_th_chunk(Th_stream *th);
+static Return_value commit_th_state(Th_stream *th);
+static Return_value load_th_stream(Mili_family *fam);
+static void delete_th_stream(Th_stream *th);
+
+/*****************************************************************
+ * TAG( mc_open_th ) PUBLIC
+ *
+ * Begin a time-history stream holding the named object-ordered
+ * subrecords for every state started after this call.  Data written
+ * with mc_wrt_subrec(), mc_wrt_subrec_h() and mc_wrt_subrecs() is
+ * captured; mc_wrt_stream() data is not.  Objects not written in a
+ * state read back as zeros.  An existing stream file is replaced.
+ */
+Return_value mc_open_th(Famid fam_id, int chunk_states, int qty, char **subrec_names)
+{
+    Mili_family *fam;
+    Th_stream *th;
+    Subrec_ref *p_ref;
+    char fname[M_MAX_NAME_LEN];
+    int handle;
+    int i;
+    Return_value rval;
+
+    rval = validate_fam_id(fam_id);
+    if ( rval != OK )
+    {
+        return rval;
+    }
+    fam = fam_list[fam_id];
+
+    CHECK_WRITE_ACCESS(fam)
+
+    if ( fam->th_stream != NULL )
+    {
+        return TOO_LATE;
+    }
+
+    if ( qty < 1 || subrec_names == NULL )
+    {
+        return NULL_POINTER;
+    }
+
+    th = NEW(Th_stream, "Time-history stream");
+    if ( th == NULL )
+    {
+        return ALLOC_FAILED;
+    }
+    th->subrecs = NEW_N(Th_subrec, qty, "Time-history subrecs");
+    if ( th->subrecs == NULL )
+    {
+        free(th);
+        return ALLOC_FAILED;
+    }
+    th->qty_subrecs = qty;
+    th->writing = TRUE;
+    th->chunk_states = chunk_states > 0 ? chunk_states : TH_DFLT_CHUNK_STATES;
+    th->first_state = fam->state_qty + 1;
+    th->header_size = 8 + 6 * sizeof(int);
+
+    for ( i = 0; i < qty; i++ )
+    {
+        rval = mc_get_subrec_handle(fam_id, subrec_names[i], &handle);
+        if ( rval != OK )
+        {
+            delete_th_stream(th);
+            return rval;
+        }
+        p_ref = fam->subrec_refs + handle;
+        if ( p_ref->psubrec->organization != OBJECT_ORDERED || p_ref->superclass == M_SURFACE )
+        {
+            delete_th_stream(th);
+            return UNKNOWN_ORGANIZATION;
+        }
+
+        th->subrecs[i].name = strdup(p_ref->psubrec->name);
+        if ( th->subrecs[i].name == NULL )
+        {
+            delete_th_stream(th);
+            return ALLOC_FAILED;
+        }
+        th->subrecs[i].psubrec = p_ref->psubrec;
+        th->subrecs[i].obj_qty = p_ref->psubrec->mo_qty;
+        th->subrecs[i].lump_size = p_ref->psubrec->lump_sizes[0];
+        th->subrecs[i].offset = th->state_size;
+        th->state_size += th->subrecs[i].lump_size * th->subrecs[i].obj_qty;
+        th->header_size += sizeof(int) + strlen(th->subrecs[i].name) + sizeof(int) + sizeof(LONGLONG);
+    }
+
+    th->state_buf = NEW_N(unsigned char, th->state_size, "Time-history state");
+    th->chunk_buf = NEW_N(unsigned char, th->state_size * th->chunk_states, "Time-history chunk");
+    if ( th->state_buf == NULL || th->chunk_buf == NULL )
+    {
+        delete_th_stream(th);
+        return ALLOC_FAILED;
+    }
+
+    make_fnam(TIME_HISTORY, fam, 0, fname);
+    th->file = fopen(fname, "wb+");
+    if ( th->file == NULL )
+    {
+        delete_th_stream(th);
+        return OPEN_FAILED;
+    }
+
+    rval = write_th_header(th);
+    if ( rval != OK )
+    {
+        delete_th_stream(th);
+        return rval;
+    }
+
+    fam->th_stream = th;
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( write_th_header ) LOCAL
+ *
+ * Write the stream header.
+ */
+static Return_value write_th_header(Th_stream *th)
+{
+    char magic[8];
+    int ihdr[6];
+    int len;
+    int i;
+
+    memset(magic, 0, sizeof(magic));
+    strcpy(magic, TH_MAGIC);
+    ihdr[0] = TH_VERSION;
+    ihdr[1] = 1;
+    ihdr[2] = th->chunk_states;
+    ihdr[3] = th->first_state;
+    ihdr[4] = th->state_qty;
+    ihdr[5] = th->qty_subrecs;
+
+    if ( fseek(th->file, 0, SEEK_SET) != 0 )
+    {
+        return SEEK_FAILED;
+    }
+    if ( fwrite(magic, 1, sizeof(magic), th->file) != sizeof(magic) || fwrite(ihdr, sizeof(int), 6, th->file) != 6 )
+    {
+        return SHORT_WRITE;
+    }
+
+    for ( i = 0; i < th->qty_subrecs; i++ )
+    {
+        len = (int)strlen(th->subrecs[i].name);
+        if ( fwrite(&len, sizeof(int), 1, th->file) != 1
+             || fwrite(th->subrecs[i].name, 1, len, th->file) != (size_t)len
+             || fwrite(&th->subrecs[i].obj_qty, sizeof(int), 1, th->file) != 1
+             || fwrite(&th->subrecs[i].lump_size, sizeof(LONGLONG), 1, th->file) != 1 )
+        {
+            return SHORT_WRITE;
+        }
+    }
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( write_th_chunk ) LOCAL
+ *
+ * Write the last chunk, full or not, and the updated state count.
+ */
+static Return_value write_th_chunk(Th_stream *th)
+{
+    LONGLONG chunk_size;
+    LONGLONG offset;
+    int chunk;
+
+    if ( th->state_qty == 0 )
+    {
+        return OK;
+    }
+
+    chunk_size = th->state_size * th->chunk_states;
+    chunk = (th->state_qty - 1) / th->chunk_states;
+    offset = th->header_size + chunk * chunk_size;
+
+    if ( fseek(th->file, offset, SEEK_SET) != 0 )
+    {
+        return SEEK_FAILED;
+    }
+    if ( fwrite(th->chunk_buf, 1, chunk_size, th->file) != (size_t)chunk_size )
+    {
+        return SHORT_WRITE;
+    }
+
+    if ( fseek(th->file, TH_STATE_QTY_OFFSET, SEEK_SET) != 0 )
+    {
+        return SEEK_FAILED;
+    }
+    if ( fwrite(&th->state_qty, sizeof(int), 1, th->file) != 1 )
+    {
+        return SHORT_WRITE;
+    }
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( commit_th_state ) LOCAL
+ *
+ * Transpose the captured state into the chunk buffer, writing the
+ * chunk once it is full.
+ */
+static Return_value commit_th_state(Th_stream *th)
+{
+    Th_subrec *p_ths;
+    unsigned char *p_src, *p_dest;
+    int slot;
+    int i, j;
+    Return_value rval = OK;
+
+    slot = th->state_qty % th->chunk_states;
+    for ( i = 0; i < th->qty_subrecs; i++ )
+    {
+        p_ths = th->subrecs + i;
+        p_src = th->state_buf + p_ths->offset;
+        p_dest = th->chunk_buf + p_ths->offset * th->chunk_states + slot * p_ths->lump_size;
+        for ( j = 0; j < p_ths->obj_qty; j++ )
+        {
+            memcpy(p_dest, p_src, p_ths->lump_size);
+            p_src += p_ths->lump_size;
+            p_dest += p_ths->lump_size * th->chunk_states;
+        }
+    }
+
+    th->state_qty++;
+    th->state_open = FALSE;
+
+    if ( slot == th->chunk_states - 1 )
+    {
+        rval = write_th_chunk(th);
+        memset(th->chunk_buf, 0, th->state_size * th->chunk_states);
+    }
+
+    return rval;
+}
+
+/*****************************************************************
+ * TAG( th_new_state ) PRIVATE
+ *
+ * Start capturing a new state, committing any state left open.
+ * Called after the family's current state offset is set.
+ */
+Return_value th_new_state(Mili_family *fam)
+{
+    Th_stream *th;
+    Return_value rval = OK;
+
+    th = fam->th_stream;
+    if ( th == NULL || !th->writing )
+    {
+        return OK;
+    }
+
+    if ( th->state_open )
+    {
+        rval = commit_th_state(th);
+    }
+
+    memset(th->state_buf, 0, th->state_size);
+    th->st_offset = fam->cur_st_offset;
+    th->state_open = TRUE;
+
+    return rval;
+}
+
+/*****************************************************************
+ * TAG( th_end_state ) PRIVATE
+ *
+ * Commit the state being captured.
+ */
+Return_value th_end_state(Mili_family *fam)
+{
+    Th_stream *th;
+
+    th = fam->th_stream;
+    if ( th != NULL && th->writing && th->state_open )
+    {
+        return commit_th_state(th);
+    }
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( th_capture ) PRIVATE
+ *
+ * Capture data written to an object-ordered subrecord, starting
+ * at lump start, for the state being written.  Called once the
+ * data is in the state file.  Rewrites of earlier states are
+ * ignored.
+ */
+void th_capture(Mili_family *fam, Sub_srec *psubrec, int start, LONGLONG bytes, void *data)
+{
+    Th_stream *th;
+    Th_subrec *p_ths;
+    LONGLONG offset, limit;
+    int i;
+
+    th = fam->th_stream;
+    if ( th == NULL || !th->state_open || fam->cur_st_offset != th->st_offset || start < 1 )
+    {
+        return;
+    }
+
+    for ( i = 0; i < th->qty_subrecs; i++ )
+    {
+        if ( th->subrecs[i].psubrec == psubrec )
+        {
+            break;
+        }
+    }
+    if ( i == th->qty_subrecs )
+    {
+        return;
+    }
+
+    p_ths = th->subrecs + i;
+    offset = (start - 1) * p_ths->lump_size;
+    limit = p_ths->lump_size * p_ths->obj_qty;
+    if ( offset >= limit )
+    {
+        return;
+    }
+    if ( offset + bytes > limit )
+    {
+        bytes = limit - offset;
+    }
+
+    memcpy(th->state_buf + p_ths->offset + offset, data, bytes);
+}
+
+/*****************************************************************
+ * TAG( load_th_stream ) LOCAL
+ *
+ * Read the header of an existing time-history stream.
+ */
+static Return_value load_th_stream(Mili_family *fam)
+{
+    Th_stream *th;
+    char fname[M_MAX_NAME_LEN];
+    char magic[8];
+    int ihdr[6];
+    int len;
+    int i;
+    Return_value rval = OK;
+
+    make_fnam(TIME_HISTORY, fam, 0, fname);
+    th = NEW(Th_stream, "Time-history stream");
+    if ( th == NULL )
+    {
+        return ALLOC_FAILED;
+    }
+    th->file = fopen(fname, "rb");
+    if ( th->file == NULL )
+    {
+        free(th);
+        return OPEN_FAILED;
+    }
+
+    if ( fread(magic, 1, sizeof(magic), th->file) != sizeof(magic) || fread(ihdr, sizeof(int), 6, th->file) != 6 )
+    {
+        delete_th_stream(th);
+        return SHORT_READ;
+    }
+    if ( strncmp(magic, TH_MAGIC, sizeof(magic)) != 0 || ihdr[0] != TH_VERSION )
+    {
+        delete_th_stream(th);
+        return CORRUPTED_FILE;
+    }
+    if ( ihdr[1] != 1 )
+    {
+        delete_th_stream(th);
+        return INCOMPATIBLE_BINARY_FORMAT;
+    }
+
+    th->chunk_states = ihdr[2];
+    th->first_state = ihdr[3];
+    th->state_qty = ihdr[4];
+    th->subrecs = NEW_N(Th_subrec, ihdr[5], "Time-history subrecs");
+    if ( th->chunk_states < 1 || ihdr[5] < 1 || th->subrecs == NULL )
+    {
+        delete_th_stream(th);
+        return ihdr[5] < 1 || th->chunk_states < 1 ? CORRUPTED_FILE : ALLOC_FAILED;
+    }
+    th->qty_subrecs = ihdr[5];
+    th->header_size = sizeof(magic) + sizeof(ihdr);
+
+    for ( i = 0; i < th->qty_subrecs && rval == OK; i++ )
+    {
+        if ( fread(&len, sizeof(int), 1, th->file) != 1 || len < 1 || len >= M_MAX_NAME_LEN )
+        {
+            rval = CORRUPTED_FILE;
+            break;
+        }
+        th->subrecs[i].name = NEW_N(char, len + 1, "Time-history subrec name");
+        if ( th->subrecs[i].name == NULL )
+        {
+            rval = ALLOC_FAILED;
+            break;
+        }
+        if ( fread(th->subrecs[i].name, 1, len, th->file) != (size_t)len
+             || fread(&th->subrecs[i].obj_qty, sizeof(int), 1, th->file) != 1
+             || fread(&th->subrecs[i].lump_size, sizeof(LONGLONG), 1, th->file) != 1 )
+        {
+            rval = SHORT_READ;
+            break;
+        }
+        th->subrecs[i].offset = th->state_size;
+        th->state_size += th->subrecs[i].lump_size * th->subrecs[i].obj_qty;
+        th->header_size += sizeof(int) + len + sizeof(int) + sizeof(LONGLONG);
+    }
+
+    if ( rval != OK )
+    {
+        delete_th_stream(th);
+        return rval;
+    }
+
+    fam->th_stream = th;
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( mc_get_th_states ) PUBLIC
+ *
+ * Return the range of family state numbers held in the time-history
+ * stream.  last_state is less than first_state if it is empty.
+ */
+Return_value mc_get_th_states(Famid fam_id, int *p_first_state, int *p_last_state)
+{
+    Mili_family *fam;
+    Return_value rval;
+
+    rval = validate_fam_id(fam_id);
+    if ( rval != OK )
+    {
+        return rval;
+    }
+    fam = fam_list[fam_id];
+
+    if ( fam->th_stream == NULL )
+    {
+        rval = load_th_stream(fam);
+        if ( rval != OK )
+        {
+            return rval;
+        }
+    }
+
+    *p_first_state = fam->th_stream->first_state;
+    *p_last_state = fam->th_stream->first_state + fam->th_stream->state_qty - 1;
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( mc_read_th ) PUBLIC
+ *
+ * Read the history of one object of a subrecord in the time-history
+ * stream for states first_state through last_state.  The object is
+ * identified by its order number in the subrecord, as in
+ * mc_wrt_subrec().  Data is returned as one lump per state, with one
+ * read per chunk of states spanned.
+ */
+Return_value mc_read_th(Famid fam_id, char *subrec_name, int object, int first_state, int last_state, void *data)
+{
+    Mili_family *fam;
+    Th_stream *th;
+    Th_subrec *p_ths;
+    unsigned char *p_out;
+    LONGLONG chunk_size, offset;
+    int state, stop, chunk, slot, count;
+    int last_chunk;
+    int i;
+    Return_value rval;
+
+    rval = validate_fam_id(fam_id);
+    if ( rval != OK )
+    {
+        return rval;
+    }
+    fam = fam_list[fam_id];
+
+    if ( subrec_name == NULL || data == NULL )
+    {
+        return NULL_POINTER;
+    }
+
+    if ( fam->th_stream == NULL )
+    {
+        rval = load_th_stream(fam);
+        if ( rval != OK )
+        {
+            return rval;
+        }
+    }
+    th = fam->th_stream;
+
+    for ( i = 0; i < th->qty_subrecs; i++ )
+    {
+        if ( strcmp(th->subrecs[i].name, subrec_name) == 0 )
+        {
+            break;
+        }
+    }
+    if ( i == th->qty_subrecs )
+    {
+        return NO_MATCH;
+    }
+    p_ths = th->subrecs + i;
+
+    if ( object < 1 || object > p_ths->obj_qty )
+    {
+        return INVALID_INDEX;
+    }
+    if ( first_state < th->first_state || last_state < first_state
+         || last_state >= th->first_state + th->state_qty )
+    {
+        return INVALID_STATE;
+    }
+
+    if ( th->writing && fflush(th->file) != 0 )
+    {
+        return UNABLE_TO_FLUSH_FILE;
+    }
+
+    chunk_size = th->state_size * th->chunk_states;
+    last_chunk = (th->state_qty - 1) / th->chunk_states;
+    p_out = (unsigned char *)data;
+
+    for ( state = first_state - th->first_state; state <= last_state - th->first_state; state += count )
+    {
+        chunk = state / th->chunk_states;
+        slot = state % th->chunk_states;
+        stop = (chunk + 1) * th->chunk_states - 1;
+        if ( stop > last_state - th->first_state )
+        {
+            stop = last_state - th->first_state;
+        }
+        count = stop - state + 1;
+
+        offset = p_ths->offset * th->chunk_states + ((LONGLONG)(object - 1) * th->chunk_states + slot) * p_ths->lump_size;
+
+        /* A writer's last chunk is still in memory until it fills. */
+        if ( th->writing && chunk == last_chunk && th->state_qty % th->chunk_states != 0 )
+        {
+            memcpy(p_out, th->chunk_buf + offset, count * p_ths->lump_size);
+        }
+        else
+        {
+            if ( fseek(th->file, th->header_size + chunk * chunk_size + offset, SEEK_SET) != 0 )
+            {
+                return SEEK_FAILED;
+            }
+            if ( fread(p_out, p_ths->lump_size, count, th->file) != (size_t)count )
+            {
+                return SHORT_READ;
+            }
+        }
+
+        p_out += count * p_ths->lump_size;
+    }
+
+    return OK;
+}
+
+/*****************************************************************
+ * TAG( delete_th_stream ) LOCAL
+ *
+ * Free a time-history stream, closing its file.
+ */
+static void delete_th_stream(Th_stream *th)
+{
+    int i;
+
+    if ( th->file != NULL )
+    {
+        fclose(th->file);
+    }
+    if ( th->subrecs != NULL )
+    {
+        for ( i = 0; i < th->qty_subrecs; i++ )
+        {
+            if ( th->subrecs[i].name != NULL )
+            {
+                free(th->subrecs[i].name);
+            }
+        }
+        free(th->subrecs);
+    }
+    if ( th->state_buf != NULL )
+    {
+        free(th->state_buf);
+    }
+    if ( th->chunk_buf != NULL )
+    {
+        free(th->chunk_buf);
+    }
+    free(th);
+}
+
+/*****************************************************************
+ * TAG( close_th_stream ) PRIVATE
+ *
+ * Close a family's time-history stream, first committing any open
+ * state and writing the last partial chunk for a writer.
+ */
+Return_value close_th_stream(Mili_family *fam)
+{
+    Th_stream *th;
+    Return_value rval = OK;
+
+    th = fam->th_stream;
+    if ( th == NULL )
+    {
+        return OK;
+    }
+
+    if ( th->writing )
+    {
+        if ( th->state_open )
+        {
+            rval = commit_th_state(th);
+        }
+        if ( rval == OK && th->state_qty % th->chunk_states != 0 )
+        {
+            rval = write_th_chunk(th);
+        }
+    }
+
+    delete_th_stream(th);
+    fam->th_stream = NULL;
+
+    return rval;
+}
+
+/*****************************************************************
+ * TAG( th_truncate ) PRIVATE
+ *
+ * Drop the states following family state "state_qty" from the
+ * time-history stream, as a restart drops them from the state
+ * files.  A writer keeps its partial last chunk in memory, with
+ * the slots of the dropped states cleared.
+ */
+Return_value th_truncate(Mili_family *fam, int state_qty)
+{
+    Th_stream *th;
+    Th_subrec *p_ths;
+    char fname[M_MAX_NAME_LEN];
+    LONGLONG chunk_size, length;
+    unsigned char *p_slot;
+    int keep, slot;
+    int i, j;
+    Return_value rval = OK;
+
+    make_fnam(TIME_HISTORY, fam, 0, fname);
+    if ( fam->th_stream == NULL )
+    {
+        /* A family without a stream has nothing to drop. */
+        rval = load_th_stream(fam);
+        if ( rval != OK )
+        {
+            return (rval == OPEN_FAILED) ? OK : rval;
+        }
+    }
+    th = fam->th_stream;
+
+    if ( th->writing )
+    {
+        /* The state being captured is dropped; put the rest on disk. */
+        th->state_open = FALSE;
+        if ( th->state_qty % th->chunk_states != 0 )
+        {
+            rval = write_th_chunk(th);
+        }
+    }
+    else
+    {
+        fclose(th->file);
+        th->file = fopen(fname, "r+b");
+        if ( th->file == NULL )
+        {
+            rval = OPEN_FAILED;
+        }
+    }
+
+    keep = state_qty - th->first_state + 1;
+    keep = (keep < 0) ? 0 : (keep > th->state_qty) ? th->state_qty : keep;
+    chunk_size = th->state_size * th->chunk_states;
+
+    if ( keep < th->state_qty && rval == OK )
+    {
+        /* An emptied stream holds the states written after the restart. */
+        if ( keep == 0 )
+        {
+            th->first_state = state_qty + 1;
+        }
+        th->state_qty = keep;
+
+        if ( fseek(th->file, TH_FIRST_STATE_OFFSET, SEEK_SET) != 0 )
+        {
+            rval = SEEK_FAILED;
+        }
+        else if ( fwrite(&th->first_state, sizeof(int), 1, th->file) != 1
+                  || fwrite(&th->state_qty, sizeof(int), 1, th->file) != 1 || fflush(th->file) != 0 )
+        {
+            rval = SHORT_WRITE;
+        }
+
+        if ( rval == OK )
+        {
+            length = th->header_size + ((keep + th->chunk_states - 1) / th->chunk_states) * chunk_size;
+            rval = truncate_file(fname, length);
+        }
+    }
+
+    /* Reload the partial last chunk the writer appends to. */
+    slot = keep % th->chunk_states;
+    if ( th->writing && rval == OK )
+    {
+        memset(th->chunk_buf, 0, chunk_size);
+        if ( slot != 0 )
+        {
+            if ( fseek(th->file, th->header_size + (keep / th->chunk_states) * chunk_size, SEEK_SET) != 0 )
+            {
+                rval = SEEK_FAILED;
+            }
+            else if ( fread(th->chunk_buf, 1, chunk_size, th->file) != (size_t)chunk_size )
+            {
+                rval = SHORT_READ;
+            }
+
+            for ( i = 0; i < th->qty_subrecs && rval == OK; i++ )
+            {
+                p_ths = th->subrecs + i;
+                p_slot = th->chunk_buf + p_ths->offset * th->chunk_states + slot * p_ths->lump_size;
+                for ( j = 0; j < p_ths->obj_qty; j++ )
+                {
+                    memset(p_slot, 0, (th->chunk_states - slot) * p_ths->lump_size);
+                    p_slot += p_ths->lump_size * th->chunk_states;
+                }
+            }
+        }
+    }
+
+    /* A reader loads the shortened stream again on its next read. */
+    if ( !th->writing )
+    {
+        delete_th_stream(th);
+        fam->th_stream = NULL;
+    }
+
+    return rval;
+}
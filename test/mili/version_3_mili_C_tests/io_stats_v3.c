@@ -0,0 +1,369 @@
+/*
+ * io_stats_v3.c:
+ *
+ * Collect I/O statistics while writing a few states and while reading
+ * them back after a reopen.  The counters of each pass must be
+ * nonzero, and the JSON report, with its timings left out, must match
+ * the baseline below.  A family not collecting statistics has none to
+ * report.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mili.h"
+
+#define NODE_QTY  4
+#define STATE_QTY 3
+
+char *fname = "io_stats_v3.plt";
+
+char *names[] = {"temp"};
+char *titles[] = {"Temperature"};
+int types[] = {M_FLOAT};
+
+/* Expected reports of the writer and of the reader. */
+char *writer_baseline =
+    "{\n"
+    "    \"read_calls\": 0,\n"
+    "    \"read_bytes\": 0,\n"
+    "    \"write_calls\": 9,\n"
+    "    \"write_bytes\": 72,\n"
+    "    \"seeks\": 5,\n"
+    "    \"file_opens\": 1,\n"
+    "    \"file_closes\": 0,\n"
+    "    \"pool_hits\": 0,\n"
+    "    \"pool_misses\": 0,\n"
+    "    \"fsyncs\": 3,\n"
+    "    \"wall_time\": 0,\n"
+    "    \"latency\": {\n"
+    "        \"mc_open\": {\n"
+    "            \"calls\": 0,\n"
+    "            \"total_time\": 0,\n"
+    "            \"max_time\": 0,\n"
+    "            \"log2_usec_buckets\": []\n"
+    "        },\n"
+    "        \"mc_read_results\": {\n"
+    "            \"calls\": 0,\n"
+    "            \"total_time\": 0,\n"
+    "            \"max_time\": 0,\n"
+    "            \"log2_usec_buckets\": []\n"
+    "        },\n"
+    "        \"mc_new_state\": {\n"
+    "            \"calls\": 3,\n"
+    "            \"total_time\": 0,\n"
+    "            \"max_time\": 0,\n"
+    "            \"log2_usec_buckets\": []\n"
+    "        },\n"
+    "        \"mc_end_state\": {\n"
+    "            \"calls\": 3,\n"
+    "            \"total_time\": 0,\n"
+    "            \"max_time\": 0,\n"
+    "            \"log2_usec_buckets\": []\n"
+    "        },\n"
+    "        \"mc_flush\": {\n"
+    "            \"calls\": 1,\n"
+    "            \"total_time\": 0,\n"
+    "            \"max_time\": 0,\n"
+    "            \"log2_usec_buckets\": []\n"
+    "        }\n"
+    "    }\n"
+    "}\n";
+
+char *reader_baseline =
+    "{\n"
+    "    \"read_calls\": 3,\n"
+    "    \"read_bytes\": 48,\n"
+    "    \"write_calls\": 0,\n"
+    "    \"write_bytes\": 0,\n"
+    "    \"seeks\": 3,\n"
+    "    \"file_opens\": 1,\n"
+    "    \"file_closes\": 0,\n"
+    "    \"pool_hits\": 0,\n"
+    "    \"pool_misses\": 1,\n"
+    "    \"fsyncs\": 0,\n"
+    "    \"wall_time\": 0,\n"
+    "    \"latency\": {\n"
+    "        \"mc_open\": {\n"
+    "            \"calls\": 0,\n"
+    "            \"total_time\": 0,\n"
+    "            \"max_time\": 0,\n"
+    "            \"log2_usec_buckets\": []\n"
+    "        },\n"
+    "        \"mc_read_results\": {\n"
+    "            \"calls\": 3,\n"
+    "            \"total_time\": 0,\n"
+    "            \"max_time\": 0,\n"
+    "            \"log2_usec_buckets\": []\n"
+    "        },\n"
+    "        \"mc_new_state\": {\n"
+    "            \"calls\": 0,\n"
+    "            \"total_time\": 0,\n"
+    "            \"max_time\": 0,\n"
+    "            \"log2_usec_buckets\": []\n"
+    "        },\n"
+    "        \"mc_end_state\": {\n"
+    "            \"calls\": 0,\n"
+    "            \"total_time\": 0,\n"
+    "            \"max_time\": 0,\n"
+    "            \"log2_usec_buckets\": []\n"
+    "        },\n"
+    "        \"mc_flush\": {\n"
+    "            \"calls\": 0,\n"
+    "            \"total_time\": 0,\n"
+    "            \"max_time\": 0,\n"
+    "            \"log2_usec_buckets\": []\n"
+    "        }\n"
+    "    }\n"
+    "}\n";
+
+static void fail(char *what, int stat)
+{
+    mc_print_error(what, stat);
+    exit(-1);
+}
+
+static void write_family(Famid fid)
+{
+    float coords[NODE_QTY][3] = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}};
+    float temps[NODE_QTY];
+    int mo_ids[2];
+    int file_suffix, state_index;
+    int mid, sid, state, i, stat;
+
+    stat = mc_make_umesh(fid, "Stats mesh", 3, &mid);
+    if ( stat == OK )
+    {
+        stat = mc_def_class(fid, mid, M_NODE, "node", "Nodal");
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_nodes(fid, mid, "node", 1, NODE_QTY, (float *)coords);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_svars(fid, 1, names[0], 0, titles[0], 0, types);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_open_srec(fid, mid, &sid);
+    }
+    if ( stat == OK )
+    {
+        mo_ids[0] = 1;
+        mo_ids[1] = NODE_QTY;
+        stat = mc_def_subrec(fid, sid, "NodeTemp", OBJECT_ORDERED, 1, names[0], 0, "node", M_BLOCK_OBJ_FMT, 1, mo_ids,
+                             0);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_close_srec(fid, sid);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_flush(fid, NON_STATE_DATA);
+    }
+
+    for ( state = 1; state <= STATE_QTY && stat == OK; state++ )
+    {
+        for ( i = 0; i < NODE_QTY; i++ )
+        {
+            temps[i] = (float)(10 * state + i);
+        }
+        stat = mc_new_state(fid, sid, (float)state, &file_suffix, &state_index);
+        if ( stat == OK )
+        {
+            stat = mc_wrt_subrec(fid, "NodeTemp", 1, NODE_QTY, temps);
+        }
+        if ( stat == OK )
+        {
+            stat = mc_end_state(fid, sid);
+        }
+    }
+    if ( stat != OK )
+    {
+        fail("write_family", stat);
+    }
+}
+
+static void read_family(Famid fid)
+{
+    float temps[NODE_QTY];
+    int state, stat;
+
+    for ( state = 1; state <= STATE_QTY; state++ )
+    {
+        stat = mc_read_results(fid, state, 0, 1, names, temps);
+        if ( stat != OK )
+        {
+            fail("mc_read_results", stat);
+        }
+        if ( temps[NODE_QTY - 1] != (float)(10 * state + NODE_QTY - 1) )
+        {
+            fprintf(stderr, "State %d read %f\n", state, temps[NODE_QTY - 1]);
+            exit(-1);
+        }
+    }
+}
+
+/*
+ * Copy a pretty printed report leaving out its timings, which vary
+ * from run to run: times read as 0 and histograms as empty.
+ */
+static void strip_timings(char *json, char *out)
+{
+    char *line, *next, *colon;
+    Bool_type in_buckets = FALSE;
+
+    *out = '\0';
+    for ( line = json; line != NULL && *line != '\0'; line = next )
+    {
+        next = strchr(line, '\n');
+        if ( next != NULL )
+        {
+            *next++ = '\0';
+        }
+
+        if ( in_buckets )
+        {
+            in_buckets = (strchr(line, ']') == NULL);
+            continue;
+        }
+
+        colon = strstr(line, "\": ");
+        if ( colon != NULL && strstr(line, "_time\"") != NULL )
+        {
+            strncat(out, line, colon + 3 - line);
+            strcat(out, (line[strlen(line) - 1] == ',') ? "0," : "0");
+        }
+        else if ( colon != NULL && strstr(line, "\"log2_usec_buckets\"") != NULL )
+        {
+            strncat(out, line, colon + 3 - line);
+            strcat(out, "[]");
+            in_buckets = (strchr(colon, ']') == NULL);
+        }
+        else
+        {
+            strcat(out, line);
+        }
+        strcat(out, "\n");
+    }
+}
+
+static void check_json(Famid fid, char *who, char *baseline)
+{
+    char *json, *stripped;
+    int stat;
+
+    stat = mc_io_stats_json(fid, &json);
+    if ( stat != OK )
+    {
+        fail("mc_io_stats_json", stat);
+    }
+    stripped = (char *)malloc(strlen(json) + 2);
+    if ( stripped == NULL )
+    {
+        fprintf(stderr, "%s: out of memory\n", who);
+        exit(-1);
+    }
+    strip_timings(json, stripped);
+
+    if ( strcmp(stripped, baseline) != 0 )
+    {
+        fprintf(stderr, "%s: JSON report differs from the baseline:\n%s", who, stripped);
+        exit(-1);
+    }
+    free(stripped);
+    free(json);
+}
+
+int main(int argc, char *argv[])
+{
+    Io_stats stats;
+    char *json;
+    Famid fid;
+    int stat;
+
+    stat = mc_open(fname, ".", "AwPd", &fid);
+    if ( stat != OK )
+    {
+        fail("mc_open (write)", stat);
+    }
+    if ( mc_get_io_stats(fid, &stats) != NOT_APPLICABLE || mc_io_stats_json(fid, &json) != NOT_APPLICABLE )
+    {
+        fprintf(stderr, "Statistics reported before being turned on\n");
+        exit(-1);
+    }
+    stat = mc_set_io_stats(fid, TRUE);
+    if ( stat != OK )
+    {
+        fail("mc_set_io_stats (write)", stat);
+    }
+
+    write_family(fid);
+
+    stat = mc_get_io_stats(fid, &stats);
+    if ( stat != OK )
+    {
+        fail("mc_get_io_stats (write)", stat);
+    }
+    if ( stats.write_calls == 0 || stats.write_bytes == 0 || stats.file_opens == 0 || stats.fsyncs == 0
+         || stats.latency[M_STAT_NEW_STATE].calls != STATE_QTY || stats.latency[M_STAT_END_STATE].calls != STATE_QTY
+         || stats.latency[M_STAT_FLUSH].calls == 0 || stats.wall_time <= 0.0 )
+    {
+        fprintf(stderr, "Writer counted %lld writes of %lld bytes, %lld opens, %lld fsyncs, %lld new states\n",
+                (long long)stats.write_calls, (long long)stats.write_bytes, (long long)stats.file_opens,
+                (long long)stats.fsyncs, (long long)stats.latency[M_STAT_NEW_STATE].calls);
+        exit(-1);
+    }
+    check_json(fid, "writer", writer_baseline);
+
+    stat = mc_close(fid);
+    if ( stat != OK )
+    {
+        fail("mc_close (write)", stat);
+    }
+
+    stat = mc_open(fname, ".", "r", &fid);
+    if ( stat == OK )
+    {
+        stat = mc_set_io_stats(fid, TRUE);
+    }
+    if ( stat != OK )
+    {
+        fail("mc_open (read)", stat);
+    }
+
+    read_family(fid);
+
+    stat = mc_get_io_stats(fid, &stats);
+    if ( stat != OK )
+    {
+        fail("mc_get_io_stats (read)", stat);
+    }
+    if ( stats.read_calls == 0 || stats.read_bytes < STATE_QTY * NODE_QTY * sizeof(float) || stats.write_calls != 0
+         || stats.latency[M_STAT_READ_RESULTS].calls != STATE_QTY )
+    {
+        fprintf(stderr, "Reader counted %lld reads of %lld bytes, %lld writes, %lld result reads\n",
+                (long long)stats.read_calls, (long long)stats.read_bytes, (long long)stats.write_calls,
+                (long long)stats.latency[M_STAT_READ_RESULTS].calls);
+        exit(-1);
+    }
+    check_json(fid, "reader", reader_baseline);
+
+    /* Turning statistics off discards them. */
+    stat = mc_set_io_stats(fid, FALSE);
+    if ( stat != OK || mc_get_io_stats(fid, &stats) != NOT_APPLICABLE )
+    {
+        fprintf(stderr, "Statistics reported after being turned off\n");
+        exit(-1);
+    }
+
+    stat = mc_close(fid);
+    if ( stat != OK )
+    {
+        fail("mc_close (read)", stat);
+    }
+
+    return 0;
+}
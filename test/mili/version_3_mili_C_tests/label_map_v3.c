@@ -0,0 +1,161 @@
+/*
+ * label_map_v3.c:
+ *
+ * Resolve labels to local ids and back for a class with compact
+ * labels, which get a direct map, and for one whose labels span
+ * nearly the whole int range, which are searched sorted.  Labels
+ * not in a class and ids outside it resolve to 0.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mili.h"
+
+#define NODE_QTY  8
+#define TRUSS_QTY 3
+
+char *fname = "label_map_v3.plt";
+
+float coords[NODE_QTY][3] = {{0, 0, 0}, {1, 0, 0}, {2, 0, 0}, {3, 0, 0},
+                             {0, 1, 0}, {1, 1, 0}, {2, 1, 0}, {3, 1, 0}};
+int node_labels[NODE_QTY] = {101, 102, 104, 105, 107, 108, 110, 112};
+int missing_node_labels[] = {100, 103, 111, 113, -101};
+
+int trusses[TRUSS_QTY][4] = {{1, 2, 1, 1}, {2, 3, 1, 1}, {3, 4, 1, 1}};
+int truss_labels[TRUSS_QTY] = {2000000000, -2000000000, 5};
+int missing_truss_labels[] = {4, 6, -2147483647 - 1, 2147483647};
+
+static void fail(char *what, int stat)
+{
+    mc_print_error(what, stat);
+    exit(-1);
+}
+
+static void write_family(void)
+{
+    Famid fid;
+    int mid, stat;
+
+    stat = mc_open(fname, ".", "AwPd", &fid);
+    if ( stat != OK )
+    {
+        fail("mc_open (write)", stat);
+    }
+
+    stat = mc_make_umesh(fid, "Label mesh", 3, &mid);
+    if ( stat == OK )
+    {
+        stat = mc_def_class(fid, mid, M_MAT, "mat", "Material");
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_class_idents(fid, mid, "mat", 1, 1);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_class(fid, mid, M_NODE, "node", "Nodal");
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_nodes(fid, mid, "node", 1, NODE_QTY, (float *)coords);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_node_labels(fid, mid, "node", NODE_QTY, node_labels);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_class(fid, mid, M_TRUSS, "truss", "Truss");
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_conn_seq_labels(fid, mid, "truss", 1, TRUSS_QTY, truss_labels, (int *)trusses);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_close(fid);
+    }
+    if ( stat != OK )
+    {
+        fail("write_family", stat);
+    }
+}
+
+/* Check that every label maps to its id and back, and misses map to 0. */
+static void check_class(Famid fid, char *class_name, int qty, int *labels, int missing_qty, int *missing)
+{
+    int ids[NODE_QTY + 2], back[NODE_QTY + 2];
+    int i, stat;
+
+    stat = mc_labels_to_local_ids(fid, 0, class_name, qty, labels, ids);
+    if ( stat != OK )
+    {
+        fail("mc_labels_to_local_ids", stat);
+    }
+    for ( i = 0; i < qty; i++ )
+    {
+        if ( ids[i] != i + 1 )
+        {
+            fprintf(stderr, "%s: label %d resolved to id %d, expected %d\n", class_name, labels[i], ids[i], i + 1);
+            exit(-1);
+        }
+    }
+
+    stat = mc_labels_to_local_ids(fid, 0, class_name, missing_qty, missing, ids);
+    if ( stat != OK )
+    {
+        fail("mc_labels_to_local_ids (missing)", stat);
+    }
+    for ( i = 0; i < missing_qty; i++ )
+    {
+        if ( ids[i] != 0 )
+        {
+            fprintf(stderr, "%s: missing label %d resolved to id %d\n", class_name, missing[i], ids[i]);
+            exit(-1);
+        }
+    }
+
+    /* Ids 0 and qty + 1 are outside the class. */
+    for ( i = 0; i < qty + 2; i++ )
+    {
+        ids[i] = i;
+    }
+    stat = mc_local_ids_to_labels(fid, 0, class_name, qty + 2, ids, back);
+    if ( stat != OK )
+    {
+        fail("mc_local_ids_to_labels", stat);
+    }
+    for ( i = 0; i < qty + 2; i++ )
+    {
+        if ( back[i] != ((i < 1 || i > qty) ? 0 : labels[i - 1]) )
+        {
+            fprintf(stderr, "%s: id %d mapped to label %d\n", class_name, i, back[i]);
+            exit(-1);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Famid fid;
+    int stat;
+
+    write_family();
+
+    stat = mc_open(fname, ".", "r", &fid);
+    if ( stat != OK )
+    {
+        fail("mc_open (read)", stat);
+    }
+    check_class(fid, "node", NODE_QTY, node_labels, sizeof(missing_node_labels) / sizeof(int), missing_node_labels);
+    check_class(fid, "truss", TRUSS_QTY, truss_labels, sizeof(missing_truss_labels) / sizeof(int),
+                missing_truss_labels);
+    stat = mc_close(fid);
+    if ( stat != OK )
+    {
+        fail("mc_close (read)", stat);
+    }
+
+    return 0;
+}
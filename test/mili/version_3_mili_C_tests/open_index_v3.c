@@ -0,0 +1,213 @@
+/*
+ * open_index_v3.c:
+ *
+ * Open, append to and reopen a family written with an open-time
+ * index.  An index saved before the append is put back once the
+ * appending writer has closed, so the reopen must find it stale and
+ * read the appended parameter from the family files.  A last append
+ * asks for a new index, which the final reopen reads through.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mili.h"
+
+#define NODE_QTY 4
+
+char *fname = "open_index_v3.plt";
+
+char *names[] = {"temp"};
+char *titles[] = {"Temperature"};
+int types[] = {M_FLOAT};
+
+static void fail(char *what, int stat)
+{
+    mc_print_error(what, stat);
+    exit(-1);
+}
+
+static void write_state(Famid fid, int sid, float time)
+{
+    float temps[NODE_QTY] = {1.0, 2.0, 3.0, 4.0};
+    int file_suffix, state_index;
+    int stat;
+
+    stat = mc_new_state(fid, sid, time, &file_suffix, &state_index);
+    if ( stat == OK )
+    {
+        stat = mc_wrt_subrec(fid, "NodeTemp", 1, NODE_QTY, temps);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_end_state(fid, sid);
+    }
+    if ( stat != OK )
+    {
+        fail("write_state", stat);
+    }
+}
+
+static void create_family(void)
+{
+    float coords[NODE_QTY][3] = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}};
+    int mo_ids[2];
+    int one = 1;
+    Famid fid;
+    int mid, sid, stat;
+
+    stat = mc_open(fname, ".", "AwPd", &fid);
+    if ( stat != OK )
+    {
+        fail("mc_open (write)", stat);
+    }
+    mc_set_state_map_file_on(fid, 1);
+
+    stat = mc_set_open_index(fid, TRUE);
+    if ( stat == OK )
+    {
+        stat = mc_wrt_scalar(fid, M_INT, "first_param", &one);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_make_umesh(fid, "Index mesh", 3, &mid);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_class(fid, mid, M_NODE, "node", "Nodal");
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_nodes(fid, mid, "node", 1, NODE_QTY, (float *)coords);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_svars(fid, 1, names[0], 0, titles[0], 0, types);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_open_srec(fid, mid, &sid);
+    }
+    if ( stat == OK )
+    {
+        mo_ids[0] = 1;
+        mo_ids[1] = NODE_QTY;
+        stat = mc_def_subrec(fid, sid, "NodeTemp", OBJECT_ORDERED, 1, names[0], 0, "node", M_BLOCK_OBJ_FMT, 1, mo_ids,
+                             0);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_close_srec(fid, sid);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_flush(fid, NON_STATE_DATA);
+    }
+    if ( stat != OK )
+    {
+        fail("create_family", stat);
+    }
+
+    write_state(fid, sid, 0.0);
+
+    stat = mc_close(fid);
+    if ( stat != OK )
+    {
+        fail("mc_close (write)", stat);
+    }
+}
+
+/* Append a state and a new parameter, optionally writing a new index. */
+static void append_family(char *param, int value, Bool_type write_index)
+{
+    Famid fid;
+    int stat;
+
+    stat = mc_open(fname, ".", "AaPdEn", &fid);
+    if ( stat != OK )
+    {
+        fail("mc_open (append)", stat);
+    }
+    stat = mc_set_open_index(fid, write_index);
+    if ( stat == OK )
+    {
+        stat = mc_wrt_scalar(fid, M_INT, param, &value);
+    }
+    if ( stat != OK )
+    {
+        fail("append_family", stat);
+    }
+    write_state(fid, 0, (float)value);
+    stat = mc_close(fid);
+    if ( stat != OK )
+    {
+        fail("mc_close (append)", stat);
+    }
+}
+
+/* Reopen the family and check a parameter and the state count. */
+static void check_family(char *param, int value, int state_qty)
+{
+    Famid fid;
+    int read_value, qty;
+    int stat;
+
+    stat = mc_open(fname, ".", "r", &fid);
+    if ( stat != OK )
+    {
+        fail("mc_open (read)", stat);
+    }
+    stat = mc_read_scalar(fid, param, &read_value);
+    if ( stat != OK )
+    {
+        fail(param, stat);
+    }
+    stat = mc_query_family(fid, QTY_STATES, NULL, NULL, &qty);
+    if ( stat != OK )
+    {
+        fail("mc_query_family", stat);
+    }
+    if ( read_value != value || qty != state_qty )
+    {
+        fprintf(stderr, "Read %s = %d with %d states, expected %d with %d states\n", param, read_value, qty, value,
+                state_qty);
+        exit(-1);
+    }
+    stat = mc_close(fid);
+    if ( stat != OK )
+    {
+        fail("mc_close (read)", stat);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    char iname[128], saved[128];
+
+    sprintf(iname, "%sindex", fname);
+    sprintf(saved, "%sindex.saved", fname);
+
+    create_family();
+    check_family("first_param", 1, 1);
+
+    /* Keep the index, append without one, then restore the stale index. */
+    if ( rename(iname, saved) != 0 )
+    {
+        fprintf(stderr, "No open index written for %s\n", fname);
+        exit(-1);
+    }
+    append_family("second_param", 2, FALSE);
+    if ( rename(saved, iname) != 0 )
+    {
+        fprintf(stderr, "Unable to restore %s\n", iname);
+        exit(-1);
+    }
+    check_family("second_param", 2, 2);
+
+    /* A writer asking for an index replaces the stale one. */
+    append_family("third_param", 3, TRUE);
+    check_family("second_param", 2, 3);
+    check_family("third_param", 3, 3);
+
+    return 0;
+}
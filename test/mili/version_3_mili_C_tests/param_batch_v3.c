@@ -0,0 +1,240 @@
+/*
+ * param_batch_v3.c:
+ *
+ * Write scalars, strings and arrays with one mc_wrt_params() call,
+ * including a scalar that already exists and one named twice in the
+ * batch, and read them back from the writer and after a reopen.  A
+ * batch that is refused, or that fails part way through its write,
+ * must not leave any of its parameters behind.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include "mili.h"
+
+#define ID_QTY  5
+#define BIG_QTY (1 << 20)
+
+char *fname = "param_batch_v3.plt";
+
+int ids[ID_QTY] = {10, 20, 30, 40, 50};
+int id_dims[1] = {ID_QTY};
+float weights[2][3] = {{0.5, 1.5, 2.5}, {3.5, 4.5, 5.5}};
+int weight_dims[2] = {2, 3};
+
+static void fail(char *what, int stat)
+{
+    mc_print_error(what, stat);
+    exit(-1);
+}
+
+static void check_params(Famid fid, char *who)
+{
+    char note[64];
+    int count, i;
+    float scale;
+    int *p_ids = NULL;
+    float *p_weights = NULL;
+    int stat;
+
+    stat = mc_read_scalar(fid, "count", &count);
+    if ( stat == OK )
+    {
+        stat = mc_read_scalar(fid, "scale", &scale);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_read_string(fid, "note", note);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_read_param_array(fid, "ids", (void **)&p_ids);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_read_param_array(fid, "weights", (void **)&p_weights);
+    }
+    if ( stat != OK )
+    {
+        fail(who, stat);
+    }
+
+    /* The last value written for a name wins. */
+    if ( count != 7 || scale != 3.5 || strcmp(note, "Batched parameters") != 0 )
+    {
+        fprintf(stderr, "%s: read count %d, scale %f, note \"%s\"\n", who, count, scale, note);
+        exit(-1);
+    }
+    for ( i = 0; i < ID_QTY; i++ )
+    {
+        if ( p_ids[i] != ids[i] )
+        {
+            fprintf(stderr, "%s: ids[%d] read %d, expected %d\n", who, i, p_ids[i], ids[i]);
+            exit(-1);
+        }
+    }
+    for ( i = 0; i < 6; i++ )
+    {
+        if ( p_weights[i] != weights[i / 3][i % 3] )
+        {
+            fprintf(stderr, "%s: weights[%d] read %f, expected %f\n", who, i, p_weights[i], weights[i / 3][i % 3]);
+            exit(-1);
+        }
+    }
+    free(p_ids);
+    free(p_weights);
+
+    if ( mc_read_scalar(fid, "refused", &count) == OK || mc_read_scalar(fid, "partial", &count) == OK )
+    {
+        fprintf(stderr, "%s: parameter of a failed batch found\n", who);
+        exit(-1);
+    }
+}
+
+/* Write a batch that runs into the file size limit part way through. */
+static void write_short(Famid fid)
+{
+    Named_param partial[2];
+    struct rlimit old_limit, limit;
+    struct stat a_stat;
+    char aname[128];
+    float *big;
+    int big_dims[1] = {BIG_QTY};
+    int one = 1;
+    int rval;
+
+    big = (float *)calloc(BIG_QTY, sizeof(float));
+    sprintf(aname, "%sA", fname);
+    if ( big == NULL || stat(aname, &a_stat) != 0 || getrlimit(RLIMIT_FSIZE, &old_limit) != 0 )
+    {
+        fprintf(stderr, "Unable to set up the short write\n");
+        exit(-1);
+    }
+
+    memset(partial, 0, sizeof(partial));
+    partial[0].name = "partial";
+    partial[0].type = M_INT;
+    partial[0].data = &one;
+    partial[1].name = "big";
+    partial[1].type = M_FLOAT;
+    partial[1].order = 1;
+    partial[1].dimensions = big_dims;
+    partial[1].data = big;
+
+    signal(SIGXFSZ, SIG_IGN);
+    limit = old_limit;
+    limit.rlim_cur = a_stat.st_size + BIG_QTY;
+    setrlimit(RLIMIT_FSIZE, &limit);
+    rval = mc_wrt_params(fid, 2, partial);
+    setrlimit(RLIMIT_FSIZE, &old_limit);
+    free(big);
+
+    if ( rval != SHORT_WRITE )
+    {
+        fprintf(stderr, "Batch past the file size limit returned %d\n", rval);
+        exit(-1);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Named_param params[6];
+    Named_param refused[2];
+    int one = 1, seven = 7;
+    float first_scale = 2.5, scale = 3.5;
+    Famid fid;
+    int stat;
+
+    stat = mc_open(fname, ".", "AwPd", &fid);
+    if ( stat != OK )
+    {
+        fail("mc_open (write)", stat);
+    }
+    stat = mc_wrt_scalar(fid, M_INT, "count", &one);
+    if ( stat != OK )
+    {
+        fail("mc_wrt_scalar", stat);
+    }
+
+    memset(params, 0, sizeof(params));
+    params[0].name = "count";
+    params[0].type = M_INT;
+    params[0].data = &seven;
+    params[1].name = "scale";
+    params[1].type = M_FLOAT;
+    params[1].data = &first_scale;
+    params[2].name = "note";
+    params[2].type = M_STRING;
+    params[2].data = "Batched parameters";
+    params[3].name = "ids";
+    params[3].type = M_INT;
+    params[3].order = 1;
+    params[3].dimensions = id_dims;
+    params[3].data = ids;
+    params[4].name = "weights";
+    params[4].type = M_FLOAT;
+    params[4].order = 2;
+    params[4].dimensions = weight_dims;
+    params[4].data = weights;
+    params[5].name = "scale";
+    params[5].type = M_FLOAT;
+    params[5].data = &scale;
+    stat = mc_wrt_params(fid, 6, params);
+    if ( stat != OK )
+    {
+        fail("mc_wrt_params", stat);
+    }
+
+    /* A bad entry refuses the whole batch. */
+    memset(refused, 0, sizeof(refused));
+    refused[0].name = "refused";
+    refused[0].type = M_INT;
+    refused[0].data = &one;
+    refused[1].name = "bad_type";
+    refused[1].type = -1;
+    refused[1].data = &one;
+    if ( mc_wrt_params(fid, 2, refused) != INVALID_DATA_TYPE )
+    {
+        fprintf(stderr, "Batch with a bad data type accepted\n");
+        exit(-1);
+    }
+    refused[1].name = NULL;
+    refused[1].type = M_INT;
+    if ( mc_wrt_params(fid, 2, refused) != INVALID_NAME )
+    {
+        fprintf(stderr, "Batch with an unnamed parameter accepted\n");
+        exit(-1);
+    }
+
+    write_short(fid);
+
+    check_params(fid, "writer");
+    stat = mc_close(fid);
+    if ( stat != OK )
+    {
+        fail("mc_close (write)", stat);
+    }
+
+    stat = mc_open(fname, ".", "r", &fid);
+    if ( stat != OK )
+    {
+        fail("mc_open (read)", stat);
+    }
+    check_params(fid, "reader");
+    if ( mc_wrt_params(fid, 1, params) != BAD_ACCESS_TYPE )
+    {
+        fprintf(stderr, "Batch written to a family opened for reading\n");
+        exit(-1);
+    }
+    stat = mc_close(fid);
+    if ( stat != OK )
+    {
+        fail("mc_close (read)", stat);
+    }
+
+    return 0;
+}
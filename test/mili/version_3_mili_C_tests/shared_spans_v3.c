@@ -0,0 +1,292 @@
+/*
+ * shared_spans_v3.c:
+ *
+ * Split two subrecords into disjoint spans, one set per writer, and
+ * have the writers write their spans of each state concurrently from
+ * separate threads.  Checks the span placement, that overlapping spans
+ * are refused and that every state reads back, for a native and a
+ * byte-swapped family.  The last writer skips its spans of the final
+ * state, which must read back as zeros from a reader that opens the
+ * family before the writer closes it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "mili.h"
+
+#define NODE_QTY     8
+#define WRITER_QTY   4
+#define WRITER_NODES (NODE_QTY / WRITER_QTY)
+#define SUBREC_QTY   2
+#define STATE_QTY    3
+
+char *names[] = {"temp", "flux"};
+char *titles[] = {"Temperature", "Heat flux"};
+int types[] = {M_FLOAT, M_FLOAT};
+char *subrecs[] = {"NodeTemp", "NodeFlux"};
+
+typedef struct _writer
+{
+    Famid fid;
+    int state;
+    Shared_span *spans[SUBREC_QTY];
+    Return_value rval;
+} Writer;
+
+static void fail(char *what, int stat)
+{
+    mc_print_error(what, stat);
+    exit(-1);
+}
+
+/* The last writer's spans of the final state are never written. */
+static float node_value(int subrec, int state, int node)
+{
+    if ( state == STATE_QTY && node > (WRITER_QTY - 1) * WRITER_NODES )
+    {
+        return 0.0;
+    }
+    return (float)((subrec == 0 ? 1 : -1) * (100 * state + node));
+}
+
+/* Write one writer's spans of the current state. */
+static void *write_spans(void *arg)
+{
+    Writer *w = (Writer *)arg;
+    float data[WRITER_NODES];
+    int i, j;
+
+    w->rval = OK;
+    if ( w->state == STATE_QTY && w->spans[0]->start > (WRITER_QTY - 1) * WRITER_NODES )
+    {
+        return NULL;
+    }
+    for ( i = 0; i < SUBREC_QTY && w->rval == OK; i++ )
+    {
+        for ( j = 0; j < WRITER_NODES; j++ )
+        {
+            data[j] = node_value(i, w->state, w->spans[i]->start + j);
+        }
+        w->rval = mc_wrt_shared_span(w->fid, w->spans[i], data);
+    }
+
+    return NULL;
+}
+
+static void define_family(Famid fid, int *p_sid)
+{
+    float coords[NODE_QTY][3];
+    int mo_ids[2];
+    int mid, i, stat;
+
+    for ( i = 0; i < NODE_QTY; i++ )
+    {
+        coords[i][0] = (float)i;
+        coords[i][1] = 0.0;
+        coords[i][2] = 0.0;
+    }
+
+    stat = mc_make_umesh(fid, "Shared mesh", 3, &mid);
+    if ( stat == OK )
+    {
+        stat = mc_def_class(fid, mid, M_NODE, "node", "Nodal");
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_nodes(fid, mid, "node", 1, NODE_QTY, (float *)coords);
+    }
+    for ( i = 0; i < SUBREC_QTY && stat == OK; i++ )
+    {
+        stat = mc_def_svars(fid, 1, names[i], 0, titles[i], 0, types + i);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_open_srec(fid, mid, p_sid);
+    }
+    for ( i = 0; i < SUBREC_QTY && stat == OK; i++ )
+    {
+        mo_ids[0] = 1;
+        mo_ids[1] = NODE_QTY;
+        stat = mc_def_subrec(fid, *p_sid, subrecs[i], OBJECT_ORDERED, 1, names[i], 0, "node", M_BLOCK_OBJ_FMT, 1,
+                             mo_ids, 0);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_close_srec(fid, *p_sid);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_flush(fid, NON_STATE_DATA);
+    }
+    if ( stat != OK )
+    {
+        fail("define_family", stat);
+    }
+}
+
+/* Spans must cover each subrecord without gaps or overlaps. */
+static void check_spans(Shared_span spans[SUBREC_QTY][WRITER_QTY])
+{
+    int i, r;
+
+    for ( i = 0; i < SUBREC_QTY; i++ )
+    {
+        for ( r = 0; r < WRITER_QTY; r++ )
+        {
+            if ( spans[i][r].type != M_FLOAT || spans[i][r].size != WRITER_NODES * sizeof(float)
+                 || (r > 0 && spans[i][r].offset != spans[i][r - 1].offset + spans[i][r - 1].size) )
+            {
+                fprintf(stderr, "%s span %d at offset %lld with %lld bytes misplaced\n", subrecs[i], r,
+                        (long long)spans[i][r].offset, (long long)spans[i][r].size);
+                exit(-1);
+            }
+        }
+    }
+}
+
+static void read_family(char *fname)
+{
+    float data[NODE_QTY];
+    Famid fid;
+    int state, i, j, stat;
+
+    stat = mc_open(fname, ".", "r", &fid);
+    if ( stat != OK )
+    {
+        fail("mc_open (read)", stat);
+    }
+
+    for ( state = 1; state <= STATE_QTY; state++ )
+    {
+        for ( i = 0; i < SUBREC_QTY; i++ )
+        {
+            stat = mc_read_results(fid, state, i, 1, names + i, data);
+            if ( stat != OK )
+            {
+                fail("mc_read_results", stat);
+            }
+            for ( j = 0; j < NODE_QTY; j++ )
+            {
+                if ( data[j] != node_value(i, state, j + 1) )
+                {
+                    fprintf(stderr, "%s: %s state %d node %d read %f, expected %f\n", fname, subrecs[i], state,
+                            j + 1, data[j], node_value(i, state, j + 1));
+                    exit(-1);
+                }
+            }
+        }
+    }
+
+    stat = mc_close(fid);
+    if ( stat != OK )
+    {
+        fail("mc_close (read)", stat);
+    }
+}
+
+static void write_family(char *fname, char *mode)
+{
+    Shared_span spans[SUBREC_QTY][WRITER_QTY];
+    Shared_span overlap[2];
+    Writer writers[WRITER_QTY];
+    pthread_t threads[WRITER_QTY];
+    int file_suffix, state_index;
+    Famid fid;
+    int sid, state, i, r, stat;
+
+    stat = mc_open(fname, ".", mode, &fid);
+    if ( stat != OK )
+    {
+        fail("mc_open (write)", stat);
+    }
+    mc_set_state_map_file_on(fid, 1);
+    define_family(fid, &sid);
+
+    overlap[0].subrec_name = subrecs[0];
+    overlap[0].start = 1;
+    overlap[0].stop = 3;
+    overlap[1].subrec_name = subrecs[0];
+    overlap[1].start = 3;
+    overlap[1].stop = 4;
+    if ( mc_map_shared_spans(fid, sid, 2, overlap) != OBJECT_RANGE_OVERLAP )
+    {
+        fprintf(stderr, "Overlapping spans accepted\n");
+        exit(-1);
+    }
+
+    for ( i = 0; i < SUBREC_QTY; i++ )
+    {
+        for ( r = 0; r < WRITER_QTY; r++ )
+        {
+            spans[i][r].subrec_name = subrecs[i];
+            spans[i][r].start = r * WRITER_NODES + 1;
+            spans[i][r].stop = (r + 1) * WRITER_NODES;
+        }
+    }
+    stat = mc_map_shared_spans(fid, sid, SUBREC_QTY * WRITER_QTY, &spans[0][0]);
+    if ( stat != OK )
+    {
+        fail("mc_map_shared_spans", stat);
+    }
+    check_spans(spans);
+
+    for ( state = 1; state <= STATE_QTY; state++ )
+    {
+        stat = mc_new_state(fid, sid, (float)state, &file_suffix, &state_index);
+        if ( stat != OK )
+        {
+            fail("mc_new_state", stat);
+        }
+
+        for ( r = 0; r < WRITER_QTY; r++ )
+        {
+            writers[r].fid = fid;
+            writers[r].state = state;
+            for ( i = 0; i < SUBREC_QTY; i++ )
+            {
+                writers[r].spans[i] = &spans[i][r];
+            }
+            if ( pthread_create(&threads[r], NULL, write_spans, &writers[r]) != 0 )
+            {
+                fprintf(stderr, "Unable to start writer %d\n", r);
+                exit(-1);
+            }
+        }
+        for ( r = 0; r < WRITER_QTY; r++ )
+        {
+            pthread_join(threads[r], NULL);
+            if ( writers[r].rval != OK )
+            {
+                fail("mc_wrt_shared_span", writers[r].rval);
+            }
+        }
+
+        stat = mc_end_state(fid, sid);
+        if ( stat != OK )
+        {
+            fail("mc_end_state", stat);
+        }
+    }
+
+    /* The records must be complete as soon as the states are ended. */
+    read_family(fname);
+
+    stat = mc_close(fid);
+    if ( stat != OK )
+    {
+        fail("mc_close (write)", stat);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    write_family("shared_spans_v3.plt", "AwPd");
+    read_family("shared_spans_v3.plt");
+
+    write_family("shared_spans_swap_v3.plt", "AwPdEb");
+    read_family("shared_spans_swap_v3.plt");
+
+    return 0;
+}
@@ -0,0 +1,301 @@
+/*
+ * state_align_v3.c:
+ *
+ * Write a family with aligned state records and check that every
+ * subrecord starts on, and is padded to, an aligned offset, that the
+ * family header marks the aligned layout (while a packed family keeps
+ * the older header version) and that the data reads back after the
+ * family is reopened and appended to.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mili.h"
+
+#define NODE_QTY  4
+#define FLUX_QTY  3
+#define ALIGNMENT 512
+#define STATE_QTY 3
+
+/* Header format version byte of the A-file character header. */
+#define HDR_VERSION_BYTE 4
+
+char *fname = "state_align_v3.plt";
+char *packed_fname = "state_align_packed_v3.plt";
+
+char *names[] = {"temp", "flux"};
+char *titles[] = {"Temperature", "Heat flux"};
+int types[] = {M_FLOAT, M_FLOAT};
+
+static void fail(char *what, int stat)
+{
+    mc_print_error(what, stat);
+    exit(-1);
+}
+
+static float temp_value(int state, int node)
+{
+    return (float)(100 * state + node);
+}
+
+static float flux_value(int state, int node)
+{
+    return (float)(-100 * state - node);
+}
+
+static void check_extent(Famid fid, char *subrec, LONGLONG data_size)
+{
+    LONGLONG offset, size;
+    int stat;
+
+    stat = mc_get_subrec_extent(fid, subrec, &offset, &size);
+    if ( stat != OK )
+    {
+        fail("mc_get_subrec_extent", stat);
+    }
+    if ( offset % ALIGNMENT != 0 || size % ALIGNMENT != 0 || size < data_size )
+    {
+        fprintf(stderr, "%s at offset %lld with %lld bytes is not aligned to %d\n", subrec, (long long)offset,
+                (long long)size, ALIGNMENT);
+        exit(-1);
+    }
+}
+
+static void write_state(Famid fid, int sid, int state, Bool_type aligned)
+{
+    float temps[NODE_QTY], fluxes[FLUX_QTY];
+    int file_suffix, state_index;
+    int i, stat;
+
+    for ( i = 0; i < NODE_QTY; i++ )
+    {
+        temps[i] = temp_value(state, i + 1);
+    }
+    for ( i = 0; i < FLUX_QTY; i++ )
+    {
+        fluxes[i] = flux_value(state, i + 1);
+    }
+
+    stat = mc_new_state(fid, sid, (float)state, &file_suffix, &state_index);
+    if ( stat != OK )
+    {
+        fail("mc_new_state", stat);
+    }
+    if ( aligned )
+    {
+        check_extent(fid, "NodeTemp", sizeof(temps));
+        check_extent(fid, "NodeFlux", sizeof(fluxes));
+    }
+    stat = mc_wrt_subrec(fid, "NodeTemp", 1, NODE_QTY, temps);
+    if ( stat == OK )
+    {
+        stat = mc_wrt_subrec(fid, "NodeFlux", 1, FLUX_QTY, fluxes);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_end_state(fid, sid);
+    }
+    if ( stat != OK )
+    {
+        fail("write_state", stat);
+    }
+}
+
+static void write_family(char *name, Bool_type aligned)
+{
+    float coords[NODE_QTY][3] = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}};
+    int mo_ids[2];
+    Famid fid;
+    int mid, sid, state, stat;
+
+    stat = mc_open(name, ".", "AwPd", &fid);
+    if ( stat != OK )
+    {
+        fail("mc_open (write)", stat);
+    }
+    mc_set_state_map_file_on(fid, 1);
+
+    if ( aligned )
+    {
+        if ( mc_set_state_alignment(fid, ALIGNMENT + 1) != NOT_APPLICABLE )
+        {
+            fprintf(stderr, "Alignment which is not a power of two accepted\n");
+            exit(-1);
+        }
+        stat = mc_set_state_alignment(fid, ALIGNMENT);
+        if ( stat != OK )
+        {
+            fail("mc_set_state_alignment", stat);
+        }
+    }
+
+    stat = mc_make_umesh(fid, "Align mesh", 3, &mid);
+    if ( stat == OK )
+    {
+        stat = mc_def_class(fid, mid, M_NODE, "node", "Nodal");
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_nodes(fid, mid, "node", 1, NODE_QTY, (float *)coords);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_svars(fid, 1, names[0], 0, titles[0], 0, types);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_svars(fid, 1, names[1], 0, titles[1], 0, types + 1);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_open_srec(fid, mid, &sid);
+    }
+    if ( stat == OK )
+    {
+        mo_ids[0] = 1;
+        mo_ids[1] = NODE_QTY;
+        stat = mc_def_subrec(fid, sid, "NodeTemp", OBJECT_ORDERED, 1, names[0], 0, "node", M_BLOCK_OBJ_FMT, 1, mo_ids,
+                             0);
+    }
+    if ( stat == OK )
+    {
+        mo_ids[1] = FLUX_QTY;
+        stat = mc_def_subrec(fid, sid, "NodeFlux", OBJECT_ORDERED, 1, names[1], 0, "node", M_BLOCK_OBJ_FMT, 1, mo_ids,
+                             0);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_close_srec(fid, sid);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_flush(fid, NON_STATE_DATA);
+    }
+    if ( stat != OK )
+    {
+        fail("write_family", stat);
+    }
+
+    if ( aligned && mc_set_state_alignment(fid, ALIGNMENT) != TOO_LATE )
+    {
+        fprintf(stderr, "Alignment accepted after a state record format\n");
+        exit(-1);
+    }
+
+    for ( state = 1; state <= STATE_QTY; state++ )
+    {
+        write_state(fid, sid, state, aligned);
+    }
+
+    stat = mc_close(fid);
+    if ( stat != OK )
+    {
+        fail("mc_close (write)", stat);
+    }
+}
+
+static int header_version(char *name)
+{
+    unsigned char header[HDR_VERSION_BYTE + 1];
+    char aname[128];
+    FILE *fp;
+
+    sprintf(aname, "%sA", name);
+    fp = fopen(aname, "rb");
+    if ( fp == NULL || fread(header, 1, sizeof(header), fp) != sizeof(header) )
+    {
+        fprintf(stderr, "Unable to read the header of %s\n", aname);
+        exit(-1);
+    }
+    fclose(fp);
+
+    return header[HDR_VERSION_BYTE];
+}
+
+static void read_family(char *name, int state_qty)
+{
+    float temps[NODE_QTY], fluxes[FLUX_QTY];
+    Famid fid;
+    int qty, state, i, stat;
+
+    stat = mc_open(name, ".", "r", &fid);
+    if ( stat != OK )
+    {
+        fail("mc_open (read)", stat);
+    }
+    stat = mc_query_family(fid, QTY_STATES, NULL, NULL, &qty);
+    if ( stat != OK )
+    {
+        fail("mc_query_family", stat);
+    }
+    if ( qty != state_qty )
+    {
+        fprintf(stderr, "%s: read %d states, expected %d\n", name, qty, state_qty);
+        exit(-1);
+    }
+
+    for ( state = 1; state <= state_qty; state++ )
+    {
+        stat = mc_read_results(fid, state, 0, 1, names, temps);
+        if ( stat == OK )
+        {
+            stat = mc_read_results(fid, state, 1, 1, names + 1, fluxes);
+        }
+        if ( stat != OK )
+        {
+            fail("mc_read_results", stat);
+        }
+        for ( i = 0; i < NODE_QTY; i++ )
+        {
+            if ( temps[i] != temp_value(state, i + 1) || (i < FLUX_QTY && fluxes[i] != flux_value(state, i + 1)) )
+            {
+                fprintf(stderr, "%s: state %d node %d read back wrong\n", name, state, i + 1);
+                exit(-1);
+            }
+        }
+    }
+
+    stat = mc_close(fid);
+    if ( stat != OK )
+    {
+        fail("mc_close (read)", stat);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Famid fid;
+    int aligned_version, packed_version;
+    int stat;
+
+    write_family(fname, TRUE);
+    write_family(packed_fname, FALSE);
+
+    aligned_version = header_version(fname);
+    packed_version = header_version(packed_fname);
+    if ( aligned_version <= packed_version )
+    {
+        fprintf(stderr, "Aligned family header version %d, packed family %d\n", aligned_version, packed_version);
+        exit(-1);
+    }
+
+    read_family(fname, STATE_QTY);
+    read_family(packed_fname, STATE_QTY);
+
+    /* An appended state must keep the layout. */
+    stat = mc_open(fname, ".", "AaPdEn", &fid);
+    if ( stat != OK )
+    {
+        fail("mc_open (append)", stat);
+    }
+    write_state(fid, 0, STATE_QTY + 1, TRUE);
+    stat = mc_close(fid);
+    if ( stat != OK )
+    {
+        fail("mc_close (append)", stat);
+    }
+    read_family(fname, STATE_QTY + 1);
+
+    return 0;
+}
@@ -0,0 +1,245 @@
+/*
+ * state_file_pool_v3.c:
+ *
+ * Read a multi-file family through a small state file pool.  States
+ * are read so that pooled descriptors are both reused and evicted, and
+ * the last state file is read, grown by a writer and read again to
+ * check the pool doesn't serve it with a stale size.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mili.h"
+
+#define NODE_QTY        4
+#define STATES_PER_FILE 2
+#define MAX_STATES      5
+
+char *fname = "state_file_pool_v3.plt";
+
+char *names[] = {"temp"};
+char *titles[] = {"Temperature"};
+int types[] = {M_FLOAT};
+
+static void fail(char *what, int stat)
+{
+    mc_print_error(what, stat);
+    exit(-1);
+}
+
+static float temp_value(int state, int node)
+{
+    return (float)(100 * state + node);
+}
+
+static void write_state(Famid fid, int sid, int state)
+{
+    float temps[NODE_QTY];
+    int file_suffix, state_index;
+    int i, stat;
+
+    stat = mc_new_state(fid, sid, (float)state, &file_suffix, &state_index);
+    if ( stat != OK )
+    {
+        fail("mc_new_state", stat);
+    }
+    for ( i = 0; i < NODE_QTY; i++ )
+    {
+        temps[i] = temp_value(state, i + 1);
+    }
+    stat = mc_wrt_subrec(fid, "NodeTemp", 1, NODE_QTY, temps);
+    if ( stat != OK )
+    {
+        fail("mc_wrt_subrec", stat);
+    }
+    stat = mc_end_state(fid, sid);
+    if ( stat != OK )
+    {
+        fail("mc_end_state", stat);
+    }
+}
+
+static void check_state(Famid fid, int state)
+{
+    float temps[NODE_QTY];
+    int i, stat;
+
+    stat = mc_read_results(fid, state, 0, 1, names, temps);
+    if ( stat != OK )
+    {
+        fail("mc_read_results", stat);
+    }
+    for ( i = 0; i < NODE_QTY; i++ )
+    {
+        if ( temps[i] != temp_value(state, i + 1) )
+        {
+            fprintf(stderr, "State %d node %d: read %f, expected %f\n", state, i + 1, temps[i],
+                    temp_value(state, i + 1));
+            exit(-1);
+        }
+    }
+}
+
+static void create_family(Famid *p_fid, int *p_sid)
+{
+    float coords[NODE_QTY][3] = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}};
+    int mo_ids[2];
+    int mid, stat;
+
+    stat = mc_open(fname, ".", "AwPd", p_fid);
+    if ( stat != OK )
+    {
+        fail("mc_open (write)", stat);
+    }
+    mc_set_state_map_file_on(*p_fid, 1);
+    mc_limit_states(*p_fid, STATES_PER_FILE);
+
+    stat = mc_make_umesh(*p_fid, "Pool mesh", 3, &mid);
+    if ( stat == OK )
+    {
+        stat = mc_def_class(*p_fid, mid, M_NODE, "node", "Nodal");
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_nodes(*p_fid, mid, "node", 1, NODE_QTY, (float *)coords);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_svars(*p_fid, 1, names[0], 0, titles[0], 0, types);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_open_srec(*p_fid, mid, p_sid);
+    }
+    if ( stat == OK )
+    {
+        mo_ids[0] = 1;
+        mo_ids[1] = NODE_QTY;
+        stat = mc_def_subrec(*p_fid, *p_sid, "NodeTemp", OBJECT_ORDERED, 1, names[0], 0, "node", M_BLOCK_OBJ_FMT, 1,
+                             mo_ids, 0);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_close_srec(*p_fid, *p_sid);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_flush(*p_fid, NON_STATE_DATA);
+    }
+    if ( stat != OK )
+    {
+        fail("create_family", stat);
+    }
+}
+
+/*
+ * Append states to the family.  The T-file the reader loads its state
+ * map from is only complete once the writer closes.
+ */
+static void append_states(int first, int last)
+{
+    Famid fid;
+    int state, stat;
+
+    stat = mc_open(fname, ".", "AaPdEn", &fid);
+    if ( stat != OK )
+    {
+        fail("mc_open (append)", stat);
+    }
+    for ( state = first; state <= last; state++ )
+    {
+        write_state(fid, 0, state);
+    }
+    stat = mc_close(fid);
+    if ( stat != OK )
+    {
+        fail("mc_close (append)", stat);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Famid fid, rid;
+    Io_stats stats;
+    int sid, state, stat;
+    int order[] = {1, 3, 2, 4, 5, 1, 5, 3}; /* files 0 1 0 1 2 0 2 1 */
+    int i;
+
+    create_family(&fid, &sid);
+    for ( state = 1; state <= MAX_STATES; state++ )
+    {
+        write_state(fid, sid, state);
+    }
+    stat = mc_close(fid);
+    if ( stat != OK )
+    {
+        fail("mc_close (write)", stat);
+    }
+
+    /*
+     * Two pooled descriptors for three state files, so reading back
+     * and forth both reuses descriptors and reopens evicted files.
+     */
+    stat = mc_open(fname, ".", "r", &rid);
+    if ( stat != OK )
+    {
+        fail("mc_open (read)", stat);
+    }
+    stat = mc_set_state_file_pool(rid, 2);
+    if ( stat == OK )
+    {
+        stat = mc_set_io_stats(rid, TRUE);
+    }
+    if ( stat != OK )
+    {
+        fail("pool setup", stat);
+    }
+
+    for ( i = 0; i < (int)(sizeof(order) / sizeof(order[0])); i++ )
+    {
+        check_state(rid, order[i]);
+    }
+
+    stat = mc_get_io_stats(rid, &stats);
+    if ( stat != OK )
+    {
+        fail("mc_get_io_stats", stat);
+    }
+    if ( stats.pool_hits == 0 || stats.pool_misses <= 3 )
+    {
+        fprintf(stderr, "Pool not reused and evicted: %lld hits, %lld misses, %lld closes\n",
+                (long long)stats.pool_hits, (long long)stats.pool_misses, (long long)stats.file_closes);
+        exit(-1);
+    }
+
+    /* Grow the last file while its descriptor is pooled. */
+    append_states(MAX_STATES + 1, MAX_STATES + 1);
+    stat = mc_reload_states(rid);
+    if ( stat != OK )
+    {
+        fail("mc_reload_states", stat);
+    }
+    check_state(rid, MAX_STATES + 1);
+    check_state(rid, MAX_STATES);
+
+    /* Starting another file completes the one that was growing. */
+    append_states(MAX_STATES + 2, MAX_STATES + 2);
+    stat = mc_reload_states(rid);
+    if ( stat != OK )
+    {
+        fail("mc_reload_states", stat);
+    }
+    for ( state = MAX_STATES + 2; state >= 1; state-- )
+    {
+        check_state(rid, state);
+    }
+
+    stat = mc_close(rid);
+    if ( stat != OK )
+    {
+        fail("mc_close (read)", stat);
+    }
+
+    return 0;
+}
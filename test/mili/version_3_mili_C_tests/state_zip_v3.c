@@ -0,0 +1,256 @@
+/*
+ * state_zip_v3.c:
+ *
+ * Write a multi-file family whose state files are compressed at close
+ * and read every state back through the compressed files.  The family
+ * is then deleted, which must remove the compressed state files, and
+ * re-created with different data under the same name.  Last, a close
+ * that cannot compress a state file must report the failure.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mili.h"
+
+#define NODE_QTY        4
+#define STATES_PER_FILE 2
+#define STATE_QTY       5
+#define FILE_QTY        ((STATE_QTY + STATES_PER_FILE - 1) / STATES_PER_FILE)
+
+char *fname = "state_zip_v3.plt";
+
+char *names[] = {"temp"};
+char *titles[] = {"Temperature"};
+int types[] = {M_FLOAT};
+
+static void fail(char *what, int stat)
+{
+    mc_print_error(what, stat);
+    exit(-1);
+}
+
+static float temp_value(int generation, int state, int node)
+{
+    return (float)(1000 * generation + 10 * state + node);
+}
+
+static Bool_type file_exists(char *name)
+{
+    FILE *fp;
+
+    fp = fopen(name, "rb");
+    if ( fp == NULL )
+    {
+        return FALSE;
+    }
+    fclose(fp);
+    return TRUE;
+}
+
+/* Write the family and return the status of its close. */
+static int write_family(int generation)
+{
+    float coords[NODE_QTY][3] = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}};
+    float temps[NODE_QTY];
+    int mo_ids[2];
+    int file_suffix, state_index;
+    Famid fid;
+    int mid, sid, state, i, stat;
+
+    stat = mc_open(fname, ".", "AwPd", &fid);
+    if ( stat != OK )
+    {
+        fail("mc_open (write)", stat);
+    }
+    mc_set_state_map_file_on(fid, 1);
+    mc_limit_states(fid, STATES_PER_FILE);
+
+    stat = mc_set_state_compression(fid, M_CODEC_RLE);
+    if ( stat == OK )
+    {
+        stat = mc_make_umesh(fid, "Zip mesh", 3, &mid);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_class(fid, mid, M_NODE, "node", "Nodal");
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_nodes(fid, mid, "node", 1, NODE_QTY, (float *)coords);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_svars(fid, 1, names[0], 0, titles[0], 0, types);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_open_srec(fid, mid, &sid);
+    }
+    if ( stat == OK )
+    {
+        mo_ids[0] = 1;
+        mo_ids[1] = NODE_QTY;
+        stat = mc_def_subrec(fid, sid, "NodeTemp", OBJECT_ORDERED, 1, names[0], 0, "node", M_BLOCK_OBJ_FMT, 1, mo_ids,
+                             0);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_close_srec(fid, sid);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_flush(fid, NON_STATE_DATA);
+    }
+    if ( stat != OK )
+    {
+        fail("write_family", stat);
+    }
+
+    for ( state = 1; state <= STATE_QTY; state++ )
+    {
+        for ( i = 0; i < NODE_QTY; i++ )
+        {
+            temps[i] = temp_value(generation, state, i + 1);
+        }
+        stat = mc_new_state(fid, sid, (float)state, &file_suffix, &state_index);
+        if ( stat == OK )
+        {
+            stat = mc_wrt_subrec(fid, "NodeTemp", 1, NODE_QTY, temps);
+        }
+        if ( stat == OK )
+        {
+            stat = mc_end_state(fid, sid);
+        }
+        if ( stat != OK )
+        {
+            fail("write state", stat);
+        }
+    }
+
+    return mc_close(fid);
+}
+
+/* Every state file must have been replaced by its compressed form. */
+static void check_files(Bool_type expect_zip)
+{
+    char name[128];
+    int i;
+
+    for ( i = 0; i < FILE_QTY; i++ )
+    {
+        sprintf(name, "%s%02d", fname, i);
+        if ( file_exists(name) )
+        {
+            fprintf(stderr, "Uncompressed state file %s found\n", name);
+            exit(-1);
+        }
+        strcat(name, "z");
+        if ( file_exists(name) != expect_zip )
+        {
+            fprintf(stderr, "Compressed state file %s %s\n", name, expect_zip ? "missing" : "left behind");
+            exit(-1);
+        }
+    }
+}
+
+static void read_family(int generation)
+{
+    float temps[NODE_QTY];
+    Famid fid;
+    int qty, state, i, stat;
+
+    stat = mc_open(fname, ".", "r", &fid);
+    if ( stat != OK )
+    {
+        fail("mc_open (read)", stat);
+    }
+    stat = mc_query_family(fid, QTY_STATES, NULL, NULL, &qty);
+    if ( stat != OK )
+    {
+        fail("mc_query_family", stat);
+    }
+    if ( qty != STATE_QTY )
+    {
+        fprintf(stderr, "Read %d states, expected %d\n", qty, STATE_QTY);
+        exit(-1);
+    }
+
+    /* Backwards, so each compressed file is reopened at least once. */
+    for ( state = STATE_QTY; state >= 1; state-- )
+    {
+        stat = mc_read_results(fid, state, 0, 1, names, temps);
+        if ( stat != OK )
+        {
+            fail("mc_read_results", stat);
+        }
+        for ( i = 0; i < NODE_QTY; i++ )
+        {
+            if ( temps[i] != temp_value(generation, state, i + 1) )
+            {
+                fprintf(stderr, "Generation %d state %d node %d: read %f, expected %f\n", generation, state, i + 1,
+                        temps[i], temp_value(generation, state, i + 1));
+                exit(-1);
+            }
+        }
+    }
+
+    stat = mc_close(fid);
+    if ( stat != OK )
+    {
+        fail("mc_close (read)", stat);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    char tname[128];
+    int stat;
+
+    stat = write_family(1);
+    if ( stat != OK )
+    {
+        fail("mc_close (write)", stat);
+    }
+    check_files(TRUE);
+    read_family(1);
+
+    stat = mc_delete_family(fname, ".");
+    if ( stat != OK )
+    {
+        fail("mc_delete_family", stat);
+    }
+    check_files(FALSE);
+
+    stat = write_family(2);
+    if ( stat != OK )
+    {
+        fail("mc_close (write)", stat);
+    }
+    check_files(TRUE);
+    read_family(2);
+
+    /* Block the temporary name the first compressed file is written to. */
+    stat = mc_delete_family(fname, ".");
+    if ( stat != OK )
+    {
+        fail("mc_delete_family", stat);
+    }
+    sprintf(tname, "%s00z.tmp", fname);
+    if ( mkdir(tname, 0755) != 0 )
+    {
+        fprintf(stderr, "Unable to create %s\n", tname);
+        exit(-1);
+    }
+    stat = write_family(3);
+    rmdir(tname);
+    if ( stat == OK )
+    {
+        fprintf(stderr, "Close that failed to compress returned OK\n");
+        exit(-1);
+    }
+
+    return 0;
+}
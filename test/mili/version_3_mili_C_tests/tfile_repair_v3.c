@@ -0,0 +1,236 @@
+/*
+ * tfile_repair_v3.c:
+ *
+ * Write a family whose states span several state files, then cut its
+ * T-file short as a writer dying before the end marker would.  The
+ * reopen must rebuild the T-file from every state file, not just the
+ * first, so all states are mapped with their times and data.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "mili.h"
+
+#define NODE_QTY        4
+#define STATES_PER_FILE 2
+#define STATE_QTY       5
+
+char *fname = "tfile_repair_v3.plt";
+
+char *names[] = {"temp"};
+char *titles[] = {"Temperature"};
+int types[] = {M_FLOAT};
+
+static void fail(char *what, int stat)
+{
+    mc_print_error(what, stat);
+    exit(-1);
+}
+
+static float state_time(int state)
+{
+    return (float)(state - 1) * 0.1f;
+}
+
+static float temp_value(int state, int node)
+{
+    return (float)(10 * state + node);
+}
+
+static void write_family(void)
+{
+    float coords[NODE_QTY][3] = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}};
+    int labels[NODE_QTY] = {1, 2, 3, 4};
+    int contacts[NODE_QTY][3] = {{1, 1, 1}, {2, 1, 1}, {3, 1, 1}, {4, 1, 1}};
+    float temps[NODE_QTY];
+    int mo_ids[2];
+    int file_suffix, state_index;
+    Famid fid;
+    int mid, sid, state, i, stat;
+
+    stat = mc_open(fname, ".", "AwPd", &fid);
+    if ( stat != OK )
+    {
+        fail("mc_open (write)", stat);
+    }
+    mc_set_state_map_file_on(fid, 1);
+    mc_limit_states(fid, STATES_PER_FILE);
+
+    stat = mc_wrt_string(fid, "title", "T-file repair test");
+    if ( stat == OK )
+    {
+        stat = mc_make_umesh(fid, "Repair mesh", 3, &mid);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_class(fid, mid, M_MESH, "mesh", "Mesh");
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_class_idents(fid, mid, "mesh", 1, 1);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_class(fid, mid, M_MAT, "mat", "Material");
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_class_idents(fid, mid, "mat", 1, 1);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_class(fid, mid, M_NODE, "node", "Nodal");
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_nodes(fid, mid, "node", 1, NODE_QTY, (float *)coords);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_node_labels(fid, mid, "node", NODE_QTY, labels);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_svars(fid, 1, names[0], 0, titles[0], 0, types);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_class(fid, mid, M_PARTICLE, "node_contact", "Contact Nodes");
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_conn_seq_labels(fid, mid, "node_contact", 1, NODE_QTY, labels, (int *)contacts);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_open_srec(fid, mid, &sid);
+    }
+    if ( stat == OK )
+    {
+        mo_ids[0] = 1;
+        mo_ids[1] = NODE_QTY;
+        stat = mc_def_subrec(fid, sid, "ContactTemp", OBJECT_ORDERED, 1, names[0], 0, "node_contact", M_BLOCK_OBJ_FMT,
+                             1, mo_ids, 0);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_close_srec(fid, sid);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_flush(fid, NON_STATE_DATA);
+    }
+    if ( stat != OK )
+    {
+        fail("write_family", stat);
+    }
+
+    for ( state = 1; state <= STATE_QTY; state++ )
+    {
+        for ( i = 0; i < NODE_QTY; i++ )
+        {
+            temps[i] = temp_value(state, i + 1);
+        }
+        stat = mc_new_state(fid, sid, state_time(state), &file_suffix, &state_index);
+        if ( stat == OK )
+        {
+            stat = mc_wrt_subrec(fid, "ContactTemp", 1, NODE_QTY, temps);
+        }
+        if ( stat == OK )
+        {
+            stat = mc_end_state(fid, sid);
+        }
+        if ( stat != OK )
+        {
+            fail("write state", stat);
+        }
+    }
+
+    stat = mc_close(fid);
+    if ( stat != OK )
+    {
+        fail("mc_close (write)", stat);
+    }
+}
+
+static void check_family(void)
+{
+    float temps[NODE_QTY];
+    float times[STATE_QTY];
+    int range[2];
+    Famid fid;
+    int qty, state, i, stat;
+
+    stat = mc_open(fname, ".", "r", &fid);
+    if ( stat != OK )
+    {
+        fail("mc_open (read)", stat);
+    }
+    stat = mc_query_family(fid, QTY_STATES, NULL, NULL, &qty);
+    if ( stat != OK )
+    {
+        fail("mc_query_family", stat);
+    }
+    if ( qty != STATE_QTY )
+    {
+        fprintf(stderr, "Rebuilt T-file maps %d of %d states\n", qty, STATE_QTY);
+        exit(-1);
+    }
+
+    range[0] = 1;
+    range[1] = STATE_QTY;
+    stat = mc_query_family(fid, SERIES_TIMES, range, NULL, times);
+    if ( stat != OK )
+    {
+        fail("mc_query_family (times)", stat);
+    }
+    for ( state = 1; state <= STATE_QTY; state++ )
+    {
+        stat = mc_read_results(fid, state, 0, 1, names, temps);
+        if ( stat != OK )
+        {
+            fail("mc_read_results", stat);
+        }
+        for ( i = 0; i < NODE_QTY; i++ )
+        {
+            if ( temps[i] != temp_value(state, i + 1) )
+            {
+                fprintf(stderr, "State %d contact %d: read %f, expected %f\n", state, i + 1, temps[i],
+                        temp_value(state, i + 1));
+                exit(-1);
+            }
+        }
+        if ( times[state - 1] != state_time(state) )
+        {
+            fprintf(stderr, "State %d: time %f, expected %f\n", state, times[state - 1], state_time(state));
+            exit(-1);
+        }
+    }
+
+    stat = mc_close(fid);
+    if ( stat != OK )
+    {
+        fail("mc_close (read)", stat);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    char t_name[128];
+
+    write_family();
+
+    /* Keep one whole state map entry and part of a second. */
+    sprintf(t_name, "%sT", fname);
+    if ( truncate(t_name, 30) != 0 )
+    {
+        fprintf(stderr, "Unable to truncate %s\n", t_name);
+        exit(-1);
+    }
+
+    check_family();
+
+    return 0;
+}
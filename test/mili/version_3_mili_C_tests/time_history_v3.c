@@ -0,0 +1,268 @@
+/*
+ * time_history_v3.c:
+ *
+ * Write a family with a time-history stream whose chunks hold fewer
+ * states than are written, then read object histories back from the
+ * writer, where the last chunk is still in memory, and after a
+ * reopen.  A restart must drop the pruned states from the stream, and
+ * deleting the family must remove the stream file too.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mili.h"
+
+#define NODE_QTY      4
+#define CHUNK_STATES  2
+#define STATE_QTY     5
+#define RESTART_STATE 3
+
+char *fname = "time_history_v3.plt";
+
+char *names[] = {"temp"};
+char *titles[] = {"Temperature"};
+int types[] = {M_FLOAT};
+char *th_subrecs[] = {"NodeTemp"};
+
+static void fail(char *what, int stat)
+{
+    mc_print_error(what, stat);
+    exit(-1);
+}
+
+/* Node 4 is only written on odd states, so reads back zero otherwise. */
+static float temp_value(int state, int node)
+{
+    if ( node == NODE_QTY && state % 2 == 0 )
+    {
+        return 0.0;
+    }
+    return (float)(100 * state + node);
+}
+
+static void write_state(Famid fid, int sid, int state)
+{
+    float temps[NODE_QTY];
+    int file_suffix, state_index;
+    int i, stat;
+
+    for ( i = 0; i < NODE_QTY; i++ )
+    {
+        temps[i] = temp_value(state, i + 1);
+    }
+
+    stat = mc_new_state(fid, sid, (float)state, &file_suffix, &state_index);
+    if ( stat == OK )
+    {
+        stat = mc_wrt_subrec(fid, "NodeTemp", 1, NODE_QTY - 1, temps);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_wrt_subrec(fid, "NodeTemp", NODE_QTY, NODE_QTY, temps + NODE_QTY - 1);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_end_state(fid, sid);
+    }
+    if ( stat != OK )
+    {
+        fail("write_state", stat);
+    }
+}
+
+static void create_family(Famid *p_fid, int *p_sid)
+{
+    float coords[NODE_QTY][3] = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}};
+    int mo_ids[2];
+    int mid, stat;
+
+    stat = mc_open(fname, ".", "AwPd", p_fid);
+    if ( stat != OK )
+    {
+        fail("mc_open (write)", stat);
+    }
+    mc_set_state_map_file_on(*p_fid, 1);
+
+    stat = mc_make_umesh(*p_fid, "History mesh", 3, &mid);
+    if ( stat == OK )
+    {
+        stat = mc_def_class(*p_fid, mid, M_NODE, "node", "Nodal");
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_nodes(*p_fid, mid, "node", 1, NODE_QTY, (float *)coords);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_svars(*p_fid, 1, names[0], 0, titles[0], 0, types);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_open_srec(*p_fid, mid, p_sid);
+    }
+    if ( stat == OK )
+    {
+        mo_ids[0] = 1;
+        mo_ids[1] = NODE_QTY;
+        stat = mc_def_subrec(*p_fid, *p_sid, "NodeTemp", OBJECT_ORDERED, 1, names[0], 0, "node", M_BLOCK_OBJ_FMT, 1,
+                             mo_ids, 0);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_close_srec(*p_fid, *p_sid);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_flush(*p_fid, NON_STATE_DATA);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_open_th(*p_fid, CHUNK_STATES, 1, th_subrecs);
+    }
+    if ( stat != OK )
+    {
+        fail("create_family", stat);
+    }
+}
+
+/* Check each node's history, whole and from the middle of a chunk. */
+static void check_history(Famid fid, char *who, int state_qty)
+{
+    float temps[STATE_QTY];
+    int first, last;
+    int node, state, stat;
+
+    stat = mc_get_th_states(fid, &first, &last);
+    if ( stat != OK )
+    {
+        fail("mc_get_th_states", stat);
+    }
+    if ( first != 1 || last != state_qty )
+    {
+        fprintf(stderr, "%s: stream holds states %d to %d, expected 1 to %d\n", who, first, last, state_qty);
+        exit(-1);
+    }
+
+    for ( node = 1; node <= NODE_QTY; node++ )
+    {
+        stat = mc_read_th(fid, "NodeTemp", node, 1, state_qty, temps);
+        if ( stat != OK )
+        {
+            fail("mc_read_th", stat);
+        }
+        for ( state = 1; state <= state_qty; state++ )
+        {
+            if ( temps[state - 1] != temp_value(state, node) )
+            {
+                fprintf(stderr, "%s: node %d state %d read %f, expected %f\n", who, node, state, temps[state - 1],
+                        temp_value(state, node));
+                exit(-1);
+            }
+        }
+
+        stat = mc_read_th(fid, "NodeTemp", node, 2, state_qty - 1, temps);
+        if ( stat != OK )
+        {
+            fail("mc_read_th (partial)", stat);
+        }
+        for ( state = 2; state <= state_qty - 1; state++ )
+        {
+            if ( temps[state - 2] != temp_value(state, node) )
+            {
+                fprintf(stderr, "%s: node %d state %d partial read %f, expected %f\n", who, node, state,
+                        temps[state - 2], temp_value(state, node));
+                exit(-1);
+            }
+        }
+    }
+
+    if ( mc_read_th(fid, "NodeTemp", NODE_QTY + 1, 1, 1, temps) != INVALID_INDEX
+         || mc_read_th(fid, "NodeTemp", 1, 1, state_qty + 1, temps) != INVALID_STATE
+         || mc_read_th(fid, "NoSuchSubrec", 1, 1, 1, temps) != NO_MATCH )
+    {
+        fprintf(stderr, "%s: out of range history read not rejected\n", who);
+        exit(-1);
+    }
+    if ( mc_read_th(fid, NULL, 1, 1, 1, temps) != NULL_POINTER
+         || mc_read_th(fid, "NodeTemp", 1, 1, 1, NULL) != NULL_POINTER )
+    {
+        fprintf(stderr, "%s: history read without a name or buffer not rejected\n", who);
+        exit(-1);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Famid fid, rid;
+    FILE *fp;
+    char th_name[128];
+    int sid, state, stat;
+
+    create_family(&fid, &sid);
+    for ( state = 1; state <= STATE_QTY; state++ )
+    {
+        write_state(fid, sid, state);
+    }
+    check_history(fid, "writer", STATE_QTY);
+
+    stat = mc_close(fid);
+    if ( stat != OK )
+    {
+        fail("mc_close (write)", stat);
+    }
+
+    stat = mc_open(fname, ".", "r", &rid);
+    if ( stat != OK )
+    {
+        fail("mc_open (read)", stat);
+    }
+    check_history(rid, "reader", STATE_QTY);
+    stat = mc_close(rid);
+    if ( stat != OK )
+    {
+        fail("mc_close (read)", stat);
+    }
+
+    stat = mc_open(fname, ".", "AaPdEn", &fid);
+    if ( stat == OK )
+    {
+        stat = mc_restart_at_state(fid, 0, RESTART_STATE);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_close(fid);
+    }
+    if ( stat != OK )
+    {
+        fail("restart", stat);
+    }
+
+    stat = mc_open(fname, ".", "r", &rid);
+    if ( stat != OK )
+    {
+        fail("mc_open (restarted)", stat);
+    }
+    check_history(rid, "restarted", RESTART_STATE);
+    stat = mc_close(rid);
+    if ( stat != OK )
+    {
+        fail("mc_close (restarted)", stat);
+    }
+
+    sprintf(th_name, "%sth", fname);
+    stat = mc_delete_family(fname, ".");
+    if ( stat != OK )
+    {
+        fail("mc_delete_family", stat);
+    }
+    fp = fopen(th_name, "rb");
+    if ( fp != NULL )
+    {
+        fclose(fp);
+        fprintf(stderr, "%s left behind by mc_delete_family\n", th_name);
+        exit(-1);
+    }
+
+    return 0;
+}
@@ -0,0 +1,354 @@
+/*
+ * wrt_subrecs_v3.c:
+ *
+ * Write the same states to two families, one subrecord at a time with
+ * mc_wrt_subrec() and in batches with mc_wrt_subrecs(), and check the
+ * state files are identical.  The batches split lump ranges and write
+ * them out of file order, so they are gathered into several runs, and
+ * are mixed with single writes in the same state.  Some writes go
+ * through subrecord handles, which are also checked to reject bad
+ * families and handles, writes outside a state and read-only
+ * families.  Both native and big-endian families are written.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mili.h"
+
+#define NODE_QTY    8
+#define GLOBAL_QTY  3
+#define NAME_LEN    16
+#define MAX_STATES  3
+
+char node_names[2][NAME_LEN] = {"temp", "flux"};
+char node_titles[2][NAME_LEN] = {"Temperature", "Heat flux"};
+char global_names[GLOBAL_QTY][NAME_LEN] = {"ke", "pe", "te"};
+char global_titles[GLOBAL_QTY][NAME_LEN] = {"Kinetic energy", "Potential energy", "Total energy"};
+int types[GLOBAL_QTY] = {M_FLOAT, M_FLOAT, M_FLOAT};
+
+static void fail(char *what, int stat)
+{
+    mc_print_error(what, stat);
+    exit(-1);
+}
+
+static void create_family(char *fname, char *mode, Famid *p_fid, int *p_sid)
+{
+    float coords[NODE_QTY][3] = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0},
+                                 {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}};
+    int mo_ids[2];
+    int mid, stat;
+
+    stat = mc_open(fname, ".", mode, p_fid);
+    if ( stat != OK )
+    {
+        fail("mc_open (write)", stat);
+    }
+    mc_set_state_map_file_on(*p_fid, 1);
+
+    stat = mc_make_umesh(*p_fid, "Batch mesh", 3, &mid);
+    if ( stat == OK )
+    {
+        stat = mc_def_class(*p_fid, mid, M_MESH, "mesh", "Mesh");
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_class_idents(*p_fid, mid, "mesh", 1, 1);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_class(*p_fid, mid, M_NODE, "node", "Nodal");
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_nodes(*p_fid, mid, "node", 1, NODE_QTY, (float *)coords);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_svars(*p_fid, 2, node_names[0], NAME_LEN, node_titles[0], NAME_LEN, types);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_svars(*p_fid, GLOBAL_QTY, global_names[0], NAME_LEN, global_titles[0], NAME_LEN, types);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_open_srec(*p_fid, mid, p_sid);
+    }
+    mo_ids[0] = 1;
+    mo_ids[1] = NODE_QTY;
+    if ( stat == OK )
+    {
+        stat = mc_def_subrec(*p_fid, *p_sid, "NodeTemp", OBJECT_ORDERED, 1, node_names[0], NAME_LEN, "node",
+                             M_BLOCK_OBJ_FMT, 1, mo_ids, 0);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_def_subrec(*p_fid, *p_sid, "NodeFlux", OBJECT_ORDERED, 1, node_names[1], NAME_LEN, "node",
+                             M_BLOCK_OBJ_FMT, 1, mo_ids, 0);
+    }
+    mo_ids[0] = 1;
+    mo_ids[1] = 1;
+    if ( stat == OK )
+    {
+        stat = mc_def_subrec(*p_fid, *p_sid, "Globals", RESULT_ORDERED, GLOBAL_QTY, global_names[0], NAME_LEN, "mesh",
+                             M_BLOCK_OBJ_FMT, 1, mo_ids, 0);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_close_srec(*p_fid, *p_sid);
+    }
+    if ( stat == OK )
+    {
+        stat = mc_flush(*p_fid, NON_STATE_DATA);
+    }
+    if ( stat != OK )
+    {
+        fail("create_family", stat);
+    }
+}
+
+static void fill_state(int state, float *temps, float *fluxes, float *globals)
+{
+    int i;
+
+    for ( i = 0; i < NODE_QTY; i++ )
+    {
+        temps[i] = 100.0 * state + i;
+        fluxes[i] = -10.0 * state - i;
+    }
+    for ( i = 0; i < GLOBAL_QTY; i++ )
+    {
+        globals[i] = 1000.0 * state + i;
+    }
+}
+
+/* Write the reference family one subrecord at a time. */
+static void write_single(char *fname, char *mode)
+{
+    float temps[NODE_QTY], fluxes[NODE_QTY], globals[GLOBAL_QTY];
+    int file_suffix, state_index;
+    Famid fid;
+    int sid, state, stat;
+
+    create_family(fname, mode, &fid, &sid);
+    for ( state = 0; state < MAX_STATES; state++ )
+    {
+        fill_state(state, temps, fluxes, globals);
+        stat = mc_new_state(fid, sid, (float)state, &file_suffix, &state_index);
+        if ( stat == OK )
+        {
+            stat = mc_wrt_subrec(fid, "NodeTemp", 1, NODE_QTY, temps);
+        }
+        if ( stat == OK )
+        {
+            stat = mc_wrt_subrec(fid, "NodeFlux", 1, NODE_QTY, fluxes);
+        }
+        if ( stat == OK )
+        {
+            stat = mc_wrt_subrec(fid, "Globals", 1, GLOBAL_QTY, globals);
+        }
+        if ( stat == OK )
+        {
+            stat = mc_end_state(fid, sid);
+        }
+        if ( stat != OK )
+        {
+            fail("write_single", stat);
+        }
+    }
+    stat = mc_close(fid);
+    if ( stat != OK )
+    {
+        fail("mc_close", stat);
+    }
+}
+
+static void expect(char *what, int stat, int expected)
+{
+    if ( stat != expected )
+    {
+        fprintf(stderr, "%s returned %d, expected %d\n", what, stat, expected);
+        exit(-1);
+    }
+}
+
+/* Write the same data with batched calls and subrecord handles. */
+static void write_batched(char *fname, char *mode)
+{
+    float temps[NODE_QTY], fluxes[NODE_QTY], globals[GLOBAL_QTY];
+    Subrec_write writes[3];
+    int file_suffix, state_index;
+    int flux_handle, globals_handle;
+    Famid fid;
+    int sid, state, stat;
+
+    create_family(fname, mode, &fid, &sid);
+
+    stat = mc_get_subrec_handle(fid, "NodeFlux", &flux_handle);
+    if ( stat == OK )
+    {
+        stat = mc_get_subrec_handle(fid, "Globals", &globals_handle);
+    }
+    if ( stat != OK )
+    {
+        fail("mc_get_subrec_handle", stat);
+    }
+
+    /* Handle writes are checked like named ones. */
+    fill_state(0, temps, fluxes, globals);
+    expect("mc_wrt_subrec_h (bad family)", mc_wrt_subrec_h(-1, flux_handle, 1, NODE_QTY, fluxes), BAD_FAMILY);
+    expect("mc_wrt_subrec_h (bad handle)", mc_wrt_subrec_h(fid, 99, 1, NODE_QTY, fluxes), INVALID_SUBREC_INDEX);
+    expect("mc_wrt_subrec_h (no state)", mc_wrt_subrec_h(fid, flux_handle, 1, NODE_QTY, fluxes),
+           STATE_NOT_INSTATIATED);
+    for ( state = 0; state < MAX_STATES; state++ )
+    {
+        fill_state(state, temps, fluxes, globals);
+        stat = mc_new_state(fid, sid, (float)state, &file_suffix, &state_index);
+        if ( stat != OK )
+        {
+            fail("mc_new_state", stat);
+        }
+
+        /*
+         * Out of file order, in two runs: NodeTemp 5-8, then NodeTemp
+         * 1-4 with the start of NodeFlux.
+         */
+        memset(writes, 0, sizeof(writes));
+        writes[0].subrec_name = "NodeTemp";
+        writes[0].start = 5;
+        writes[0].stop = NODE_QTY;
+        writes[0].data = temps + 4;
+        writes[1].subrec_name = "NodeTemp";
+        writes[1].start = 1;
+        writes[1].stop = 4;
+        writes[1].data = temps;
+        writes[2].subrec_name = "NodeFlux";
+        writes[2].start = 1;
+        writes[2].stop = 2;
+        writes[2].data = fluxes;
+        stat = mc_wrt_subrecs(fid, 3, writes);
+        if ( stat != OK )
+        {
+            fail("mc_wrt_subrecs", stat);
+        }
+
+        /* Unbatched writes mix with batched ones. */
+        stat = mc_wrt_subrec_h(fid, flux_handle, 3, NODE_QTY, fluxes + 2);
+        if ( stat != OK )
+        {
+            fail("mc_wrt_subrec_h", stat);
+        }
+
+        /* Result-ordered lumps; the stream is left at the end of the record. */
+        writes[0].subrec_name = NULL;
+        writes[0].handle = globals_handle;
+        writes[0].start = 1;
+        writes[0].stop = 1;
+        writes[0].data = globals;
+        writes[1].subrec_name = "Globals";
+        writes[1].start = 2;
+        writes[1].stop = GLOBAL_QTY;
+        writes[1].data = globals + 1;
+        stat = mc_wrt_subrecs(fid, 2, writes);
+        if ( stat == OK )
+        {
+            stat = mc_end_state(fid, sid);
+        }
+        if ( stat != OK )
+        {
+            fail("write_batched", stat);
+        }
+    }
+    stat = mc_close(fid);
+    if ( stat != OK )
+    {
+        fail("mc_close", stat);
+    }
+}
+
+static void compare_files(char *name_a, char *name_b)
+{
+    FILE *p_a, *p_b;
+    int c_a, c_b;
+    long size = 0;
+
+    p_a = fopen(name_a, "rb");
+    p_b = fopen(name_b, "rb");
+    if ( p_a == NULL || p_b == NULL )
+    {
+        fprintf(stderr, "Unable to open %s or %s\n", name_a, name_b);
+        exit(-1);
+    }
+    do
+    {
+        c_a = getc(p_a);
+        c_b = getc(p_b);
+        size++;
+    } while ( c_a == c_b && c_a != EOF );
+    fclose(p_a);
+    fclose(p_b);
+
+    if ( c_a != c_b || size < 2 )
+    {
+        fprintf(stderr, "%s and %s differ at byte %ld\n", name_a, name_b, size - 1);
+        exit(-1);
+    }
+}
+
+static void check_read(char *fname)
+{
+    float temps[NODE_QTY], fluxes[NODE_QTY], globals[GLOBAL_QTY];
+    float read_temps[NODE_QTY];
+    char *result[] = {node_names[0]};
+    Famid fid;
+    int handle;
+    int i, state, stat;
+
+    stat = mc_open(fname, ".", "r", &fid);
+    if ( stat == OK )
+    {
+        stat = mc_get_subrec_handle(fid, "NodeTemp", &handle);
+    }
+    if ( stat != OK )
+    {
+        fail("mc_open (read)", stat);
+    }
+    expect("mc_wrt_subrec_h (read only)", mc_wrt_subrec_h(fid, handle, 1, NODE_QTY, read_temps), BAD_ACCESS_TYPE);
+    for ( state = 0; state < MAX_STATES; state++ )
+    {
+        fill_state(state, temps, fluxes, globals);
+        stat = mc_read_results(fid, state + 1, 0, 1, result, read_temps);
+        if ( stat != OK )
+        {
+            fail("mc_read_results", stat);
+        }
+        for ( i = 0; i < NODE_QTY; i++ )
+        {
+            if ( read_temps[i] != temps[i] )
+            {
+                fprintf(stderr, "State %d node %d: read %f, expected %f\n", state + 1, i + 1, read_temps[i],
+                        temps[i]);
+                exit(-1);
+            }
+        }
+    }
+    mc_close(fid);
+}
+
+int main(int argc, char *argv[])
+{
+    write_single("wrt_subrecs_ref_v3.plt", "AwPdEn");
+    write_batched("wrt_subrecs_v3.plt", "AwPdEn");
+    compare_files("wrt_subrecs_ref_v3.plt00", "wrt_subrecs_v3.plt00");
+    check_read("wrt_subrecs_v3.plt");
+
+    /* Swapped data goes through the batch's scratch buffer. */
+    write_single("wrt_subrecs_ref_be_v3.plt", "AwPdEb");
+    write_batched("wrt_subrecs_be_v3.plt", "AwPdEb");
+    compare_files("wrt_subrecs_ref_be_v3.plt00", "wrt_subrecs_be_v3.plt00");
+    check_read("wrt_subrecs_be_v3.plt");
+
+    return 0;
+}
@@ -25,7 +25,17 @@ mapping = {
         "suite_dir": "mili/version_3_mili_C_tests",
         "testnames": ["mixdb_wrt_stream_v3",
                       "mixdb_repair_v3",
+                      "tfile_repair_v3",
+                      "open_index_v3",
                       "mixdb_wrt_subrec_v3",
+                      "wrt_subrecs_v3",
+                      "param_batch_v3",
+                      "state_zip_v3",
+                      "state_align_v3",
+                      "shared_spans_v3",
+                      "time_history_v3",
+                      "label_map_v3",
+                      "io_stats_v3",
                       "restart_v3",
                       "restart_zero_v3",
                       "restart_statelimit_a_v3",
@@ -33,6 +43,7 @@ mapping = {
                       "restart_statelimit_c_v3",
                       "restart_past_last_state_v3",
                       "state_write_check_v3",
+                      "state_file_pool_v3",
                       "value_change_v3",
                       "del_test_v3"],
         "file_suffix": "c",
@@ -21,6 +21,9 @@
  *  I. R. Corey - October 18, 2012: Modified to read all node class
  *                                  svars.
  *
+ *  Results are now read through a one-time result plan, one
+ *  subrecord read per state, with optional binary column output.
+ *
  *************************************************************************
  */
 
@@ -31,8 +34,14 @@
 #include "mili_internal.h"
 #include "mr.h"
 
-static void dump_result(int dbid, FILE *fp, int state, char *svar_name, char *class_name, float *result, int qty_result,
-                        int result_veclen, char **field_names, int block_qty, int *block_list);
+static void add_fields(char *class_name, int svar_qty, char **svar_names, char **classes, char **svars,
+                       int *field_qty);
+static double result_value(Mr_field *p_field, int index);
+static void dump_result(FILE *fp, int state, float time, Mr_field *p_field, char **labels);
+static void column_name(char *fname, Mr_field *p_field);
+static FILE *open_columns(Mr_result_plan *p_plan, FILE **fcols);
+static void write_columns(FILE *fp, Mr_field *p_field);
+static void close_columns(Mr_result_plan *p_plan, FILE **fcols, FILE *fp, int first_state, int state_qty);
 static void scan_args(int argc, char *argv[], int last_state);
 static void usage(void);
 
@@ -45,6 +54,7 @@ static char *result_class = NULL, *result_var = NULL;
 static int result_class_set = FALSE, result_var_set = FALSE;
 static int start_state = 1, stop_state = 1, single_state = 1;
 static int max_states_per_file = 1000000;
+static int binary_output = FALSE;
 
 int main(int argc, char *argv[])
 {
@@ -81,8 +91,6 @@ int main(int argc, char *argv[])
     int qty_hex = 0, *conn_hex = NULL, *mat_hex = NULL, num_mats_hex, *mat_list_hex, *part_hex = NULL,
         *elemIds_hex = NULL, *labels_hex = NULL;
     
-    int qty = 0;
-
     int total_zones = 0;
     int state, qty_states = 1;
 
@@ -96,10 +104,8 @@ int main(int argc, char *argv[])
     int subrec_names_len = 0;
 
     /* State variable data */
-    char svar_name[256];
     State_variable p_sv;
     int field_qty = 0;
-    char *field_names[256];
 
     int subrec_vars_len_node = 0, subrec_vars_len_beam = 0, subrec_vars_len_brick = 0, subrec_vars_len_shell = 0;
 
@@ -108,9 +114,13 @@ int main(int argc, char *argv[])
     char **subrec_names_brick = NULL, **subrec_vars_brick = NULL;
     char **subrec_names_shell = NULL, **subrec_vars_shell = NULL;
 
-    /* Result variables */
-    int result_veclen = 0, result_type = 0;
-    float *results_flt = NULL; 
+    /* Result plan variables */
+    Mr_result_plan *p_plan;
+    Mr_field *p_field;
+    char **plan_classes, **plan_svars;
+    char ***field_labels;
+    FILE **fcols = NULL;
+    float time = 0.0;
 
     /* Mili parameter variables - constants and non time dependent variables */
     int num_params = 0, num_params_ti = 0;
@@ -256,8 +266,11 @@ int main(int argc, char *argv[])
     /* Dump the Subrecord definitions (TOC) to a file */
 
     /* Set a default output file name */
-    strcpy(fname_out, fname_in);
-    strcat(fname_out, "-OUTPUT");
+    if ( fname_out[0] == '\0' )
+    {
+        strcpy(fname_out, fname_in);
+        strcat(fname_out, "-OUTPUT");
+    }
     printf("\nDumping table of contents (Subrecords) to file [%s-SUBRECS]\n", fname_out);
     status = mc_mr_dump_subrecs(dbid, fname_out, subrec_count, p_subrec);
 
@@ -312,8 +325,9 @@ int main(int argc, char *argv[])
     }
 
     /***********************************************
-     * Read results per state and write to a file
-     *    - from start_state to stop_state
+     * Plan all requested results once, then read
+     * each state in a single pass and write every
+     * result from start_state to stop_state
      ***********************************************/
 
     if ( stop_state < 0 )
@@ -321,246 +335,121 @@ int main(int argc, char *argv[])
         stop_state = qty_states;
     }
 
-    strcpy(fname_results, fname_out);
-    strcat(fname_results, "-RESULTS.");
-    sprintf(file_num, "%d", start_state);
-    strcat(fname_results, file_num);
-    printf("\nDumping Results to file [%s]", fname_results);
-
-    fp = fopen(fname_results, "w+");
+    plan_classes = (char **)malloc((subrec_vars_len_node + subrec_vars_len_shell + subrec_vars_len_beam +
+                                    subrec_vars_len_brick + 1) *
+                                   sizeof(char *));
+    plan_svars = (char **)malloc((subrec_vars_len_node + subrec_vars_len_shell + subrec_vars_len_beam +
+                                  subrec_vars_len_brick + 1) *
+                                 sizeof(char *));
+    field_qty = 0;
+    if ( !result_class_set )
+    {
+        if ( qty_node > 0 )
+        {
+            add_fields("node", subrec_vars_len_node, subrec_vars_node, plan_classes, plan_svars, &field_qty);
+        }
+        if ( qty_quad > 0 )
+        {
+            add_fields("shell", subrec_vars_len_shell, subrec_vars_shell, plan_classes, plan_svars, &field_qty);
+        }
+        if ( qty_beam > 0 )
+        {
+            add_fields("beam", subrec_vars_len_beam, subrec_vars_beam, plan_classes, plan_svars, &field_qty);
+        }
+        if ( qty_hex > 0 )
+        {
+            add_fields("brick", subrec_vars_len_brick, subrec_vars_brick, plan_classes, plan_svars, &field_qty);
+        }
+    }
+    else if ( result_var_set )
+    {
+        add_fields(result_class, 1, &result_var, plan_classes, plan_svars, &field_qty);
+    }
 
-    for ( i = start_state - 1; i < stop_state; i++ )
+    status = mc_mr_plan_results(dbid, subrec_count, p_subrec, field_qty, plan_classes, plan_svars, &p_plan);
+    if ( status != OK )
     {
-        state = i + 1; /* State numbers are 1 based */
+        mc_print_error("mc_mr_plan_results", status);
+        exit(-1);
+    }
+    free(plan_classes);
+    free(plan_svars);
 
-        /************************************/
-        /* Read in all of the Nodal results */
-        /************************************/
-        if ( qty_node > 0 && !result_class_set )
+    /* Name the components of each vector result */
+    field_labels = (char ***)malloc(field_qty * sizeof(char **));
+    for ( i = 0; i < field_qty; i++ )
+    {
+        field_labels[i] = NULL;
+        p_field = &p_plan->fields[i];
+        if ( p_field->veclen > 1 && mc_get_svar_def(dbid, p_field->svar_name, &p_sv) == OK )
         {
-            for ( k = 0; k < subrec_vars_len_node; k++ )
+            if ( p_sv.vec_size == p_field->veclen )
             {
-                strcpy(class_name, "node");
-                strcpy(svar_name, subrec_vars_node[k]);
-
-                /* Get a list of the variable components if the variable
-                 * has components */
-                status = mc_get_svar_def(dbid, svar_name, &p_sv);
-                field_qty = 0;
-                if ( p_sv.vec_size > 1 )
-                {
-                    field_qty = p_sv.vec_size;
-                    for ( j = 0; j < p_sv.vec_size; j++ )
-                    {
-                        field_names[j] = strdup(p_sv.components[j]);
-                    }
-                }
-
-                status = mc_mr_get_result(dbid, state, subrec_count, p_subrec, class_name, svar_name, &qty,
-                                          &result_veclen, &result_type, &block_qty, &block_list, (void **)&results_flt);
-                if ( status == OK && qty > 0 )
-                {
-                    printf("\n\tDumping Class=%s \tSvar=%s   \tat State %d", class_name, svar_name, state);
-                    dump_result(dbid, fp, state, svar_name, class_name, results_flt, qty, result_veclen, field_names,
-                                block_qty, block_list);
-
-                    free(results_flt);
-
-                    /* Deallocate the space for the svar fields */
-                    if ( field_qty > 0 )
-                    {
-                        for ( j = 0; j < field_qty; j++ )
-                        {
-                            free(field_names[j]);
-                            field_names[j] = NULL;
-                        }
-                    }
-                }
+                field_labels[i] = p_sv.components;
+                p_sv.components = NULL;
+                p_sv.vec_size = 0;
             }
+            mc_cleanse_st_variable(&p_sv);
         }
+    }
 
-        /************************************/
-        /* Read in all of the Shell results */
-        /************************************/
-        if ( qty_quad > 0 && !result_class_set )
-        {
-            for ( k = 0; k < subrec_vars_len_shell; k++ )
-            {
-                strcpy(class_name, "shell");
-                strcpy(svar_name, subrec_vars_shell[k]);
-
-                /* Get a list of the variable components if the variable
-                 * has components */
-                status = mc_get_svar_def(dbid, svar_name, &p_sv);
-                field_qty = 0;
-                if ( p_sv.vec_size > 1 )
-                {
-                    field_qty = p_sv.vec_size;
-                    for ( j = 0; j < p_sv.vec_size; j++ )
-                    {
-                        field_names[j] = strdup(p_sv.components[j]);
-                    }
-                }
+    if ( binary_output )
+    {
+        fcols = (FILE **)malloc(field_qty * sizeof(FILE *));
+        fp = open_columns(p_plan, fcols);
+    }
+    else
+    {
+        strcpy(fname_results, fname_out);
+        strcat(fname_results, "-RESULTS.");
+        sprintf(file_num, "%d", start_state);
+        strcat(fname_results, file_num);
+        printf("\nDumping Results to file [%s]", fname_results);
+
+        fp = fopen(fname_results, "w+");
+        setvbuf(fp, NULL, _IOFBF, 1 << 20);
+    }
 
-                status = mc_mr_get_result(dbid, state, subrec_count, p_subrec, class_name, svar_name, &qty,
-                                          &result_veclen, &result_type, &block_qty, &block_list, (void **)&results_flt);
-                if ( status == OK && qty > 0 )
-                {
-                    printf("\n\tDumping Class=%s \tSvar=%s   \tat State %d", class_name, svar_name, state);
-                    dump_result(dbid, fp, state, svar_name, class_name, results_flt, qty, result_veclen, field_names,
-                                block_qty, block_list);
-
-                    free(results_flt);
-
-                    /* Deallocate the space for the svar fields */
-                    if ( field_qty > 0 )
-                    {
-                        for ( j = 0; j < field_qty; j++ )
-                        {
-                            free(field_names[j]);
-                            field_names[j] = NULL;
-                        }
-                    }
-                }
-            }
-        }
+    for ( i = start_state - 1; i < stop_state; i++ )
+    {
+        state = i + 1; /* State numbers are 1 based */
 
-        /************************************/
-        /* Read in all of the Beam results */
-        /************************************/
-        if ( qty_beam > 0 && !result_class_set )
+        status = mc_mr_read_plan(p_plan, state);
+        if ( status != OK )
         {
-            for ( k = 0; k < subrec_vars_len_beam; k++ )
-            {
-                strcpy(class_name, "beam");
-                strcpy(svar_name, subrec_vars_beam[k]);
-
-                /* Get a list of the variable components if the variable
-                 * has components */
-                status = mc_get_svar_def(dbid, svar_name, &p_sv);
-                field_qty = 0;
-                if ( p_sv.vec_size > 1 )
-                {
-                    field_qty = p_sv.vec_size;
-                    for ( j = 0; j < p_sv.vec_size; j++ )
-                    {
-                        field_names[j] = strdup(p_sv.components[j]);
-                    }
-                }
+            mc_print_error("mc_mr_read_plan", status);
+            break;
+        }
+        mc_query_family(dbid, STATE_TIME, (void *)&state, NULL, (void *)&time);
 
-                status = mc_mr_get_result(dbid, state, subrec_count, p_subrec, class_name, svar_name, &qty,
-                                          &result_veclen, &result_type, &block_qty, &block_list, (void **)&results_flt);
-                if ( status == OK && qty > 0 )
-                {
-                    printf("\n\tDumping Class=%s \tSvar=%s   \tat State %d", class_name, svar_name, state);
-                    dump_result(dbid, fp, state, svar_name, class_name, results_flt, qty, result_veclen, field_names,
-                                block_qty, block_list);
-
-                    free(results_flt);
-
-                    /* Deallocate the space for the svar fields */
-                    if ( field_qty > 0 )
-                    {
-                        for ( j = 0; j < field_qty; j++ )
-                        {
-                            free(field_names[j]);
-                            field_names[j] = NULL;
-                        }
-                    }
-                }
-            }
+        if ( binary_output )
+        {
+            fwrite(&time, sizeof(float), 1, fp);
         }
 
-        /************************************/
-        /* Read in all of the Brick results */
-        /************************************/
-        if ( qty_hex > 0 && !result_class_set )
+        for ( k = 0; k < field_qty; k++ )
         {
-            for ( k = 0; k < subrec_vars_len_brick; k++ )
+            p_field = &p_plan->fields[k];
+            if ( p_field->len == 0 )
             {
-                strcpy(class_name, "brick");
-                strcpy(svar_name, subrec_vars_brick[k]);
-
-                /* Get a list of the variable components if the variable
-                 * has components */
-                status = mc_get_svar_def(dbid, svar_name, &p_sv);
-                field_qty = 0;
-                if ( p_sv.vec_size > 1 )
-                {
-                    field_qty = p_sv.vec_size;
-                    for ( j = 0; j < p_sv.vec_size; j++ )
-                    {
-                        field_names[j] = strdup(p_sv.components[j]);
-                    }
-                }
-
-                status = mc_mr_get_result(dbid, state, subrec_count, p_subrec, class_name, svar_name, &qty,
-                                          &result_veclen, &result_type, &block_qty, &block_list, (void **)&results_flt);
-                if ( status == OK && qty > 0 )
-                {
-                    printf("\n\tDumping Class=%s \tSvar=%s   \tat State %d", class_name, svar_name, state);
-                    dump_result(dbid, fp, state, svar_name, class_name, results_flt, qty, result_veclen, field_names,
-                                block_qty, block_list);
-
-                    free(results_flt);
-
-                    /* Deallocate the space for the svar fields */
-                    if ( field_qty > 0 )
-                    {
-                        for ( j = 0; j < field_qty; j++ )
-                        {
-                            free(field_names[j]);
-                            field_names[j] = NULL;
-                        }
-                    }
-                }
+                continue;
             }
-        }
 
-        /* Read and output a user requested result */
-        if ( result_class_set && result_var_set )
-        {
-            strcpy(class_name, result_class);
-            strcpy(svar_name, result_var);
-
-            /* Get a list of the variable components if the variable has
-             * components */
-            status = mc_get_svar_def(dbid, svar_name, &p_sv);
-            field_qty = 0;
-            if ( p_sv.vec_size > 1 )
+            printf("\n\tDumping Class=%s \tSvar=%s   \tat State %d", p_field->class_name, p_field->svar_name, state);
+            if ( binary_output )
             {
-                field_qty = p_sv.vec_size;
-                for ( j = 0; j < p_sv.vec_size; j++ )
-                {
-                    field_names[j] = strdup(p_sv.components[j]);
-                }
+                write_columns(fcols[k], p_field);
             }
-            status = mc_mr_get_result(dbid, state, subrec_count, p_subrec, class_name, svar_name, &qty, &result_veclen,
-                                      &result_type, &block_qty, &block_list, (void **)&results_flt);
-            if ( status == OK && qty > 0 )
+            else
             {
-                printf("\n\tDumping Class=%s \tSvar=%s   \tat State %d", class_name, svar_name, state);
-                dump_result(dbid, fp, state, svar_name, class_name, results_flt, qty, result_veclen, field_names,
-                            block_qty, block_list);
-
-                free(results_flt);
-
-                /* Deallocate the space for the svar fields */
-                if ( field_qty > 0 )
-                {
-                    for ( j = 0; j < p_sv.vec_size; j++ )
-                    {
-                        free(field_names[j]);
-                        field_names[j] = NULL;
-                    }
-                }
+                dump_result(fp, state, time, p_field, field_labels[k]);
             }
         }
 
         /* Check to see if we need to write a new Result file */
         states_file_output++;
 
-        if ( states_file_output >= max_states_per_file && i < stop_state - 1 )
+        if ( !binary_output && states_file_output >= max_states_per_file && i < stop_state - 1 )
         {
             states_file_output = 0;
             fclose(fp);
@@ -571,11 +460,21 @@ int main(int argc, char *argv[])
             printf("\n\nDumping Results to file [%s]", fname_results);
 
             fp = fopen(fname_results, "w+");
+            setvbuf(fp, NULL, _IOFBF, 1 << 20);
         }
         printf("\n");
     } /* End for on state */
 
-    fclose(fp);
+    if ( binary_output )
+    {
+        close_columns(p_plan, fcols, fp, start_state, states_file_output);
+    }
+    else
+    {
+        fclose(fp);
+    }
+    mc_mr_free_plan(p_plan);
+
     status = mc_close(dbid);
     if ( status != 0 )
     {
@@ -589,77 +488,240 @@ int main(int argc, char *argv[])
 }
 
 /************************************************************
- * TAG( dump_result ) LOCAL
+ * TAG( add_fields ) LOCAL
  *
- * Writes result data to a specified file.
+ * Append (class, state variable) pairs to a result plan
+ * request.
  */
-static void dump_result(int dbid, FILE *fp, int state, char *svar_name, char *class_name, float *result, int qty_result,
-                        int result_veclen, char **field_names, int block_qty, int *block_list)
+static void add_fields(char *class_name, int svar_qty, char **svar_names, char **classes, char **svars,
+                       int *field_qty)
 {
-    int i, j, k;
-    int elem_id = 0;
-    int obj_index, block_index;
-    int result_len = 0;
-    float result_flt = 0.0;
-
-    char field_name[256];
+    int i;
 
-    float time = 0.0;
-    int status = OK;
+    for ( i = 0; i < svar_qty; i++ )
+    {
+        classes[*field_qty] = class_name;
+        svars[*field_qty] = svar_names[i];
+        (*field_qty)++;
+    }
+}
 
-    /* Get the State Time */
+/************************************************************
+ * TAG( result_value ) LOCAL
+ *
+ * Return one atom of a result as a double.
+ */
+static double result_value(Mr_field *p_field, int index)
+{
+    switch ( p_field->type )
+    {
+        case M_INT:
+            return (double)((int *)p_field->result)[index];
+        case M_INT8:
+            return (double)((LONGLONG *)p_field->result)[index];
+        case M_FLOAT8:
+            return ((double *)p_field->result)[index];
+        default:
+            return (double)((float *)p_field->result)[index];
+    }
+}
 
-    status = mc_query_family(dbid, STATE_TIME, (void *)&state, NULL, (void *)&time);
+/************************************************************
+ * TAG( dump_result ) LOCAL
+ *
+ * Writes result data to a specified file.
+ */
+static void dump_result(FILE *fp, int state, float time, Mr_field *p_field, char **labels)
+{
+    int i, k;
+    int elem_id, first, last;
+    int obj_index;
+    double value;
 
     fprintf(fp, "\n\tState=[%d] @ Time=[%14.10f]", state, time);
 
-    fprintf(fp, "\n\tResult_Class=[%s]  Result_Name=[%s]  Vec_Len=[%d]", class_name, svar_name, result_veclen);
+    fprintf(fp, "\n\tResult_Class=[%s]  Result_Name=[%s]  Vec_Len=[%d]", p_field->class_name, p_field->svar_name,
+            p_field->veclen);
 
-    obj_index = 0;
-    block_index = 0;
-
-    for ( i = 0; i < block_qty; i++ )
+    for ( i = 0; i < p_field->block_qty; i++ )
     {
-        fprintf(fp, "\n\n\tBlock Length = [%d] Block ids = [%d:%d] ",
-                (block_list[block_index + 1] - block_list[block_index]) + 1, block_list[block_index],
-                block_list[block_index + 1]);
-
-        result_len = (block_list[block_index + 1] - block_list[block_index] + 1) * result_veclen;
+        first = p_field->block_list[2 * i];
+        last = p_field->block_list[2 * i + 1];
+        fprintf(fp, "\n\n\tBlock Length = [%d] Block ids = [%d:%d] ", last - first + 1, first, last);
 
-        elem_id = block_list[block_index];
-        obj_index = (block_list[block_index] - 1) * result_veclen;
-        block_index += 2;
-
-        for ( j = 0; j < result_len; j += result_veclen )
+        obj_index = (first - 1) * p_field->veclen;
+        for ( elem_id = first; elem_id <= last; elem_id++ )
         {
-            fprintf(fp, "\n\t[%d]\t ", elem_id++);
-            for ( k = 0; k < result_veclen; k++ )
+            fprintf(fp, "\n\t[%d]\t ", elem_id);
+            for ( k = 0; k < p_field->veclen; k++ )
             {
-                result_flt = (float)result[obj_index];
+                value = result_value(p_field, obj_index++);
 
-                if ( result_veclen > 1 )
+                if ( p_field->veclen == 1 )
+                {
+                    fprintf(fp, " \t%25.18e ", value);
+                }
+                else if ( labels != NULL )
                 {
-                    if ( field_names )
-                    {
-                        sprintf(field_name, "%d", k + 1);
-                        if ( field_names[k] )
-                        {
-                            strcpy(field_name, field_names[k]);
-                        }
-                        fprintf(fp, " \tComponent=[%s] %25.18e ", field_name, result_flt);
-                    }
+                    fprintf(fp, " \tComponent=[%s] %25.18e ", labels[k], value);
                 }
                 else
                 {
-                    fprintf(fp, " \t%25.18e ", result_flt);
+                    fprintf(fp, " \tComponent=[%d] %25.18e ", k + 1, value);
                 }
-                obj_index++;
             }
         }
     }
     fprintf(fp, "\n\n");
 }
 
+/************************************************************
+ * TAG( column_name ) LOCAL
+ *
+ * Build the binary column file name for a result.
+ */
+static void column_name(char *fname, Mr_field *p_field)
+{
+    char *p_c;
+
+    sprintf(fname, "%s-%s-%s.bin", fname_out, p_field->class_name, p_field->svar_name);
+    for ( p_c = fname + strlen(fname_out) + 1; *p_c != '\0'; p_c++ )
+    {
+        if ( *p_c == ' ' || *p_c == '/' )
+        {
+            *p_c = '_';
+        }
+    }
+}
+
+/************************************************************
+ * TAG( open_columns ) LOCAL
+ *
+ * Open one binary column file per bound result, returning
+ * the file which receives the state times.
+ */
+static FILE *open_columns(Mr_result_plan *p_plan, FILE **fcols)
+{
+    int i;
+    char fname[3 * M_MAX_NAME_LEN];
+    FILE *fp;
+
+    printf("\nDumping Results to columns [%s-COLUMNS]", fname_out);
+
+    for ( i = 0; i < p_plan->field_qty; i++ )
+    {
+        fcols[i] = NULL;
+        if ( p_plan->fields[i].len > 0 )
+        {
+            column_name(fname, &p_plan->fields[i]);
+            fcols[i] = fopen(fname, "wb");
+            if ( fcols[i] == NULL )
+            {
+                fprintf(stderr, "\nUnable to open column file [%s]\n", fname);
+                exit(-1);
+            }
+        }
+    }
+
+    sprintf(fname, "%s-TIMES.bin", fname_out);
+    fp = fopen(fname, "wb");
+    if ( fp == NULL )
+    {
+        fprintf(stderr, "\nUnable to open column file [%s]\n", fname);
+        exit(-1);
+    }
+
+    return fp;
+}
+
+/************************************************************
+ * TAG( write_columns ) LOCAL
+ *
+ * Append one state's row of a result to its column file.
+ * Only the bound object id ranges are written.
+ */
+static void write_columns(FILE *fp, Mr_field *p_field)
+{
+    int i;
+    int first, last;
+    int obj_size;
+
+    obj_size = p_field->veclen * internal_sizes[p_field->type];
+    for ( i = 0; i < p_field->block_qty; i++ )
+    {
+        first = p_field->block_list[2 * i];
+        last = p_field->block_list[2 * i + 1];
+        fwrite((char *)p_field->result + (LONGLONG)(first - 1) * obj_size, obj_size, last - first + 1, fp);
+    }
+}
+
+/************************************************************
+ * TAG( close_columns ) LOCAL
+ *
+ * Close the column files and write the index describing
+ * them.  Each column file holds one row per state of
+ * objects * veclen values in native byte order.
+ */
+static void close_columns(Mr_result_plan *p_plan, FILE **fcols, FILE *fp, int first_state, int state_qty)
+{
+    int i, j;
+    char fname[3 * M_MAX_NAME_LEN];
+    char *type_name;
+    Mr_field *p_field;
+    FILE *fidx;
+
+    fclose(fp);
+
+    sprintf(fname, "%s-COLUMNS", fname_out);
+    fidx = fopen(fname, "w");
+    if ( fidx == NULL )
+    {
+        fprintf(stderr, "\nUnable to open column index [%s]\n", fname);
+        exit(-1);
+    }
+
+    fprintf(fidx, "# file class svar type veclen objects blocks\n");
+    fprintf(fidx, "states %d first %d\n", state_qty, first_state);
+    fprintf(fidx, "times %s-TIMES.bin float\n", fname_out);
+
+    for ( i = 0; i < p_plan->field_qty; i++ )
+    {
+        if ( fcols[i] == NULL )
+        {
+            continue;
+        }
+        fclose(fcols[i]);
+
+        p_field = &p_plan->fields[i];
+        switch ( p_field->type )
+        {
+            case M_INT:
+                type_name = "int";
+                break;
+            case M_INT8:
+                type_name = "long";
+                break;
+            case M_FLOAT8:
+                type_name = "double";
+                break;
+            default:
+                type_name = "float";
+                break;
+        }
+
+        column_name(fname, p_field);
+        fprintf(fidx, "column %s %s %s %s %d %d", fname, p_field->class_name, p_field->svar_name, type_name,
+                p_field->veclen, p_field->len);
+        for ( j = 0; j < p_field->block_qty; j++ )
+        {
+            fprintf(fidx, " %d:%d", p_field->block_list[2 * j], p_field->block_list[2 * j + 1]);
+        }
+        fprintf(fidx, "\n");
+    }
+
+    fclose(fidx);
+}
+
 /************************************************************
  * TAG( scan_args ) LOCAL
  *
@@ -738,6 +800,11 @@ static void scan_args(int argc, char *argv[], int last_state)
             result_var_set = TRUE;
         }
 
+        if ( strcmp(argv[i], "-binary") == 0 )
+        {
+            binary_output = TRUE;
+        }
+
         if ( strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "-o") == 0 )
         {
             i++;
@@ -766,6 +833,7 @@ static void usage(void)
     printf("                [-d | -o]           \t<dumpfile name>                    \n");
     printf("\n");
     printf("                [-states-file n]    \t<states to output per file>\n");
+    printf("                [-binary]           \t<write binary result columns>\n");
     printf("\n");
     printf("                [-state n]          \t<read a single state n | 'last'>    \n");
     printf("\n");
@@ -1,6 +1,10 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <dirent.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
 
 #include "mili.h"
 #include "mili_config.h"
@@ -152,70 +156,197 @@ int processSingleFile(char *file_name, int close, int *fam_id)
 
     return status;
 }
+/**************************************************************
+ *  TAG(process_file_share)
+ *  Write the .mili files of every "stride"th processor family,
+ *  starting with "first".
+ *  @param char** names  processor family roots
+ *  @return  int
+ */
+static int process_file_share(char **names, int qty, int first, int stride)
+{
+    int i;
+    int status = OK;
+    Famid famid;
+
+    for ( i = first; i < qty; i += stride )
+    {
+        status = processSingleFile(names[i], 1, &famid);
+        if ( status != OK )
+        {
+            fprintf(stderr, "Error processing file %s.\n", names[i]);
+            return status;
+        }
+    }
+
+    return status;
+}
+
+/**************************************************************
+ *  TAG(process_files_parallel)
+ *  Write the processor .mili files with a pool of worker processes,
+ *  each taking an interleaved share of the families.  The library
+ *  keeps its open families and metadata scratch state in globals, so
+ *  workers are processes rather than threads.
+ *  @param int workers  number of worker processes
+ *  @return  int
+ */
+static int process_files_parallel(char **names, int qty, int workers)
+{
+    pid_t *pids;
+    int i, wstatus;
+    int status = OK;
+
+    if ( workers > qty )
+    {
+        workers = qty;
+    }
+    if ( workers <= 1 )
+    {
+        return process_file_share(names, qty, 0, 1);
+    }
+
+    pids = (pid_t *)calloc(workers, sizeof(pid_t));
+    if ( pids == NULL )
+    {
+        return ALLOC_FAILED;
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+    for ( i = 0; i < workers; i++ )
+    {
+        pids[i] = fork();
+        if ( pids[i] == 0 )
+        {
+            _exit(process_file_share(names, qty, i, workers) == OK ? 0 : 1);
+        }
+        else if ( pids[i] < 0 )
+        {
+            /* Out of processes - do the remaining shares here. */
+            fprintf(stderr, "Unable to start worker %d, continuing serially.\n", i);
+            for ( ; i < workers; i++ )
+            {
+                pids[i] = 0;
+                if ( status == OK )
+                {
+                    status = process_file_share(names, qty, i, workers);
+                }
+            }
+            break;
+        }
+    }
+
+    for ( i = 0; i < workers; i++ )
+    {
+        if ( pids[i] <= 0 )
+        {
+            continue;
+        }
+        if ( waitpid(pids[i], &wstatus, 0) < 0 || !WIFEXITED(wstatus) || WEXITSTATUS(wstatus) != 0 )
+        {
+            status = NOT_OK;
+        }
+    }
+    free(pids);
+
+    return status;
+}
+
 /*
  *   TAG(write_multi_processor_files)
  *   Function to write out multiple processor files for the same
- *   simulation run.
+ *   simulation run.  The processor files are written in parallel,
+ *   then the global file is merged from them.
  *   @param int padding the  padding needed to create the name
+ *   @param int workers number of worker processes
  */
 
-int write_multi_processor_files(int padding)
+int write_multi_processor_files(int padding, int workers)
 {
     int a_file_count, i;
     struct dirent **namelist;
-    char temp_name[512];
+    char **names;
     int name_length;
     int status = OK;
-    Famid famid, zero_id;
-    temp_name[0] = '\0';
+    Famid zero_id;
+
     a_file_count = scandir(directory, &namelist, (void *)file_select, alphasort);
-    // Run over each named file discovered by scandir function
-    for ( i = 0; i < a_file_count; i++ )
+    if ( a_file_count <= 0 )
     {
-        name_length = strlen(namelist[i]->d_name) - 1;
-        strncpy(temp_name, namelist[i]->d_name, name_length);
-        temp_name[name_length] = '\0';
-        if(i == 0)
-        {
-            status = processSingleFile(temp_name, 0, &zero_id);
-        }else
+        fprintf(stderr, "No processor files found for %s.\n", plotfile_name);
+        return NOT_OK;
+    }
+
+    // Processor family roots are the A file names less the 'A'.
+    names = (char **)calloc(a_file_count, sizeof(char *));
+    if ( names == NULL )
+    {
+        fprintf(stderr, "Unable to allocate processor file names for %s.\n", plotfile_name);
+        for ( i = 0; i < a_file_count; i++ )
         {
-            status = processSingleFile(temp_name, 1, &famid);
+            free(namelist[i]);
         }
-        
-        if ( status != OK )
-        {
-            fprintf(stderr, "Error processing file %s.\n", temp_name);
-            return status;
-        }        
+        free(namelist);
+        return NOT_OK;
     }
-    // We any file to write the global information
-    // status = mc_open(temp_name,directory,"Ar",&famid);
-    if ( status != OK )
+    for ( i = 0; i < a_file_count; i++ )
     {
-        mc_print_error("mc_open for globalfile write.\n", status);
-        return status;
+        name_length = strlen(namelist[i]->d_name) - 1;
+        namelist[i]->d_name[name_length] = '\0';
+        names[i] = namelist[i]->d_name;
     }
 
-    status = mc_activate_visit_file(zero_id, 1);
+    status = process_files_parallel(names, a_file_count, workers);
     if ( status != OK )
     {
-        mc_print_error("Could not activate visit file writing.\n", status);
-        return status;
+        fprintf(stderr, "Error processing processor files for %s.\n", plotfile_name);
     }
 
-    status = mc_write_global_metadata(zero_id);
-    if ( status != OK )
+    // The global file is merged from the processor files just written.
+    if ( status == OK )
     {
-        mc_print_error("Failed to write globalfile for plotfile.\n", status);
-        return status;
+        status = mc_open(names[0], directory, "Ar", &zero_id);
+        if ( status != OK )
+        {
+            mc_print_error("mc_open for globalfile write.\n", status);
+        }
     }
-    status = mc_close(zero_id);
-    
-    if ( status != OK )
+
+    if ( status == OK )
     {
-        mc_print_error("mc_close to close in global write.\n", status);
+        status = mc_activate_visit_file(zero_id, 1);
+        if ( status != OK )
+        {
+            mc_print_error("Could not activate visit file writing.\n", status);
+        }
+        else
+        {
+            status = mc_write_global_metadata(zero_id);
+            if ( status != OK )
+            {
+                mc_print_error("Failed to write globalfile for plotfile.\n", status);
+            }
+        }
+
+        i = mc_close(zero_id);
+        if ( i != OK )
+        {
+            mc_print_error("mc_close to close in global write.\n", i);
+            if ( status == OK )
+            {
+                status = i;
+            }
+        }
     }
+
+    for ( i = 0; i < a_file_count; i++ )
+    {
+        free(namelist[i]);
+    }
+    free(namelist);
+    free(names);
+
     return status;
 }
 
@@ -224,23 +355,40 @@ int main(int argc, char *argv[])
     int pad;
     int status;
     int famid;
+    int workers;
+    char *base_filename;
 
-    if ( argc != 2 )
+    // Default to one worker per available core.
+    workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if ( argc == 4 && strcmp(argv[1], "-j") == 0 )
+    {
+        workers = atoi(argv[2]);
+        base_filename = argv[3];
+    }
+    else if ( argc == 2 )
+    {
+        base_filename = argv[1];
+    }
+    else
     {
-        fprintf(stderr, "Usage: makemili_driver base_filename\n");
+        fprintf(stderr, "Usage: makemili_driver [-j workers] base_filename\n");
         return 101;
     }
+    if ( workers < 1 )
+    {
+        workers = 1;
+    }
     fprintf(stderr, "\n\n");
     ;
     fprintf(stderr, "\n\t Running Makemili_driver Version: %s(%s)", PACKAGE_VERSION, PACKAGE_DATE);
     fprintf(stderr, "\n\n");
-    pad = find_pad_count(argv[1]);
+    pad = find_pad_count(base_filename);
 
     // The pad will tell us what kind of file this is.
     switch ( pad )
     {
         case -1:
-            fprintf(stderr, "File %s was not located.\n", argv[1]);
+            fprintf(stderr, "File %s was not located.\n", base_filename);
             break;
         case 0:
             // Generate for a single plot file.
@@ -250,7 +398,7 @@ int main(int argc, char *argv[])
         default:
             // Must have multiple processors
             fprintf(stderr, "Multiple processors.  Base Name: %s\n", plotfile_name);
-            status = write_multi_processor_files(pad);
+            status = write_multi_processor_files(pad, workers);
             break;
     }
     if ( status == OK )
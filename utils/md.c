@@ -3,7 +3,8 @@
 /*
  * md - Mili dump utility.  Md unpacks and writes as text the
  *      descriptive information and data found in the non-state
- *      data file(s).
+ *      data file(s), and optionally the data of a range of states,
+ *      which it can also export as CSV or NumPy (.npy) arrays.
  *
  ************************************************************************
  * Modifications:
@@ -15,27 +16,65 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/time.h>
+#include <sys/wait.h>
 #include <fcntl.h>
 #include "mili_internal.h"
 #include "eprtf.h"
 
 #define DIR_ENTRY_COLUMN_SPACING 8
 
+/*****************************************************************
+ * TAG( Md_options ) LOCAL
+ *
+ * Selections beyond the Dump_control output modes.
+ */
+typedef struct _md_options
+{
+    Bool_type types[QTY_DIR_ENTRY_TYPES]; /* Directory entry types to dump */
+    Bool_type states;                     /* Dump state data */
+    int first_state;                      /* State range, 1-based; 0 for */
+    int last_state;                       /* first or last state */
+    int workers;                          /* Processes for states/export */
+    char *export_format;                  /* "csv" or "npy", NULL for none */
+    char *export_prefix;                  /* Export file name prefix */
+} Md_options;
+
+typedef Return_value (*Md_work)(Mili_family *fam, Md_options *p_opts, Dump_control *p_dc, int worker, int workers);
+
 static void clean_up_and_go(Return_value rval, Mili_family *fam);
 static void usage();
-static Return_value dump_family(Mili_family *fam, Dump_control *p_dc);
+static Bool_type parse_types(char *list, Md_options *p_opts);
+static Bool_type parse_state_range(char *range, Md_options *p_opts);
+static Return_value dump_family(Mili_family *fam, Dump_control *p_dc, Md_options *p_opts);
 static Return_value dump_header(Mili_family *p_fam, Dump_control *p_dc);
 static Return_value dump_directory(File_dir *p_fd);
+static Return_value run_parallel(Mili_family *fam, Md_options *p_opts, Dump_control *p_dc, Md_work work);
+static Return_value dump_states(Mili_family *fam, Md_options *p_opts, Dump_control *p_dc, int worker, int workers);
+static Return_value dump_state(Mili_family *fam, int state, Dump_control *p_dc);
+static void dump_atoms(int type, void *data, LONGLONG first, int qty, int indent);
+static Return_value export_states(Mili_family *fam, Md_options *p_opts, Dump_control *p_dc, int worker, int workers);
+static Return_value export_svar(Mili_family *fam, Md_options *p_opts, int srec_id, int subrec_id, Svar *p_svar,
+                                char *fname);
 
 static Return_value (*dump_funcs[QTY_DIR_ENTRY_TYPES])() = {
     dump_nodes, dump_elem_conns,   dump_class_idents, dump_state_var_dict, dump_state_rec_data, dump_param, dump_param,
     NULL,       dump_surface_conns};
 
+/*****************************************************************
+ * TAG( entry_type_names ) LOCAL
+ *
+ * Names for selecting directory entry types with -t, indexed by
+ * Dir_entry_type.
+ */
+static char *entry_type_names[QTY_DIR_ENTRY_TYPES] = {"nodes",  "conns",   "idents",   "svars",    "srecs",
+                                                      "params", "aparams", "classdefs", "surfaces", "ti"};
+
 /*****************************************************************
  * TAG( fam_list )
  *
@@ -88,7 +127,7 @@ int main(int argc, char *argv[])
 {
     Mili_family *fam;
     int fam_id;
-    int root_len, path_len;
+    int root_len;
     Return_value rval;
     char root_name[M_MAX_NAME_LEN];
     char path[128];
@@ -96,8 +135,8 @@ int main(int argc, char *argv[])
     Dump_control dctrl;
     int i;
     Bool_type no_name_parsed, more;
-    Bool_type create_db;
     char *p_c;
+    Md_options opts;
 
     memset(path, (int)'\0', 128);
     memset(root_name, (int)'\0', M_MAX_NAME_LEN);
@@ -110,6 +149,13 @@ int main(int argc, char *argv[])
     dctrl.include_external = FALSE;
     dctrl.include_header = FALSE;
 
+    memset(&opts, 0, sizeof(Md_options));
+    for ( i = 0; i < QTY_DIR_ENTRY_TYPES; i++ )
+    {
+        opts.types[i] = TRUE;
+    }
+    opts.workers = 1;
+
     no_name_parsed = TRUE;
 
     if ( argc < 2 )
@@ -152,6 +198,47 @@ int main(int argc, char *argv[])
                         dctrl.include_external = TRUE;
                         dctrl.include_header = TRUE;
                         break;
+                    case 't':
+                    case 'S':
+                    case 'j':
+                    case 'x':
+                    case 'o':
+                        /* Flags taking the next argument end the group. */
+                        if ( i + 1 >= argc )
+                        {
+                            usage();
+                        }
+                        i++;
+                        if ( *p_c == 't' && !parse_types(argv[i], &opts) )
+                        {
+                            usage();
+                        }
+                        else if ( *p_c == 'S' && !parse_state_range(argv[i], &opts) )
+                        {
+                            usage();
+                        }
+                        else if ( *p_c == 'j' )
+                        {
+                            opts.workers = atoi(argv[i]);
+                            if ( opts.workers < 1 )
+                            {
+                                usage();
+                            }
+                        }
+                        else if ( *p_c == 'x' )
+                        {
+                            opts.export_format = argv[i];
+                            if ( strcmp(argv[i], "csv") != 0 && strcmp(argv[i], "npy") != 0 )
+                            {
+                                usage();
+                            }
+                        }
+                        else if ( *p_c == 'o' )
+                        {
+                            opts.export_prefix = argv[i];
+                        }
+                        more = FALSE;
+                        break;
                     case '\0':
                         more = FALSE;
                         break;
@@ -228,66 +315,47 @@ int main(int argc, char *argv[])
         usage();
     }
 
-    path_len = (int)strlen(path);
-
-    fam = NEW(Mili_family, "Mili family");
-
-    /* Build the family root string. */
-    fam->root_len = path_len + root_len + 1;
-    fam->root = (char *)calloc(fam->root_len + 1, sizeof(char));
-    sprintf(fam->root, "%s/%s", path, root_name);
-
-    /* Save the separate components. */
-    str_dup(&fam->path, path);
-    str_dup(&fam->file_root, root_name);
-
-    /* Parse the control string and initialize the header. */
-    rval = parse_control_string("Ar", fam, &create_db);
+    /*
+     * Open through mc_open() so the family is fully initialized; the
+     * state data dumps read through the library.
+     */
+    rval = mc_open(root_name, path, "Ar", &fam_id);
     if ( rval != OK )
     {
-        clean_up_and_go(rval, fam);
+        mc_print_error(NULL, rval);
+        exit(0);
     }
+    fam = fam_list[fam_id];
 
-    /* Initialize file indices. */
-    fam->cur_index = -1;
-    fam->cur_st_index = -1;
-
-    /* State data file pointer. */
-    fam->cur_st_file = NULL;
-
-    /* Set appropriate I/O routines for family. */
-    rval = set_default_io_routines(fam);
-    if ( rval != OK )
+    /* Go do it. */
+    if ( opts.export_format == NULL )
     {
-        clean_up_and_go(rval, fam);
+        rval = dump_family(fam, &dctrl, &opts);
+        if ( rval != OK )
+        {
+            clean_up_and_go(rval, fam);
+        }
     }
 
-    /* Check family for current write activity by any process. */
-    test_write_lock(fam);
-
-    /* Need this stuff for open_family(). */
-    fam_list = RENEW_N(Mili_family *, fam_list, fam_qty, 1, "Big Kahuna pointers");
-    fam_list[fam_qty] = fam;
-    fam_id = fam_qty;
-    fam_qty++;
-    fam->my_id = fam_id;
-
-    rval = open_family(fam_id);
-    if ( rval != OK )
+    if ( opts.states || opts.export_format != NULL )
     {
-        clean_up_and_go(rval, fam);
-        free(fam_list[fam_qty]);
-        fam_qty--;
-    }
+        if ( opts.first_state == 0 )
+        {
+            opts.first_state = 1;
+        }
+        if ( opts.last_state == 0 || opts.last_state > fam->state_qty )
+        {
+            opts.last_state = fam->state_qty;
+        }
 
-    /* Go do it. */
-    rval = dump_family(fam, &dctrl);
-    if ( rval != OK )
-    {
-        clean_up_and_go(rval, fam);
+        rval = run_parallel(fam, &opts, &dctrl, (opts.export_format != NULL) ? export_states : dump_states);
+        if ( rval != OK )
+        {
+            clean_up_and_go(rval, fam);
+        }
     }
 
-    cleanse(fam);
+    mc_close(fam_id);
 
     return 0;
 }
@@ -299,6 +367,8 @@ int main(int argc, char *argv[])
  */
 static void usage()
 {
+    int i;
+
     printf("Usage: md [<path>/]<root name> [-<flag>...]\n");
     printf("Flags: h     # Output section header lines only      #\n");
     printf("       s     # Short output                          #\n");
@@ -307,6 +377,19 @@ static void usage()
     printf("       d     # Include directory dump                #\n");
     printf("       e     # Include external (host and date) info #\n");
     printf("       a     # Output all (equiv. to -lfde)          #\n");
+    printf("       t <types>  # Dump only these entry types,     #\n");
+    printf("                  # comma separated, or \"none\"      #\n");
+    printf("       S <range>  # Dump states <first>[:[<last>]]   #\n");
+    printf("       x csv|npy  # Export states (all, or -S range) #\n");
+    printf("                  # per subrecord state variable     #\n");
+    printf("       o <prefix> # Export file name prefix          #\n");
+    printf("       j <n>      # Worker processes for -S and -x   #\n");
+    printf("Types:");
+    for ( i = 0; i < QTY_DIR_ENTRY_TYPES; i++ )
+    {
+        printf(" %s", entry_type_names[i]);
+    }
+    printf("\n");
     exit(1);
 }
 
@@ -318,16 +401,96 @@ static void usage()
 static void clean_up_and_go(Return_value rval, Mili_family *fam)
 {
     mc_print_error(NULL, rval);
-    cleanse(fam);
+    mc_close(fam->my_id);
     exit(0);
 }
 
+/*****************************************************************
+ * TAG( parse_types ) LOCAL
+ *
+ * Parse a comma-separated list of directory entry type names.
+ */
+static Bool_type parse_types(char *list, Md_options *p_opts)
+{
+    char *p_name;
+    int i;
+
+    for ( i = 0; i < QTY_DIR_ENTRY_TYPES; i++ )
+    {
+        p_opts->types[i] = FALSE;
+    }
+
+    for ( p_name = strtok(list, ","); p_name != NULL; p_name = strtok(NULL, ",") )
+    {
+        if ( strcmp(p_name, "none") == 0 )
+        {
+            continue;
+        }
+
+        for ( i = 0; i < QTY_DIR_ENTRY_TYPES; i++ )
+        {
+            if ( strcmp(p_name, entry_type_names[i]) == 0 )
+            {
+                p_opts->types[i] = TRUE;
+                break;
+            }
+        }
+        if ( i == QTY_DIR_ENTRY_TYPES )
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*****************************************************************
+ * TAG( parse_state_range ) LOCAL
+ *
+ * Parse a state range, "<first>", "<first>:" or "<first>:<last>".
+ */
+static Bool_type parse_state_range(char *range, Md_options *p_opts)
+{
+    char *p_end;
+
+    p_opts->states = TRUE;
+    p_opts->first_state = (int)strtol(range, &p_end, 10);
+    if ( p_end == range || p_opts->first_state < 1 )
+    {
+        return FALSE;
+    }
+
+    if ( *p_end == '\0' )
+    {
+        p_opts->last_state = p_opts->first_state;
+    }
+    else if ( *p_end == ':' && p_end[1] == '\0' )
+    {
+        p_opts->last_state = 0;
+    }
+    else if ( *p_end == ':' )
+    {
+        range = p_end + 1;
+        p_opts->last_state = (int)strtol(range, &p_end, 10);
+        if ( p_end == range || *p_end != '\0' || p_opts->last_state < p_opts->first_state )
+        {
+            return FALSE;
+        }
+    }
+    else
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
 /*****************************************************************
  * TAG( dump_family ) LOCAL
  *
  * Mili dump main driver.
  */
-static Return_value dump_family(Mili_family *fam, Dump_control *p_dc)
+static Return_value dump_family(Mili_family *fam, Dump_control *p_dc, Md_options *p_opts)
 {
     FILE *p_f;
     char fname[M_MAX_NAME_LEN];
@@ -336,10 +499,13 @@ static Return_value dump_family(Mili_family *fam, Dump_control *p_dc)
     int i, j, nam_idx, num_written;
     Dir_entry_type etype;
 
-    rval = load_directories(fam);
-    if ( rval != OK )
+    if ( fam->directory == NULL )
     {
-        return rval;
+        rval = load_directories(fam);
+        if ( rval != OK )
+        {
+            return rval;
+        }
     }
 
     /*
@@ -379,7 +545,7 @@ static Return_value dump_family(Mili_family *fam, Dump_control *p_dc)
         {
             etype = (Dir_entry_type)p_fd->dir_entries[i][TYPE_IDX];
 
-            if ( dump_funcs[etype] != NULL )
+            if ( dump_funcs[etype] != NULL && p_opts->types[etype] )
             {
                 rval = dump_funcs[etype](fam, p_f, p_fd->dir_entries[i], p_fd->names + nam_idx, p_dc, indents[LEVEL1],
                                          indents[LEVEL2]);
@@ -635,3 +801,492 @@ static Return_value dump_directory(File_dir *p_fd)
     }
     return OK;
 }
+
+/*****************************************************************
+ * TAG( run_parallel ) LOCAL
+ *
+ * Run "work" in the requested number of worker processes and copy
+ * their output to standard output in worker order.  Workers are
+ * forked after the family's files are closed so that none share a
+ * file offset.
+ */
+static Return_value run_parallel(Mili_family *fam, Md_options *p_opts, Dump_control *p_dc, Md_work work)
+{
+    FILE **outs;
+    pid_t *pids;
+    char buf[65536];
+    LONGLONG qty;
+    int workers, w, wstatus;
+    Return_value rval;
+
+    workers = p_opts->workers;
+    if ( workers > p_opts->last_state - p_opts->first_state + 1 && p_opts->export_format == NULL )
+    {
+        workers = p_opts->last_state - p_opts->first_state + 1;
+    }
+    if ( workers <= 1 )
+    {
+        return work(fam, p_opts, p_dc, 0, 1);
+    }
+
+    state_file_close(fam);
+    state_file_pool_close(fam);
+    non_state_file_close(fam);
+
+    outs = NEW_N(FILE *, workers, "Worker outputs");
+    pids = NEW_N(pid_t, workers, "Worker pids");
+    if ( outs == NULL || pids == NULL )
+    {
+        free(outs);
+        free(pids);
+        return ALLOC_FAILED;
+    }
+
+    fflush(stdout);
+    rval = OK;
+    for ( w = 0; w < workers && rval == OK; w++ )
+    {
+        outs[w] = tmpfile();
+        if ( outs[w] == NULL )
+        {
+            rval = OPEN_FAILED;
+            break;
+        }
+
+        pids[w] = fork();
+        if ( pids[w] == 0 )
+        {
+            dup2(fileno(outs[w]), STDOUT_FILENO);
+            rval = work(fam, p_opts, p_dc, w, workers);
+            fflush(stdout);
+            if ( rval != OK )
+            {
+                mc_print_error("md worker", rval);
+            }
+            _exit(rval == OK ? 0 : 1);
+        }
+        else if ( pids[w] < 0 )
+        {
+            fclose(outs[w]);
+            outs[w] = NULL;
+            rval = NOT_OK;
+        }
+    }
+
+    /* Collect the workers' output in order. */
+    workers = w;
+    for ( w = 0; w < workers; w++ )
+    {
+        if ( outs[w] == NULL )
+        {
+            continue;
+        }
+        if ( waitpid(pids[w], &wstatus, 0) < 0 || !WIFEXITED(wstatus) || WEXITSTATUS(wstatus) != 0 )
+        {
+            rval = NOT_OK;
+        }
+
+        rewind(outs[w]);
+        while ( (qty = fread(buf, 1, sizeof(buf), outs[w])) > 0 )
+        {
+            fwrite(buf, 1, qty, stdout);
+        }
+        fclose(outs[w]);
+    }
+    fflush(stdout);
+
+    free(outs);
+    free(pids);
+
+    return rval;
+}
+
+/*****************************************************************
+ * TAG( dump_states ) LOCAL
+ *
+ * Dump this worker's contiguous share of the state range.
+ */
+static Return_value dump_states(Mili_family *fam, Md_options *p_opts, Dump_control *p_dc, int worker, int workers)
+{
+    int qty, first, last;
+    int st;
+    Return_value rval;
+
+    qty = p_opts->last_state - p_opts->first_state + 1;
+    first = p_opts->first_state + (int)((LONGLONG)qty * worker / workers);
+    last = p_opts->first_state + (int)((LONGLONG)qty * (worker + 1) / workers) - 1;
+
+    if ( worker == 0 )
+    {
+        printf("%*sSTATES  first: %d    last: %d\n", indents[LEVEL0], "", p_opts->first_state, p_opts->last_state);
+    }
+
+    rval = OK;
+    for ( st = first; st <= last && rval == OK; st++ )
+    {
+        rval = dump_state(fam, st, p_dc);
+    }
+
+    return rval;
+}
+
+/*****************************************************************
+ * TAG( dump_state ) LOCAL
+ *
+ * Dump the subrecord data of a state, one state variable at a time.
+ * Short output gives only the first and last objects' values.  This
+ * writes with stdio directly, as there may be a great deal of it.
+ */
+static Return_value dump_state(Mili_family *fam, int state, Dump_control *p_dc)
+{
+    State_descriptor *p_sd;
+    Srec *p_sr;
+    Sub_srec *p_subrec;
+    Svar *p_svar;
+    void *buf;
+    LONGLONG buf_size, size;
+    int i, j, k, atoms, type;
+    Return_value rval;
+
+    p_sd = fam->state_map + (state - 1);
+    printf("%*sSTATE: %-8d time: %+.6e;  srec: %d\n", indents[LEVEL1], "", state, p_sd->time, p_sd->srec_format);
+    if ( p_dc->brevity == DV_HEADERS )
+    {
+        return OK;
+    }
+
+    if ( p_sd->srec_format < 0 || p_sd->srec_format >= fam->qty_srecs )
+    {
+        return INVALID_SREC_INDEX;
+    }
+    p_sr = fam->srecs[p_sd->srec_format];
+
+    buf = NULL;
+    buf_size = 0;
+    rval = OK;
+    for ( i = 0; i < p_sr->qty_subrecs && rval == OK; i++ )
+    {
+        p_subrec = p_sr->subrecs[i];
+        printf("%*sSUBRECORD: \"%s\"  Class: %s;  Objects: %d\n", indents[LEVEL2], "", p_subrec->name,
+               p_subrec->mclass, p_subrec->mo_qty);
+
+        for ( j = 0; j < p_subrec->qty_svars && rval == OK; j++ )
+        {
+            p_svar = p_subrec->svars[j];
+            atoms = svar_atoms(p_svar);
+            type = *p_svar->data_type;
+
+            size = (LONGLONG)atoms * p_subrec->mo_qty * internal_sizes[type];
+            if ( size > buf_size )
+            {
+                free(buf);
+                buf = malloc(size);
+                if ( buf == NULL )
+                {
+                    return ALLOC_FAILED;
+                }
+                buf_size = size;
+            }
+
+            rval = mc_read_results(fam->my_id, state, i, 1, &p_svar->name, buf);
+            if ( rval != OK )
+            {
+                break;
+            }
+
+            printf("%*s%s:\n", indents[LEVEL3], "", p_svar->name);
+            for ( k = 0; k < p_subrec->mo_qty; k++ )
+            {
+                /* Short output skips all but the first and last objects. */
+                if ( p_dc->brevity == DV_SHORT && k > 0 && k < p_subrec->mo_qty - 1 )
+                {
+                    k = p_subrec->mo_qty - 2;
+                    continue;
+                }
+                dump_atoms(type, buf, (LONGLONG)k * atoms, atoms, indents[LEVEL4]);
+            }
+        }
+    }
+
+    free(buf);
+
+    return rval;
+}
+
+/*****************************************************************
+ * TAG( dump_atoms ) LOCAL
+ *
+ * Dump "qty" atoms of a state variable's data on one line.
+ */
+static void dump_atoms(int type, void *data, LONGLONG first, int qty, int indent)
+{
+    int i;
+
+    printf("%*s", indent, "");
+    for ( i = 0; i < qty; i++ )
+    {
+        switch ( type )
+        {
+            case M_FLOAT:
+            case M_FLOAT4:
+                printf("  %+.6e", ((float *)data)[first + i]);
+                break;
+            case M_FLOAT8:
+                printf("  %+.9e", ((double *)data)[first + i]);
+                break;
+            case M_INT:
+            case M_INT4:
+                printf("  %d", ((int *)data)[first + i]);
+                break;
+            case M_INT8:
+                printf("  %lld", (long long)((LONGLONG *)data)[first + i]);
+                break;
+        }
+    }
+    printf("\n");
+}
+
+/*****************************************************************
+ * TAG( export_states ) LOCAL
+ *
+ * Export the state range, one file per subrecord state variable
+ * plus one of the state times.  Worker "worker" takes every
+ * "workers"th state variable.
+ */
+static Return_value export_states(Mili_family *fam, Md_options *p_opts, Dump_control *p_dc, int worker, int workers)
+{
+    char fname[M_MAX_NAME_LEN];
+    char prefix[M_MAX_NAME_LEN];
+    Sub_srec *p_subrec;
+    int item, len;
+    int i, j, k;
+    Return_value rval;
+
+    if ( p_opts->export_prefix != NULL )
+    {
+        len = snprintf(prefix, sizeof(prefix), "%s", p_opts->export_prefix);
+    }
+    else
+    {
+        len = snprintf(prefix, sizeof(prefix), "%s_", fam->file_root);
+    }
+    if ( len < 0 || len >= (int)sizeof(prefix) )
+    {
+        return INVALID_NAME;
+    }
+
+    len = snprintf(fname, sizeof(fname), "%stimes.%s", prefix, p_opts->export_format);
+    if ( len < 0 || len >= (int)sizeof(fname) )
+    {
+        return INVALID_NAME;
+    }
+    rval = OK;
+    if ( worker == 0 )
+    {
+        rval = export_svar(fam, p_opts, -1, -1, NULL, fname);
+    }
+
+    item = 0;
+    for ( i = 0; i < fam->qty_srecs && rval == OK; i++ )
+    {
+        for ( j = 0; j < fam->srecs[i]->qty_subrecs && rval == OK; j++ )
+        {
+            p_subrec = fam->srecs[i]->subrecs[j];
+            for ( k = 0; k < p_subrec->qty_svars && rval == OK; k++, item++ )
+            {
+                if ( item % workers != worker )
+                {
+                    continue;
+                }
+
+                if ( fam->qty_srecs > 1 )
+                {
+                    len = snprintf(fname, sizeof(fname), "%s%d_%s_%s.%s", prefix, i, p_subrec->name,
+                                   p_subrec->svars[k]->name, p_opts->export_format);
+                }
+                else
+                {
+                    len = snprintf(fname, sizeof(fname), "%s%s_%s.%s", prefix, p_subrec->name,
+                                   p_subrec->svars[k]->name, p_opts->export_format);
+                }
+                if ( len < 0 || len >= (int)sizeof(fname) )
+                {
+                    return INVALID_NAME;
+                }
+                rval = export_svar(fam, p_opts, i, j, p_subrec->svars[k], fname);
+            }
+        }
+    }
+
+    return rval;
+}
+
+/*****************************************************************
+ * TAG( export_svar ) LOCAL
+ *
+ * Write one subrecord state variable over the state range as a
+ * states-by-values array, or the state times if "p_svar" is NULL.
+ * CSV rows lead with the state number and time; .npy files hold the
+ * values alone, in host byte order.
+ */
+static Return_value export_svar(Mili_family *fam, Md_options *p_opts, int srec_id, int subrec_id, Svar *p_svar,
+                                char *fname)
+{
+    FILE *p_f;
+    Sub_srec *p_subrec;
+    State_descriptor *p_sd;
+    void *buf;
+    char header[256];
+    char descr[8];
+    Bool_type npy;
+    LONGLONG rows, cols, c;
+    int atoms, type, len, pad;
+    int st;
+    int one = 1;
+    Return_value rval;
+
+    npy = (strcmp(p_opts->export_format, "npy") == 0);
+
+    if ( p_svar != NULL )
+    {
+        p_subrec = fam->srecs[srec_id]->subrecs[subrec_id];
+        atoms = svar_atoms(p_svar);
+        type = *p_svar->data_type;
+        cols = (LONGLONG)atoms * p_subrec->mo_qty;
+    }
+    else
+    {
+        atoms = 1;
+        type = M_FLOAT;
+        cols = 1;
+    }
+
+    rows = 0;
+    for ( st = p_opts->first_state; st <= p_opts->last_state; st++ )
+    {
+        if ( p_svar == NULL || fam->state_map[st - 1].srec_format == srec_id )
+        {
+            rows++;
+        }
+    }
+    if ( rows == 0 )
+    {
+        return OK;
+    }
+
+    buf = malloc(cols * internal_sizes[type]);
+    if ( buf == NULL )
+    {
+        return ALLOC_FAILED;
+    }
+
+    p_f = fopen(fname, npy ? "wb" : "w");
+    if ( p_f == NULL )
+    {
+        free(buf);
+        return OPEN_FAILED;
+    }
+
+    if ( npy )
+    {
+        /* NPY 1.0 header, padded so the data starts 64-byte aligned. */
+        snprintf(descr, sizeof(descr), "%c%c%d", (*(unsigned char *)&one == 1) ? '<' : '>',
+                 (type == M_INT || type == M_INT4 || type == M_INT8) ? 'i' : 'f', internal_sizes[type]);
+        if ( p_svar == NULL )
+        {
+            len = sprintf(header, "{'descr': '%s', 'fortran_order': False, 'shape': (%llu,), }", descr,
+                          (unsigned long long)rows);
+        }
+        else
+        {
+            len = sprintf(header, "{'descr': '%s', 'fortran_order': False, 'shape': (%llu, %llu), }", descr,
+                          (unsigned long long)rows, (unsigned long long)cols);
+        }
+        pad = (64 - (10 + len + 1) % 64) % 64;
+        memset(header + len, ' ', pad);
+        len += pad;
+        header[len++] = '\n';
+        fwrite("\x93NUMPY\x01\x00", 1, 8, p_f);
+        fputc(len & 0xff, p_f);
+        fputc(len >> 8, p_f);
+        fwrite(header, 1, len, p_f);
+    }
+    else
+    {
+        fprintf(p_f, "state,time");
+        for ( c = 0; p_svar != NULL && c < cols; c++ )
+        {
+            if ( atoms == 1 )
+            {
+                fprintf(p_f, ",%llu", (unsigned long long)(c + 1));
+            }
+            else
+            {
+                fprintf(p_f, ",%llu.%llu", (unsigned long long)(c / atoms + 1), (unsigned long long)(c % atoms + 1));
+            }
+        }
+        fprintf(p_f, "\n");
+    }
+
+    rval = OK;
+    for ( st = p_opts->first_state; st <= p_opts->last_state && rval == OK; st++ )
+    {
+        p_sd = fam->state_map + (st - 1);
+        if ( p_svar == NULL )
+        {
+            *(float *)buf = p_sd->time;
+        }
+        else if ( p_sd->srec_format != srec_id )
+        {
+            continue;
+        }
+        else
+        {
+            rval = mc_read_results(fam->my_id, st, subrec_id, 1, &p_svar->name, buf);
+            if ( rval != OK )
+            {
+                break;
+            }
+        }
+
+        if ( npy )
+        {
+            if ( fwrite(buf, internal_sizes[type], cols, p_f) != cols )
+            {
+                rval = SHORT_WRITE;
+            }
+            continue;
+        }
+
+        fprintf(p_f, "%d,%.7g", st, p_sd->time);
+        for ( c = 0; p_svar != NULL && c < cols; c++ )
+        {
+            switch ( type )
+            {
+                case M_FLOAT:
+                case M_FLOAT4:
+                    fprintf(p_f, ",%.7g", ((float *)buf)[c]);
+                    break;
+                case M_FLOAT8:
+                    fprintf(p_f, ",%.16g", ((double *)buf)[c]);
+                    break;
+                case M_INT:
+                case M_INT4:
+                    fprintf(p_f, ",%d", ((int *)buf)[c]);
+                    break;
+                case M_INT8:
+                    fprintf(p_f, ",%lld", (long long)((LONGLONG *)buf)[c]);
+                    break;
+            }
+        }
+        fprintf(p_f, "\n");
+    }
+
+    if ( fclose(p_f) != 0 && rval == OK )
+    {
+        rval = SHORT_WRITE;
+    }
+    free(buf);
+
+    return rval;
+}
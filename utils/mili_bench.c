@@ -0,0 +1,794 @@
+/*
+ Copyright (c) 2016, Lawrence Livermore National Security, LLC.
+ Produced at the Lawrence Livermore National Laboratory. Written
+ by Kevin Durrenberger: durrenberger1@llnl.gov. CODE-OCEC-16-056.
+ All rights reserved.
+
+ This file is part of Mili. For details, see <URL describing code
+ and how to download source>.
+
+ Please also read this link-- Our Notice and GNU Lesser General
+ Public License.
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License (as published by
+ the Free Software Foundation) version 2.1 dated February 1999.
+
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the IMPLIED WARRANTY OF
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the terms
+ and conditions of the GNU General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with this program; if not, write to the Free Software Foundation,
+ Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+ * mili_bench - benchmark of Mili library hot paths.
+ *
+ * Writes one synthetic family per processor (a block of hex elements
+ * and their nodes, with scalar node and element state variables),
+ * then times reading the first of them back and, optionally,
+ * combining them with xmilics.  Results are written as JSON.
+ */
+
+#if !defined(_POSIX_C_SOURCE) && defined(__linux__)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "mili.h"
+#include "parson.h"
+
+#define BENCH_NAME_LEN (32)
+#define BENCH_PATH_LEN (1024)
+
+typedef struct _bench_config
+{
+    int nodes;    /* Nodes per processor */
+    int elems;    /* Hex elements per processor */
+    int svars;    /* Scalar state variables per class */
+    int states;
+    int procs;
+    int reps;     /* Repetitions of the read-side timings */
+    char endian;  /* 'b', 'l' or 'n' */
+    char precision; /* 's' or 'd' */
+    Bool_type keep; /* Keep the families when done */
+    char path[BENCH_PATH_LEN];
+    char root[BENCH_PATH_LEN];
+    char xmilics[BENCH_PATH_LEN];
+    char json_file[BENCH_PATH_LEN];
+} Bench_config;
+
+typedef struct _bench_timer
+{
+    int count;
+    double total;
+    double min;
+    double max;
+    double bytes; /* Bytes moved per timed call, 0 if not meaningful */
+} Bench_timer;
+
+/* Timed operations, in output order. */
+enum
+{
+    T_WRITE_FAMILY,
+    T_STATE_WRITE,
+    T_OPEN,
+    T_STATE_MAP_LOAD,
+    T_RO_READ,
+    T_OO_READ,
+    T_TH_READ,
+    T_LABEL_LOAD,
+    T_COMBINE,
+    T_QTY
+};
+
+static char *timer_names[T_QTY] = {"family_write", "full_state_write", "open", "state_map_load", "ro_svar_read",
+                                   "oo_svar_read", "time_history_read", "ti_label_load", "xmilics_combine"};
+
+static void usage(void);
+static int scan_args(int argc, char *argv[], Bench_config *cfg);
+static void copy_path(char *dest, char *src);
+static double now(void);
+static void timer_add(Bench_timer *t, double start);
+static Return_value write_family(Bench_config *cfg, int proc, Bench_timer *timers);
+static Return_value read_family(Bench_config *cfg, Bench_timer *timers);
+static int combine_families(Bench_config *cfg, Bench_timer *timers);
+static void remove_families(Bench_config *cfg);
+static int write_json(Bench_config *cfg, Bench_timer *timers);
+
+/************************************************************
+ * TAG( usage )
+ *
+ * Write out command-line syntax.
+ */
+static void usage(void)
+{
+    printf("\n");
+    printf("Usage: \n");
+    printf("  mili_bench [options]\n\n");
+    printf("OPTIONS:\n\n");
+    printf("  [-nodes <n>]     nodes per processor (default 20000)\n");
+    printf("  [-elems <n>]     hex elements per processor (default 15000)\n");
+    printf("  [-svars <n>]     scalar state variables per class (default 4)\n");
+    printf("  [-states <n>]    states (default 20)\n");
+    printf("  [-procs <n>]     processor families (default 2)\n");
+    printf("  [-reps <n>]      repetitions of read-side timings (default 3)\n");
+    printf("  [-E <b|l|n>]     endianness (default n)\n");
+    printf("  [-P <s|d>]       state variable precision (default s)\n");
+    printf("  [-path <dir>]    directory for the families (default .)\n");
+    printf("  [-root <name>]   family root name (default mili_bench.plt)\n");
+    printf("  [-xmilics <exe>] also time combining the families with xmilics\n");
+    printf("  [-o <file>]      write JSON results to file (default stdout)\n");
+    printf("  [-keep]          keep the families when done\n");
+    printf("\n");
+}
+
+/************************************************************
+ * TAG( scan_args )
+ *
+ * Parse the command line into a configuration.
+ */
+static int scan_args(int argc, char *argv[], Bench_config *cfg)
+{
+    int i;
+    char *arg;
+
+    cfg->nodes = 20000;
+    cfg->elems = 15000;
+    cfg->svars = 4;
+    cfg->states = 20;
+    cfg->procs = 2;
+    cfg->reps = 3;
+    cfg->endian = 'n';
+    cfg->precision = 's';
+    cfg->keep = FALSE;
+    strcpy(cfg->path, ".");
+    strcpy(cfg->root, "mili_bench.plt");
+    cfg->xmilics[0] = '\0';
+    cfg->json_file[0] = '\0';
+
+    for ( i = 1; i < argc; i++ )
+    {
+        arg = argv[i];
+        if ( strcmp(arg, "-keep") == 0 )
+        {
+            cfg->keep = TRUE;
+            continue;
+        }
+        if ( strcmp(arg, "-h") == 0 || strcmp(arg, "-help") == 0 || i + 1 >= argc )
+        {
+            return 1;
+        }
+
+        i++;
+        if ( strcmp(arg, "-nodes") == 0 )
+        {
+            cfg->nodes = atoi(argv[i]);
+        }
+        else if ( strcmp(arg, "-elems") == 0 )
+        {
+            cfg->elems = atoi(argv[i]);
+        }
+        else if ( strcmp(arg, "-svars") == 0 )
+        {
+            cfg->svars = atoi(argv[i]);
+        }
+        else if ( strcmp(arg, "-states") == 0 )
+        {
+            cfg->states = atoi(argv[i]);
+        }
+        else if ( strcmp(arg, "-procs") == 0 )
+        {
+            cfg->procs = atoi(argv[i]);
+        }
+        else if ( strcmp(arg, "-reps") == 0 )
+        {
+            cfg->reps = atoi(argv[i]);
+        }
+        else if ( strcmp(arg, "-E") == 0 )
+        {
+            cfg->endian = argv[i][0];
+        }
+        else if ( strcmp(arg, "-P") == 0 )
+        {
+            cfg->precision = argv[i][0];
+        }
+        else if ( strcmp(arg, "-path") == 0 )
+        {
+            copy_path(cfg->path, argv[i]);
+        }
+        else if ( strcmp(arg, "-root") == 0 )
+        {
+            copy_path(cfg->root, argv[i]);
+        }
+        else if ( strcmp(arg, "-xmilics") == 0 )
+        {
+            copy_path(cfg->xmilics, argv[i]);
+        }
+        else if ( strcmp(arg, "-o") == 0 )
+        {
+            copy_path(cfg->json_file, argv[i]);
+        }
+        else
+        {
+            return 1;
+        }
+    }
+
+    if ( cfg->nodes < 8 || cfg->elems < 1 || cfg->svars < 1 || cfg->states < 1 || cfg->procs < 1 || cfg->reps < 1
+         || strchr("bln", cfg->endian) == NULL || strchr("sd", cfg->precision) == NULL )
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+/************************************************************
+ * TAG( copy_path )
+ *
+ * Copy a path argument into a config field, truncating it to fit.
+ */
+static void copy_path(char *dest, char *src)
+{
+    strncpy(dest, src, BENCH_PATH_LEN - 1);
+    dest[BENCH_PATH_LEN - 1] = '\0';
+}
+
+/************************************************************
+ * TAG( now )
+ *
+ * Monotonic wall clock time in seconds.
+ */
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1.0e-9;
+}
+
+/************************************************************
+ * TAG( timer_add )
+ *
+ * Record one timed call started at "start".
+ */
+static void timer_add(Bench_timer *t, double start)
+{
+    double elapsed;
+
+    elapsed = now() - start;
+    if ( t->count == 0 || elapsed < t->min )
+    {
+        t->min = elapsed;
+    }
+    if ( elapsed > t->max )
+    {
+        t->max = elapsed;
+    }
+    t->total += elapsed;
+    t->count++;
+}
+
+/************************************************************
+ * TAG( proc_root )
+ *
+ * Root name of a processor's family, as xmilics expects it.  Fails
+ * if the name doesn't fit in name_len characters.
+ */
+static Return_value proc_root(Bench_config *cfg, int proc, char *name, size_t name_len)
+{
+    int len;
+
+    len = snprintf(name, name_len, "%s%03d", cfg->root, proc);
+
+    return (len < 0 || (size_t)len >= name_len) ? INVALID_NAME : OK;
+}
+
+/************************************************************
+ * TAG( write_family )
+ *
+ * Write one processor's family, timing the whole and each state.
+ */
+static Return_value write_family(Bench_config *cfg, int proc, Bench_timer *timers)
+{
+    char name[BENCH_PATH_LEN];
+    char ctl[8];
+    char *node_names, *elem_names;
+    int *types, *labels, *conns;
+    float *coords;
+    void *node_data, *elem_data;
+    int mo_ids[2];
+    int atom_size, svar_type;
+    int fid, mesh_id, srec_id;
+    int suffix, st_index;
+    int i, j;
+    char *th_subrec = "BrickSub";
+    Bool_type opened;
+    double start, st_start;
+    Return_value rval, close_rval;
+
+    start = now();
+    opened = FALSE;
+
+    svar_type = (cfg->precision == 'd') ? M_FLOAT8 : M_FLOAT;
+    atom_size = (cfg->precision == 'd') ? sizeof(double) : sizeof(float);
+
+    node_names = (char *)calloc(2 * cfg->svars, BENCH_NAME_LEN);
+    elem_names = node_names + cfg->svars * BENCH_NAME_LEN;
+    types = (int *)malloc(2 * cfg->svars * sizeof(int));
+    labels = (int *)malloc((cfg->nodes > cfg->elems ? cfg->nodes : cfg->elems) * sizeof(int));
+    conns = (int *)malloc(cfg->elems * 10 * sizeof(int));
+    coords = (float *)malloc(cfg->nodes * 3 * sizeof(float));
+    node_data = calloc((size_t)cfg->nodes * cfg->svars, atom_size);
+    elem_data = calloc((size_t)cfg->elems * cfg->svars, atom_size);
+    rval = OK;
+    if ( node_names == NULL || types == NULL || labels == NULL || conns == NULL || coords == NULL
+         || node_data == NULL || elem_data == NULL )
+    {
+        rval = ALLOC_FAILED;
+    }
+
+    if ( rval == OK )
+    {
+        rval = proc_root(cfg, proc, name, sizeof(name));
+    }
+    if ( rval == OK )
+    {
+        sprintf(ctl, "AwE%c", cfg->endian);
+        rval = mc_open(name, cfg->path, ctl, &fid);
+        opened = (rval == OK);
+    }
+    if ( rval == OK )
+    {
+        mc_set_state_map_file_on(fid, TRUE);
+        mc_wrt_string(fid, "title", "mili_bench synthetic family");
+        mc_wrt_scalar(fid, M_INT, "nproc", &cfg->procs);
+
+        /* State variables - nvar<i> on nodes, evar<i> on bricks. */
+        for ( i = 0; i < cfg->svars; i++ )
+        {
+            sprintf(node_names + i * BENCH_NAME_LEN, "nvar%d", i + 1);
+            sprintf(elem_names + i * BENCH_NAME_LEN, "evar%d", i + 1);
+            types[i] = svar_type;
+            types[cfg->svars + i] = svar_type;
+        }
+        rval = mc_def_svars(fid, 2 * cfg->svars, node_names, BENCH_NAME_LEN, node_names, BENCH_NAME_LEN, types);
+    }
+    if ( rval == OK )
+    {
+        rval = mc_make_umesh(fid, "bench", 3, &mesh_id);
+    }
+
+    /* Mesh - a material, nodes and bricks with processor-unique labels. */
+    if ( rval == OK )
+    {
+        rval = mc_def_class(fid, mesh_id, M_MAT, "mat", "Material");
+    }
+    if ( rval == OK )
+    {
+        rval = mc_def_class_idents(fid, mesh_id, "mat", 1, 1);
+    }
+    if ( rval == OK )
+    {
+        rval = mc_def_class(fid, mesh_id, M_NODE, "node", "Nodal");
+    }
+    if ( rval == OK )
+    {
+        for ( i = 0; i < cfg->nodes; i++ )
+        {
+            coords[3 * i] = (float)i;
+            coords[3 * i + 1] = (float)proc;
+            coords[3 * i + 2] = 0.0;
+            labels[i] = proc * cfg->nodes + i + 1;
+        }
+        rval = mc_def_nodes(fid, mesh_id, "node", 1, cfg->nodes, coords);
+    }
+    if ( rval == OK )
+    {
+        rval = mc_def_node_labels(fid, mesh_id, "node", cfg->nodes, labels);
+    }
+    if ( rval == OK )
+    {
+        rval = mc_def_class(fid, mesh_id, M_HEX, "brick", "Brick");
+    }
+    if ( rval == OK )
+    {
+        for ( i = 0; i < cfg->elems; i++ )
+        {
+            for ( j = 0; j < 8; j++ )
+            {
+                conns[10 * i + j] = (i + j) % cfg->nodes + 1;
+            }
+            conns[10 * i + 8] = 1;
+            conns[10 * i + 9] = 1;
+            labels[i] = proc * cfg->elems + i + 1;
+        }
+        rval = mc_def_conn_seq_labels(fid, mesh_id, "brick", 1, cfg->elems, labels, conns);
+    }
+
+    /* State record - result-ordered nodes, object-ordered bricks. */
+    if ( rval == OK )
+    {
+        rval = mc_open_srec(fid, mesh_id, &srec_id);
+    }
+    if ( rval == OK )
+    {
+        mo_ids[0] = 1;
+        mo_ids[1] = cfg->nodes;
+        rval = mc_def_subrec(fid, srec_id, "NodeSub", RESULT_ORDERED, cfg->svars, node_names, BENCH_NAME_LEN, "node",
+                             M_BLOCK_OBJ_FMT, 1, mo_ids, NULL);
+    }
+    if ( rval == OK )
+    {
+        mo_ids[1] = cfg->elems;
+        rval = mc_def_subrec(fid, srec_id, th_subrec, OBJECT_ORDERED, cfg->svars, elem_names, BENCH_NAME_LEN, "brick",
+                             M_BLOCK_OBJ_FMT, 1, mo_ids, NULL);
+    }
+    if ( rval == OK )
+    {
+        rval = mc_close_srec(fid, srec_id);
+    }
+    if ( rval == OK )
+    {
+        rval = mc_flush(fid, NON_STATE_DATA);
+    }
+    if ( rval == OK && proc == 0 )
+    {
+        rval = mc_open_th(fid, 0, 1, &th_subrec);
+    }
+
+    /* States. */
+    for ( i = 0; i < cfg->states && rval == OK; i++ )
+    {
+        st_start = now();
+        rval = mc_new_state(fid, srec_id, (float)i, &suffix, &st_index);
+        if ( rval == OK )
+        {
+            rval = mc_wrt_subrec(fid, "NodeSub", 1, cfg->svars, node_data);
+        }
+        if ( rval == OK )
+        {
+            rval = mc_wrt_subrec(fid, th_subrec, 1, cfg->elems, elem_data);
+        }
+        if ( rval == OK )
+        {
+            rval = mc_end_state(fid, srec_id);
+        }
+        timer_add(timers + T_STATE_WRITE, st_start);
+    }
+    timers[T_STATE_WRITE].bytes = (double)(cfg->nodes + cfg->elems) * cfg->svars * atom_size;
+
+    /* Single cleanup path for every outcome. */
+    if ( opened )
+    {
+        close_rval = mc_close(fid);
+        if ( rval == OK )
+        {
+            rval = close_rval;
+        }
+    }
+    timer_add(timers + T_WRITE_FAMILY, start);
+
+    free(node_names);
+    free(types);
+    free(labels);
+    free(conns);
+    free(coords);
+    free(node_data);
+    free(elem_data);
+
+    return rval;
+}
+
+/************************************************************
+ * TAG( read_family )
+ *
+ * Time reading the first processor's family.
+ */
+static Return_value read_family(Bench_config *cfg, Bench_timer *timers)
+{
+    char name[BENCH_PATH_LEN];
+    char *node_svar = "nvar1";
+    char *elem_svar = "evar1";
+    void *buf;
+    int *labels, *elem_ids, *block_range;
+    int num_blocks;
+    int atom_size;
+    int fid;
+    int rep, st;
+    double start;
+    Return_value rval;
+
+    atom_size = (cfg->precision == 'd') ? sizeof(double) : sizeof(float);
+    buf = malloc((size_t)(cfg->nodes > cfg->elems ? cfg->nodes : cfg->elems) * atom_size
+                 + (size_t)cfg->states * cfg->svars * atom_size);
+    labels = (int *)malloc(2 * (cfg->nodes > cfg->elems ? cfg->nodes : cfg->elems) * sizeof(int));
+    if ( buf == NULL || labels == NULL )
+    {
+        free(buf);
+        free(labels);
+        return ALLOC_FAILED;
+    }
+    elem_ids = labels + (cfg->nodes > cfg->elems ? cfg->nodes : cfg->elems);
+
+    /* Open. */
+    rval = proc_root(cfg, 0, name, sizeof(name));
+    for ( rep = 0; rep < cfg->reps && rval == OK; rep++ )
+    {
+        start = now();
+        rval = mc_open(name, cfg->path, "r", &fid);
+        timer_add(timers + T_OPEN, start);
+        if ( rval == OK && rep < cfg->reps - 1 )
+        {
+            mc_close(fid);
+        }
+    }
+    if ( rval != OK )
+    {
+        free(buf);
+        free(labels);
+        return rval;
+    }
+
+    /* State map load. */
+    for ( rep = 0; rep < cfg->reps && rval == OK; rep++ )
+    {
+        start = now();
+        rval = mc_reload_states(fid);
+        timer_add(timers + T_STATE_MAP_LOAD, start);
+    }
+
+    /* Single state variable of every object, every state. */
+    for ( rep = 0; rep < cfg->reps && rval == OK; rep++ )
+    {
+        for ( st = 1; st <= cfg->states && rval == OK; st++ )
+        {
+            start = now();
+            rval = mc_read_results(fid, st, 0, 1, &node_svar, buf);
+            timer_add(timers + T_RO_READ, start);
+        }
+        for ( st = 1; st <= cfg->states && rval == OK; st++ )
+        {
+            start = now();
+            rval = mc_read_results(fid, st, 1, 1, &elem_svar, buf);
+            timer_add(timers + T_OO_READ, start);
+        }
+    }
+    timers[T_RO_READ].bytes = (double)cfg->nodes * atom_size;
+    timers[T_OO_READ].bytes = (double)cfg->elems * atom_size;
+
+    /* History of one object over every state. */
+    for ( rep = 0; rep < cfg->reps && rval == OK; rep++ )
+    {
+        start = now();
+        rval = mc_read_th(fid, "BrickSub", cfg->elems / 2 + 1, 1, cfg->states, buf);
+        timer_add(timers + T_TH_READ, start);
+    }
+    timers[T_TH_READ].bytes = (double)cfg->states * cfg->svars * atom_size;
+
+    /* Node and element labels. */
+    for ( rep = 0; rep < cfg->reps && rval == OK; rep++ )
+    {
+        start = now();
+        block_range = NULL;
+        rval = mc_load_node_labels(fid, 0, "node", &num_blocks, &block_range, labels);
+        if ( block_range != NULL )
+        {
+            free(block_range);
+        }
+        block_range = NULL;
+        if ( rval == OK )
+        {
+            rval = mc_load_conn_labels(fid, 0, "brick", cfg->elems, &num_blocks, &block_range, elem_ids, labels);
+        }
+        if ( block_range != NULL )
+        {
+            free(block_range);
+        }
+        timer_add(timers + T_LABEL_LOAD, start);
+    }
+    timers[T_LABEL_LOAD].bytes = (double)(cfg->nodes + 2 * cfg->elems) * sizeof(int);
+
+    mc_close(fid);
+    free(buf);
+    free(labels);
+
+    return rval;
+}
+
+/************************************************************
+ * TAG( combine_families )
+ *
+ * Time combining the processor families with xmilics.
+ */
+static int combine_families(Bench_config *cfg, Bench_timer *timers)
+{
+    char cmd[5 * BENCH_PATH_LEN];
+    double start;
+    int status;
+
+    sprintf(cmd, "cd \"%s\" && \"%s\" -i \"%s\" -o \"%s_c\" > /dev/null 2>&1", cfg->path, cfg->xmilics, cfg->root,
+            cfg->root);
+
+    start = now();
+    status = system(cmd);
+    timer_add(timers + T_COMBINE, start);
+
+    return status;
+}
+
+/************************************************************
+ * TAG( remove_families )
+ *
+ * Delete the families written by the benchmark.
+ */
+static void remove_families(Bench_config *cfg)
+{
+    char name[BENCH_PATH_LEN + 8];
+    int proc;
+
+    for ( proc = 0; proc < cfg->procs; proc++ )
+    {
+        if ( proc_root(cfg, proc, name, sizeof(name)) == OK )
+        {
+            mc_delete_family(name, cfg->path);
+        }
+    }
+    if ( cfg->xmilics[0] != '\0' )
+    {
+        snprintf(name, sizeof(name), "%s_c", cfg->root);
+        mc_delete_family(name, cfg->path);
+    }
+}
+
+/************************************************************
+ * TAG( write_json )
+ *
+ * Write configuration and timings as JSON.
+ */
+static int write_json(Bench_config *cfg, Bench_timer *timers)
+{
+    JSON_Value *p_root, *p_value;
+    JSON_Object *p_obj, *p_sub, *p_res;
+    char *p_str;
+    FILE *fp;
+    int i;
+
+    p_root = json_value_init_object();
+    p_obj = json_value_get_object(p_root);
+
+    json_object_set_string(p_obj, "mili_version", MILI_VERSION);
+
+    p_value = json_value_init_object();
+    p_sub = json_value_get_object(p_value);
+    json_object_set_number(p_sub, "nodes", cfg->nodes);
+    json_object_set_number(p_sub, "elems", cfg->elems);
+    json_object_set_number(p_sub, "svars", cfg->svars);
+    json_object_set_number(p_sub, "states", cfg->states);
+    json_object_set_number(p_sub, "procs", cfg->procs);
+    json_object_set_number(p_sub, "reps", cfg->reps);
+    p_str = "native";
+    if ( cfg->endian == 'b' )
+    {
+        p_str = "big";
+    }
+    else if ( cfg->endian == 'l' )
+    {
+        p_str = "little";
+    }
+    json_object_set_string(p_sub, "endian", p_str);
+    json_object_set_string(p_sub, "precision", cfg->precision == 'd' ? "double" : "single");
+    json_object_set_value(p_obj, "config", p_value);
+
+    /* Seconds per call; bandwidth in bytes per second where it applies. */
+    p_value = json_value_init_object();
+    p_res = json_value_get_object(p_value);
+    for ( i = 0; i < T_QTY; i++ )
+    {
+        if ( timers[i].count == 0 )
+        {
+            continue;
+        }
+        p_sub = json_value_get_object(json_value_init_object());
+        json_object_set_number(p_sub, "count", timers[i].count);
+        json_object_set_number(p_sub, "total", timers[i].total);
+        json_object_set_number(p_sub, "mean", timers[i].total / timers[i].count);
+        json_object_set_number(p_sub, "min", timers[i].min);
+        json_object_set_number(p_sub, "max", timers[i].max);
+        if ( timers[i].bytes > 0.0 && timers[i].total > 0.0 )
+        {
+            json_object_set_number(p_sub, "bytes", timers[i].bytes);
+            json_object_set_number(p_sub, "bytes_per_sec", timers[i].bytes * timers[i].count / timers[i].total);
+        }
+        json_object_set_value(p_res, timer_names[i], json_object_get_wrapping_value(p_sub));
+    }
+    json_object_set_value(p_obj, "results", p_value);
+
+    p_str = json_serialize_to_string_pretty(p_root);
+    json_value_free(p_root);
+    if ( p_str == NULL )
+    {
+        return 1;
+    }
+
+    if ( cfg->json_file[0] != '\0' )
+    {
+        fp = fopen(cfg->json_file, "w");
+        if ( fp == NULL )
+        {
+            fprintf(stderr, "mili_bench: unable to open %s\n", cfg->json_file);
+            json_free_serialized_string(p_str);
+            return 1;
+        }
+    }
+    else
+    {
+        fp = stdout;
+    }
+    fprintf(fp, "%s\n", p_str);
+    if ( fp != stdout )
+    {
+        fclose(fp);
+    }
+    json_free_serialized_string(p_str);
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    Bench_config cfg;
+    Bench_timer timers[T_QTY];
+    Return_value rval;
+    int proc;
+
+    if ( scan_args(argc, argv, &cfg) != 0 )
+    {
+        usage();
+        return 1;
+    }
+    memset(timers, 0, sizeof(timers));
+
+    mkdir(cfg.path, 0777);
+    remove_families(&cfg);
+
+    rval = OK;
+    for ( proc = 0; proc < cfg.procs && rval == OK; proc++ )
+    {
+        rval = write_family(&cfg, proc, timers);
+    }
+    if ( rval != OK )
+    {
+        mc_print_error("mili_bench: write", rval);
+        return 1;
+    }
+
+    rval = read_family(&cfg, timers);
+    if ( rval != OK )
+    {
+        mc_print_error("mili_bench: read", rval);
+        return 1;
+    }
+
+    if ( cfg.xmilics[0] != '\0' && combine_families(&cfg, timers) != 0 )
+    {
+        fprintf(stderr, "mili_bench: xmilics combine failed\n");
+        return 1;
+    }
+
+    if ( !cfg.keep )
+    {
+        remove_families(&cfg);
+    }
+
+    return write_json(&cfg, timers);
+}
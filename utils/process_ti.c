@@ -109,14 +109,7 @@ int load_ti_labels(Mili_analysis **in_db, int nproc, TILabels *labels)
 
         /* Collect all the TI variables on this processor */
         mesh_id = fam->qty_meshes - 1;
-        if ( fam->char_header[DIR_VERSION_IDX] > 1 )
-        {
-            table = fam->param_table;
-        }
-        else
-        {
-            table = fam->ti_param_table;
-        }
+        table = ti_param_htable(fam);
         wildcard_count = htable_search_wildcard(table, 0, FALSE, "*", "NULL", "NULL", 0);
 
         wildcard_list = (char **)malloc(wildcard_count * sizeof(char *));
@@ -228,14 +221,7 @@ int load_ti_labels(Mili_analysis **in_db, int nproc, TILabels *labels)
         fam_id = in_db[proc]->db_ident;
         fam = fam_list[fam_id];
 
-        if ( fam->char_header[DIR_VERSION_IDX] > 1 )
-        {
-            table = fam->param_table;
-        }
-        else
-        {
-            table = fam->ti_param_table;
-        }
+        table = ti_param_htable(fam);
 
         /* Collect the remainder of all TI variables on this processor */
         wildcard_count = htable_search_wildcard(table, 0, FALSE, "*", "NULL", "NULL", 0);
@@ -46,6 +46,7 @@ int main(int argc, char *argv[])
         exit(100);
     }
     fam = fam_list[dbid];
+    load_ti_params(fam);
     wildcard_count = htable_search_wildcard(fam->ti_param_table, wildcard_count, FALSE, "*", "NULL", "NULL", 0);
     wildcard_list = (char **)malloc(wildcard_count * sizeof(char *));
     wildcard_count = 0;